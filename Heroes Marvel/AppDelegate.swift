@@ -17,6 +17,11 @@ class AppDelegate: UIResponder, UIApplicationDelegate, UISplitViewControllerDele
     var window: UIWindow?
 
     let store = CoreDataStack.store
+
+    //Cuando la app aloja un bundle de pruebas no se sincroniza: las pruebas necesitan el dispositivo para ellas
+    class var alojandoPruebas: Bool {
+        return ProcessInfo.processInfo.environment["XCTestConfigurationFilePath"] != nil
+    }
     
     func application(_ application: UIApplication, didFinishLaunchingWithOptions launchOptions: [UIApplication.LaunchOptionsKey: Any]?) -> Bool {
         // Override point for customization after application launch.
@@ -27,9 +32,31 @@ class AppDelegate: UIResponder, UIApplicationDelegate, UISplitViewControllerDele
 
         let masterNavigationController = splitViewController.viewControllers[0] as! UINavigationController
         let controller = masterNavigationController.topViewController as! MasterViewController
-        controller.managedObjectContext = store.managedObjectContext
-        Fabric.sharedSDK().debug = true
-        Fabric.with([Crashlytics.self])
+
+        //La lista se pinta con el indice de nombres (o vacia) mientras se abre el almacen
+        let arranque = OrquestadorArranque.shared
+        arranque.registrar("almacen", fase: .critica) {
+            self.store.abrirAlmacen { context in
+                arranque.hito("almacenAbierto")
+                controller.almacenAbierto(context)
+            }
+        }
+        arranque.registrar("crashlytics", fase: .trasPrimerFotograma) {
+            #if DEBUG
+            Fabric.sharedSDK().debug = true
+            #endif
+            Fabric.with([Crashlytics.self])
+        }
+        arranque.registrar("telemetria", fase: .trasPrimerFotograma) {
+            Telemetria.shared.iniciar()
+        }
+        arranque.registrar("gobernadorMemoria", fase: .ociosa) {
+            GobernadorMemoria.shared.iniciar()
+        }
+        arranque.registrar("monitorFotogramas", fase: .ociosa) {
+            MonitorFotogramas.shared.iniciar()
+        }
+        arranque.arrancar()
         
         return true
     }
@@ -42,6 +69,10 @@ class AppDelegate: UIResponder, UIApplicationDelegate, UISplitViewControllerDele
     func applicationDidEnterBackground(_ application: UIApplication) {
         // Use this method to release shared resources, save user data, invalidate timers, and store enough application state information to restore your application to its current state in case it is terminated later.
         // If your application supports background execution, this method is called instead of applicationWillTerminate: when the user quits.
+        Traza.shared.exportarADocumentos(prefijo: "sesion")
+        RegistroLatencias.shared.exportarADocumentos(prefijo: "latencias")
+        MonitorFotogramas.shared.cerrarSesion()
+        Telemetria.shared.enviar()
     }
 
     func applicationWillEnterForeground(_ application: UIApplication) {
@@ -52,10 +83,20 @@ class AppDelegate: UIResponder, UIApplicationDelegate, UISplitViewControllerDele
         // Restart any tasks that were paused (or not yet started) while the application was inactive. If the application was previously in the background, optionally refresh the user interface.
     }
 
+    func applicationDidReceiveMemoryWarning(_ application: UIApplication) {
+        //AppDelegate no es un RBAppDelegate: reenviamos el aviso al gobernador a mano
+        GobernadorMemoria.shared.applicationDidReceiveMemoryWarning()
+    }
+
     func applicationWillTerminate(_ application: UIApplication) {
         // Called when the application is about to terminate. Save data if appropriate. See also applicationDidEnterBackground:.
         // Saves changes in the application's managed object context before the application terminates.
-        store.saveContext()
+        //Si el almacen no ha llegado a abrirse no hay nada que guardar
+        if store.abierto {
+            store.managedObjectContext.performAndWait {
+                store.saveContext()
+            }
+        }
     }
 
     // MARK: - Split view
@@ -13,6 +13,25 @@ class CoreDataStack{
     
     static let store = CoreDataStack()
     private init() {}
+
+    private let colaApertura = DispatchQueue(label: "CoreDataStack.apertura", qos: .userInitiated)
+    //Se pone a true en el hilo principal justo antes de entregar el contexto
+    private(set) var abierto = false
+
+    //Carga el modelo y abre el almacen fuera del hilo principal; entrega el contexto en el hilo
+    //principal. Nadie debe tocar managedObjectContext antes de que llegue este completion
+    func abrirAlmacen(completion: @escaping (NSManagedObjectContext) -> Void) {
+        colaApertura.async {
+            let context = Traza.shared.intervalo("almacen.apertura", categoria: "arranque") {
+                self.managedObjectContext
+            }
+            self.registrarNivelMemoria(context)
+            DispatchQueue.main.async {
+                self.abierto = true
+                completion(context)
+            }
+        }
+    }
     
     
     
@@ -36,6 +55,8 @@ class CoreDataStack{
         // Create the coordinator and store
         let coordinator = NSPersistentStoreCoordinator(managedObjectModel: self.managedObjectModel)
         let url = self.applicationDocumentsDirectory.appendingPathComponent("Heroes_Marvel.sqlite")
+        //En el primer arranque partimos del catalogo incluido en el bundle
+        CatalogoSemilla.instalarSiNecesario(en: url)
         var failureReason = "There was an error creating or loading the application's saved data."
         do {
             let options = [ NSMigratePersistentStoresAutomaticallyOption : true, NSInferMappingModelAutomaticallyOption : true ]
@@ -66,6 +87,27 @@ class CoreDataStack{
         return managedObjectContext
     }()
 
+    static let bytesEstimadosPorObjeto = 1024
+
+    //Ultimo nivel del gobernador de memoria: devuelve a fault los objetos sin cambios.
+    //El coste es una estimacion, Core Data no dice cuanto ocupa cada objeto.
+    //El gobernador llama desde el hilo principal, asi que las dos closures entran en la cola del
+    //contexto igual que la ingesta de MarvelRed, que ya no la retiene mientras descarga imagenes.
+    //Se registra al entregar el almacen, no en el lazy del contexto
+    private func registrarNivelMemoria(_ context: NSManagedObjectContext) {
+        GobernadorMemoria.shared.registrar("filas", nivel: .filasCoreData, coste: {
+            var registrados = 0
+            context.performAndWait {
+                registrados = context.registeredObjects.count
+            }
+            return registrados * CoreDataStack.bytesEstimadosPorObjeto
+        }, liberar: {
+            context.performAndWait {
+                context.refreshAllObjects()
+            }
+        })
+    }
+
     // MARK: - Core Data Saving support
     
     func saveContext () {
@@ -0,0 +1,11 @@
+//
+//  Heroes Marvel-Bridging-Header.h
+//  Heroes Marvel
+//
+//  Created by Borja Gil Herrero on 19/10/2026.
+//  Copyright © 2026 Alsis GHE. All rights reserved.
+//
+//  Cabeceras de C que usa el codigo Swift de la app
+//
+
+#import "Rendimiento/ContadoresAtomicos.h"
@@ -21,5 +21,7 @@ extension Heroe {
     @NSManaged public var imagen: NSData?
     @NSManaged public var nombre: String?
     @NSManaged public var miniatura: NSData?
+    @NSManaged public var idMarvel: Int32
+    @NSManaged public var modificado: NSDate?
 
 }
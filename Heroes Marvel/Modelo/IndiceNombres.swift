@@ -0,0 +1,207 @@
+//
+//  IndiceNombres.swift
+//  Heroes Marvel
+//
+//  Created by Borja Gil Herrero on 19/10/2026.
+//  Copyright © 2026 Alsis GHE. All rights reserved.
+//
+
+import Foundation
+import CoreData
+
+//Indice de solo lectura con lo minimo que necesita la lista: nombres en orden, secciones por
+//inicial y el idMarvel de cada fila. Se guarda en disco tras cada sincronizacion y se lee
+//proyectado en memoria (mmap), asi la lista no pasa por el NSFetchedResultsController ni hace
+//fault de cada Heroe y la memoria no crece con el tamaño del catalogo.
+//
+//Formato (enteros de 32 bits little endian):
+//  cabecera   magia, version, numeroFilas, numeroSecciones, bytesCadenas
+//  secciones  numeroSecciones x (primeraFila, numeroFilas, offsetTitulo, longitudTitulo)
+//  filas      numeroFilas x (offsetNombre, longitudNombre, idMarvel, reservado)
+//  cadenas    UTF-8 sin terminador, los offsets son relativos al inicio de esta tabla
+final class IndiceNombres {
+
+    static let magia: UInt32 = 0x58494D48 // "HMIX"
+    static let version: UInt32 = 3
+    static let bytesCabecera = 5 * 4
+    static let bytesEntrada = 4 * 4
+
+    class var url: URL {
+        let caches = FileManager.default.urls(for: .cachesDirectory, in: .userDomainMask)[0]
+        return caches.appendingPathComponent("IndiceNombres.bin")
+    }
+
+    let numeroFilas: Int
+    let numeroSecciones: Int
+
+    private let base: UnsafeMutableRawPointer
+    private let longitud: Int
+    private let secciones: UnsafeRawPointer
+    private let filas: UnsafeRawPointer
+    private let cadenas: UnsafeRawPointer
+    private let bytesCadenas: Int
+
+    //Proyecta el indice en memoria. Devuelve nil si no existe o no es valido. Solo se leen la
+    //cabecera y las secciones, unas pocas paginas sea cual sea el catalogo: el tamaño del fichero
+    //tiene que cuadrar con la cabecera y los limites de cada fila se comprueban al leerla
+    init?(url: URL = IndiceNombres.url) {
+        let descriptor = open(url.path, O_RDONLY)
+        guard descriptor >= 0 else {
+            return nil
+        }
+        defer { close(descriptor) }
+
+        var informacion = stat()
+        guard fstat(descriptor, &informacion) == 0, Int(informacion.st_size) >= IndiceNombres.bytesCabecera else {
+            return nil
+        }
+        longitud = Int(informacion.st_size)
+        guard let proyeccion = mmap(nil, longitud, PROT_READ, MAP_PRIVATE, descriptor, 0), proyeccion != MAP_FAILED else {
+            return nil
+        }
+        base = proyeccion
+
+        let cabecera = UnsafeRawPointer(base)
+        numeroFilas = Int(cabecera.load(fromByteOffset: 8, as: UInt32.self))
+        numeroSecciones = Int(cabecera.load(fromByteOffset: 12, as: UInt32.self))
+        secciones = cabecera + IndiceNombres.bytesCabecera
+        filas = secciones + numeroSecciones * IndiceNombres.bytesEntrada
+        cadenas = filas + numeroFilas * IndiceNombres.bytesEntrada
+        bytesCadenas = Int(cabecera.load(fromByteOffset: 16, as: UInt32.self))
+
+        let valido = cabecera.load(as: UInt32.self) == IndiceNombres.magia
+            && cabecera.load(fromByteOffset: 4, as: UInt32.self) == IndiceNombres.version
+            && cabecera.distance(to: cadenas) + bytesCadenas == longitud
+            && validarSecciones()
+        if !valido {
+            munmap(base, longitud)
+            return nil
+        }
+    }
+
+    deinit {
+        munmap(base, longitud)
+    }
+
+    //Las secciones van seguidas, cubren todas las filas y sus titulos caben en la tabla de cadenas
+    private func validarSecciones() -> Bool {
+        var siguienteFila = 0
+        for seccion in 0..<numeroSecciones {
+            guard Int(campo(secciones, seccion, 0)) == siguienteFila, cabe(campo(secciones, seccion, 2), campo(secciones, seccion, 3)) else {
+                return false
+            }
+            siguienteFila += Int(campo(secciones, seccion, 1))
+        }
+        return siguienteFila == numeroFilas
+    }
+
+    private func cabe(_ offset: UInt32, _ longitud: UInt32) -> Bool {
+        return Int(offset) + Int(longitud) <= bytesCadenas
+    }
+
+    // MARK: - Consultas
+
+    func numeroFilas(enSeccion seccion: Int) -> Int {
+        return Int(campo(secciones, seccion, 1))
+    }
+
+    func titulo(deSeccion seccion: Int) -> String {
+        return cadena(offset: campo(secciones, seccion, 2), longitud: campo(secciones, seccion, 3))
+    }
+
+    //Vacio si la fila de un fichero corrupto apunta fuera de la tabla de cadenas
+    func nombre(en indexPath: IndexPath) -> String {
+        let fila = filaAbsoluta(indexPath)
+        let (offset, longitud) = (campo(filas, fila, 0), campo(filas, fila, 1))
+        return cabe(offset, longitud) ? cadena(offset: offset, longitud: longitud) : ""
+    }
+
+    //0 en los heroes guardados antes de existir idMarvel que aun no se han sincronizado
+    func idMarvel(en indexPath: IndexPath) -> Int32 {
+        return Int32(bitPattern: campo(filas, filaAbsoluta(indexPath), 2))
+    }
+
+    private func filaAbsoluta(_ indexPath: IndexPath) -> Int {
+        return Int(campo(secciones, indexPath.section, 0)) + indexPath.row
+    }
+
+    private func campo(_ tabla: UnsafeRawPointer, _ entrada: Int, _ posicion: Int) -> UInt32 {
+        return tabla.load(fromByteOffset: entrada * IndiceNombres.bytesEntrada + posicion * 4, as: UInt32.self)
+    }
+
+    private func cadena(offset: UInt32, longitud: UInt32) -> String {
+        let bytes = UnsafeRawBufferPointer(start: cadenas + Int(offset), count: Int(longitud))
+        return String(decoding: bytes, as: UTF8.self)
+    }
+
+    // MARK: - Generacion
+
+    //Vuelve a generar el indice a partir del almacen, ordenado por nombre
+    class func regenerar(context: NSManagedObjectContext, url: URL = IndiceNombres.url) {
+        let fetchRequest = NSFetchRequest<NSDictionary>(entityName: "Heroe")
+        fetchRequest.resultType = .dictionaryResultType
+        fetchRequest.propertiesToFetch = ["nombre", "idMarvel"]
+        fetchRequest.predicate = NSPredicate(format: "nombre != nil AND nombre != ''")
+        fetchRequest.sortDescriptors = [NSSortDescriptor(key: "nombre", ascending: true, selector: #selector(NSString.localizedCaseInsensitiveCompare(_:)))]
+
+        var registros = [NSDictionary]()
+        context.performAndWait {
+            registros = (try? context.fetch(fetchRequest)) ?? []
+        }
+
+        var cadenas = Data()
+        var filas = [UInt32]()
+        var secciones = [UInt32]()
+        filas.reserveCapacity(registros.count * 4)
+
+        func guardarCadena(_ texto: String) -> (UInt32, UInt32) {
+            let offset = UInt32(cadenas.count)
+            let utf8 = Array(texto.utf8)
+            cadenas.append(contentsOf: utf8)
+            return (offset, UInt32(utf8.count))
+        }
+
+        var tituloActual: String? = nil
+        for (posicion, registro) in registros.enumerated() {
+            let nombre = registro["nombre"] as! String
+            let idMarvel = (registro["idMarvel"] as? NSNumber)?.int32Value ?? 0
+
+            let titulo = IndiceNombres.titulo(paraNombre: nombre)
+            if titulo != tituloActual {
+                if !secciones.isEmpty {
+                    secciones[secciones.count - 3] = UInt32(posicion) - secciones[secciones.count - 4]
+                }
+                let (offsetTitulo, longitudTitulo) = guardarCadena(titulo)
+                secciones.append(contentsOf: [UInt32(posicion), 0, offsetTitulo, longitudTitulo])
+                tituloActual = titulo
+            }
+
+            let (offsetNombre, longitudNombre) = guardarCadena(nombre)
+            filas.append(contentsOf: [offsetNombre, longitudNombre, UInt32(bitPattern: idMarvel), 0])
+        }
+        if !secciones.isEmpty {
+            secciones[secciones.count - 3] = UInt32(registros.count) - secciones[secciones.count - 4]
+        }
+
+        var fichero = Data()
+        let cabecera: [UInt32] = [magia, version, UInt32(registros.count), UInt32(secciones.count / 4), UInt32(cadenas.count)]
+        for tabla in [cabecera, secciones, filas] {
+            tabla.map { $0.littleEndian }.withUnsafeBufferPointer { fichero.append($0) }
+        }
+        fichero.append(cadenas)
+
+        do {
+            try fichero.write(to: url, options: .atomic)
+        } catch {
+            NSLog("No se ha podido guardar el indice de nombres: \(error)")
+        }
+    }
+
+    //Titulo de la seccion: la inicial sin acentos en mayusculas o "#" si no empieza por una letra
+    class func titulo(paraNombre nombre: String) -> String {
+        guard let inicial = nombre.first, String(inicial).rangeOfCharacter(from: CharacterSet.letters) != nil else {
+            return "#"
+        }
+        return String(inicial).folding(options: [.diacriticInsensitive, .caseInsensitive], locale: nil).uppercased()
+    }
+}
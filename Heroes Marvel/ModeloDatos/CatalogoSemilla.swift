@@ -0,0 +1,57 @@
+//
+//  CatalogoSemilla.swift
+//  Heroes Marvel
+//
+//  Created by Borja Gil Herrero on 19/10/2026.
+//  Copyright © 2026 Alsis GHE. All rights reserved.
+//
+
+import Foundation
+import CoreData
+
+//Catalogo de personajes precalculado en tiempo de compilacion (Scripts/generar_catalogo_semilla.sh).
+//Es un almacen SQLite de Core Data con nombre, descripcion y miniatura de cada personaje que se
+//instala como almacen inicial, de forma que la lista no arranca vacia y la sincronizacion
+//solo tiene que pedir lo modificado despues de la fecha de la instantanea.
+class CatalogoSemilla {
+
+    static let nombreFichero = "CatalogoSemilla"
+
+    //Url del catalogo dentro del bundle, nil si la compilacion no lo incluye
+    class var url: URL? {
+        return Bundle.main.url(forResource: nombreFichero, withExtension: "sqlite")
+    }
+
+    //Copia el catalogo como almacen de la aplicacion si todavia no existe ninguno.
+    //En APFS la copia es un clon del fichero, asi que el coste es el de abrirlo.
+    class func instalarSiNecesario(en urlAlmacen: URL) {
+        let fileManager = FileManager.default
+        guard !fileManager.fileExists(atPath: urlAlmacen.path), let urlSemilla = url else {
+            return
+        }
+        do {
+            try fileManager.copyItem(at: urlSemilla, to: urlAlmacen)
+        } catch {
+            NSLog("No se ha podido instalar el catalogo semilla: \(error)")
+            try? fileManager.removeItem(at: urlAlmacen)
+        }
+    }
+
+    //Fecha de modificacion mas reciente guardada en el almacen. La sincronizacion incremental
+    //pide a la API solo los personajes modificados desde esta fecha.
+    class func fechaUltimaModificacion(en context: NSManagedObjectContext) -> Date? {
+        let fetchRequest = NSFetchRequest<NSDictionary>(entityName: "Heroe")
+        fetchRequest.resultType = .dictionaryResultType
+        fetchRequest.propertiesToFetch = ["modificado"]
+        fetchRequest.predicate = NSPredicate(format: "modificado != nil")
+        fetchRequest.sortDescriptors = [NSSortDescriptor(key: "modificado", ascending: false)]
+        fetchRequest.fetchLimit = 1
+
+        var fecha: Date? = nil
+        context.performAndWait {
+            let resultado = try? context.fetch(fetchRequest)
+            fecha = resultado?.first?["modificado"] as? Date
+        }
+        return fecha
+    }
+}
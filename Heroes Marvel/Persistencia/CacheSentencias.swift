@@ -0,0 +1,137 @@
+//
+//  CacheSentencias.swift
+//  Heroes Marvel
+//
+//  Created by Borja Gil Herrero on 19/10/2026.
+//  Copyright © 2026 Alsis GHE. All rights reserved.
+//
+
+import Foundation
+import SQLite3
+
+//Aciertos y fallos de la cache de sentencias de una conexion
+struct EstadisticasCacheSentencias {
+    //Sentencias reutilizadas: solo se han vuelto a vincular, sin compilar
+    var aciertos = 0
+    //Sentencias que ha habido que compilar con sqlite3_prepare
+    var fallos = 0
+    //Sentencias finalizadas por falta de sitio
+    var expulsiones = 0
+
+    var ratioAciertos: Double {
+        let total = aciertos + fallos
+        return total > 0 ? Double(aciertos) / Double(total) : 0
+    }
+}
+
+//Cache LRU de sentencias compiladas indexada por el texto SQL. Las sentencias se sacan de la
+//cache mientras se usan y se devuelven al terminar (reset y bindings limpios), asi dos usos
+//simultaneos del mismo SQL nunca comparten sentencia: el segundo compila una propia.
+//No es segura entre hilos por si sola; la protege el cerrojo de su ConexionSQLite.
+final class CacheSentencias {
+
+    private final class Nodo {
+        let sql: String
+        let sentencia: OpaquePointer
+        weak var anterior: Nodo?
+        var siguiente: Nodo?
+
+        init(sql: String, sentencia: OpaquePointer) {
+            self.sql = sql
+            self.sentencia = sentencia
+        }
+    }
+
+    let capacidad: Int
+    private(set) var estadisticas = EstadisticasCacheSentencias()
+
+    private var nodos = [String: Nodo]()
+    //Mas recientes al principio
+    private var primero: Nodo?
+    private var ultimo: Nodo?
+
+    init(capacidad: Int) {
+        self.capacidad = max(1, capacidad)
+    }
+
+    deinit {
+        vaciar()
+    }
+
+    var numeroSentencias: Int {
+        return nodos.count
+    }
+
+    //Saca la sentencia de la cache o la compila si no esta
+    func obtener(_ sql: String, conexion: OpaquePointer) throws -> OpaquePointer {
+        if let nodo = nodos.removeValue(forKey: sql) {
+            desenlazar(nodo)
+            estadisticas.aciertos += 1
+            return nodo.sentencia
+        }
+        var sentencia: OpaquePointer? = nil
+        let resultado = sqlite3_prepare_v2(conexion, sql, -1, &sentencia, nil)
+        guard resultado == SQLITE_OK, let compilada = sentencia else {
+            sqlite3_finalize(sentencia)
+            throw ErrorSQLite(conexion: conexion, codigo: resultado, sql: sql)
+        }
+        estadisticas.fallos += 1
+        return compilada
+    }
+
+    //Devuelve una sentencia obtenida con obtener(). Si ya hay otra del mismo SQL se finaliza
+    func devolver(_ sentencia: OpaquePointer, sql: String) {
+        sqlite3_reset(sentencia)
+        sqlite3_clear_bindings(sentencia)
+        guard nodos[sql] == nil else {
+            sqlite3_finalize(sentencia)
+            return
+        }
+        let nodo = Nodo(sql: sql, sentencia: sentencia)
+        nodos[sql] = nodo
+        enlazarAlPrincipio(nodo)
+        while nodos.count > capacidad, let expulsado = ultimo {
+            desenlazar(expulsado)
+            nodos[expulsado.sql] = nil
+            sqlite3_finalize(expulsado.sentencia)
+            estadisticas.expulsiones += 1
+        }
+    }
+
+    //Finaliza todas las sentencias guardadas; hay que hacerlo antes de cerrar la conexion
+    func vaciar() {
+        for nodo in nodos.values {
+            sqlite3_finalize(nodo.sentencia)
+        }
+        nodos.removeAll()
+        primero = nil
+        ultimo = nil
+    }
+
+    // MARK: - Lista
+
+    private func enlazarAlPrincipio(_ nodo: Nodo) {
+        nodo.anterior = nil
+        nodo.siguiente = primero
+        primero?.anterior = nodo
+        primero = nodo
+        if ultimo == nil {
+            ultimo = nodo
+        }
+    }
+
+    private func desenlazar(_ nodo: Nodo) {
+        if let anterior = nodo.anterior {
+            anterior.siguiente = nodo.siguiente
+        } else {
+            primero = nodo.siguiente
+        }
+        if let siguiente = nodo.siguiente {
+            siguiente.anterior = nodo.anterior
+        } else {
+            ultimo = nodo.anterior
+        }
+        nodo.anterior = nil
+        nodo.siguiente = nil
+    }
+}
@@ -0,0 +1,233 @@
+//
+//  CambiosORM.swift
+//  Heroes Marvel
+//
+//  Created by Borja Gil Herrero on 19/10/2026.
+//  Copyright © 2026 Alsis GHE. All rights reserved.
+//
+
+import Foundation
+import SQLite3
+import Redbeard
+
+enum OperacionORM {
+    case insercion
+    case actualizacion
+    case borrado
+}
+
+//Filas de una tabla que han cambiado en una transaccion confirmada. Las claves son el rowid, que
+//en las tablas del ORM es la columna pk
+struct CambiosTablaORM {
+    let tabla: String
+    //nil si la clase de la tabla todavia no se ha guardado ni consultado con una ConexionSQLite
+    let clase: RBORMObject.Type?
+    let insertados: [Int64]
+    let actualizados: [Int64]
+    let borrados: [Int64]
+}
+
+//Todo lo que ha cambiado una transaccion, por tabla. Los cambios de una misma fila se resumen:
+//insertada y despues actualizada cuenta como insertada, e insertada y borrada no aparece
+struct CambiosORM {
+    //Identificador de la conexion en la que se han confirmado
+    let identificador: String
+    let tablas: [CambiosTablaORM]
+
+    func cambios(de clase: RBORMObject.Type) -> CambiosTablaORM? {
+        return tablas.first { $0.clase == clase }
+    }
+}
+
+//Recibe un aviso por transaccion confirmada en lugar de uno por objeto como RBORMObserver
+protocol ObservadorCambiosORM: AnyObject {
+    func confirmados(_ cambios: CambiosORM)
+    //Solo si se ha registrado con porObjeto, despues de confirmados() y por cada fila
+    func cambiado(_ pk: Int64, operacion: OperacionORM, en tabla: CambiosTablaORM)
+}
+
+extension ObservadorCambiosORM {
+    func cambiado(_ pk: Int64, operacion: OperacionORM, en tabla: CambiosTablaORM) {
+    }
+}
+
+//Reparte los cambios que confirman las ConexionSQLite. Los cambios que haga Redbeard con sus
+//propias conexiones no pasan por aqui
+final class CentroCambiosORM {
+
+    static let shared = CentroCambiosORM()
+
+    private final class Suscripcion {
+        weak var observador: ObservadorCambiosORM?
+        let cola: DispatchQueue
+        let porObjeto: Bool
+
+        init(observador: ObservadorCambiosORM, cola: DispatchQueue, porObjeto: Bool) {
+            self.observador = observador
+            self.cola = cola
+            self.porObjeto = porObjeto
+        }
+    }
+
+    private let cerrojo = NSLock()
+    private var suscripciones = [Suscripcion]()
+    private var clasesPorTabla = [String: RBORMObject.Type]()
+
+    private init() {
+    }
+
+    //Los avisos llegan en la cola indicada, uno por COMMIT. Con porObjeto ademas uno por fila
+    func registrar(_ observador: ObservadorCambiosORM, cola: DispatchQueue = .main, porObjeto: Bool = false) {
+        cerrojo.lock()
+        suscripciones.append(Suscripcion(observador: observador, cola: cola, porObjeto: porObjeto))
+        cerrojo.unlock()
+    }
+
+    func eliminar(_ observador: ObservadorCambiosORM) {
+        cerrojo.lock()
+        suscripciones = suscripciones.filter { $0.observador != nil && $0.observador !== observador }
+        cerrojo.unlock()
+    }
+
+    //Si alguien escucha: sin observadores no merece la pena pagar nada por los avisos
+    var haySuscripciones: Bool {
+        cerrojo.lock()
+        defer { cerrojo.unlock() }
+        return suscripciones.contains { $0.observador != nil }
+    }
+
+    //Para saber a que clase pertenece cada tabla al agrupar los cambios
+    func anotar(_ clase: RBORMObject.Type) {
+        let tabla = clase.tableName()
+        cerrojo.lock()
+        clasesPorTabla[tabla] = clase
+        cerrojo.unlock()
+    }
+
+    func clase(deTabla tabla: String) -> RBORMObject.Type? {
+        cerrojo.lock()
+        defer { cerrojo.unlock() }
+        return clasesPorTabla[tabla]
+    }
+
+    //Se llama con la transaccion ya confirmada; no espera a los observadores
+    func notificar(_ cambios: CambiosORM) {
+        cerrojo.lock()
+        suscripciones = suscripciones.filter { $0.observador != nil }
+        let actuales = suscripciones
+        cerrojo.unlock()
+        for suscripcion in actuales {
+            suscripcion.cola.async {
+                guard let observador = suscripcion.observador else {
+                    return
+                }
+                observador.confirmados(cambios)
+                guard suscripcion.porObjeto else {
+                    return
+                }
+                for tabla in cambios.tablas {
+                    tabla.insertados.forEach { observador.cambiado($0, operacion: .insercion, en: tabla) }
+                    tabla.actualizados.forEach { observador.cambiado($0, operacion: .actualizacion, en: tabla) }
+                    tabla.borrados.forEach { observador.cambiado($0, operacion: .borrado, en: tabla) }
+                }
+            }
+        }
+    }
+}
+
+//Filas que cambia la transaccion en curso de una ConexionSQLite, segun sqlite3_update_hook. Se
+//usa siempre bajo el cerrojo de la conexion: los hooks se llaman desde sqlite3_step
+final class RegistroCambios {
+
+    private struct Cambio {
+        let tabla: Int
+        let operacion: Int32
+        let rowid: Int64
+    }
+
+    private var cambios = [Cambio]()
+    private var tablas = [String]()
+    private var indices = [String: Int]()
+    //Casi todos los cambios seguidos son de la misma tabla: se compara con la anterior sin crear un String
+    private var ultimaTabla: UnsafeMutablePointer<CChar>? = nil
+    private var ultimoIndice = 0
+
+    deinit {
+        free(ultimaTabla)
+    }
+
+    func instalar(en baseDatos: OpaquePointer) {
+        let contexto = Unmanaged.passUnretained(self).toOpaque()
+        sqlite3_update_hook(baseDatos, { contexto, operacion, _, tabla, rowid in
+            Unmanaged<RegistroCambios>.fromOpaque(contexto!).takeUnretainedValue().anotar(operacion, tabla: tabla!, rowid: rowid)
+        }, contexto)
+        //Tambien cuando SQLite deshace la transaccion por un error
+        sqlite3_rollback_hook(baseDatos, { contexto in
+            Unmanaged<RegistroCambios>.fromOpaque(contexto!).takeUnretainedValue().descartar()
+        }, contexto)
+    }
+
+    //Posicion a la que volver si se deshace una sentencia o un punto de guardado
+    var marca: Int {
+        return cambios.count
+    }
+
+    func deshacer(hasta marca: Int) {
+        if cambios.count > marca {
+            cambios.removeSubrange(marca...)
+        }
+    }
+
+    func descartar() {
+        cambios.removeAll()
+    }
+
+    private func anotar(_ operacion: Int32, tabla: UnsafePointer<CChar>, rowid: Int64) {
+        if ultimaTabla == nil || strcmp(ultimaTabla!, tabla) != 0 {
+            let nombre = String(cString: tabla)
+            if let indice = indices[nombre] {
+                ultimoIndice = indice
+            } else {
+                ultimoIndice = tablas.count
+                indices[nombre] = ultimoIndice
+                tablas.append(nombre)
+            }
+            free(ultimaTabla)
+            ultimaTabla = strdup(tabla)
+        }
+        cambios.append(Cambio(tabla: ultimoIndice, operacion: operacion, rowid: rowid))
+    }
+
+    //Resume los cambios de la transaccion que se acaba de confirmar y empieza de cero
+    func confirmar(identificador: String) -> CambiosORM? {
+        guard !cambios.isEmpty else {
+            return nil
+        }
+        var estados = [Int: [Int64: Int32]]()
+        for cambio in cambios {
+            estados[cambio.tabla, default: [:]][cambio.rowid] = RegistroCambios.resumir(estados[cambio.tabla]?[cambio.rowid], cambio.operacion)
+        }
+        cambios.removeAll()
+
+        let tablasCambiadas = estados.keys.sorted().compactMap { indice -> CambiosTablaORM? in
+            let filas = estados[indice] ?? [:]
+            let claves = { (operacion: Int32) in filas.filter { $0.value == operacion }.keys.sorted() }
+            let cambiosTabla = CambiosTablaORM(tabla: tablas[indice], clase: CentroCambiosORM.shared.clase(deTabla: tablas[indice]),
+                                               insertados: claves(SQLITE_INSERT), actualizados: claves(SQLITE_UPDATE),
+                                               borrados: claves(SQLITE_DELETE))
+            return filas.isEmpty ? nil : cambiosTabla
+        }
+        return tablasCambiadas.isEmpty ? nil : CambiosORM(identificador: identificador, tablas: tablasCambiadas)
+    }
+
+    //Lo que queda de una fila tras un cambio mas en la misma transaccion. nil es que no ha cambiado
+    private class func resumir(_ anterior: Int32?, _ operacion: Int32) -> Int32? {
+        if anterior == SQLITE_INSERT {
+            return operacion == SQLITE_DELETE ? nil : SQLITE_INSERT
+        }
+        if anterior == SQLITE_DELETE && operacion == SQLITE_INSERT {
+            return SQLITE_UPDATE
+        }
+        return operacion
+    }
+}
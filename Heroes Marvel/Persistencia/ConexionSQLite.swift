@@ -0,0 +1,327 @@
+//
+//  ConexionSQLite.swift
+//  Heroes Marvel
+//
+//  Created by Borja Gil Herrero on 19/10/2026.
+//  Copyright © 2026 Alsis GHE. All rights reserved.
+//
+
+import Foundation
+import SQLite3
+import Redbeard
+
+//Error de SQLite con el mensaje de la conexion y, si lo hay, el SQL que lo ha provocado
+struct ErrorSQLite: Error, CustomStringConvertible {
+    let codigo: Int32
+    let mensaje: String
+    let sql: String?
+
+    init(codigo: Int32, mensaje: String, sql: String? = nil) {
+        self.codigo = codigo
+        self.mensaje = mensaje
+        self.sql = sql
+    }
+
+    init(conexion: OpaquePointer?, codigo: Int32, sql: String? = nil) {
+        self.codigo = codigo
+        self.sql = sql
+        if let conexion = conexion {
+            mensaje = String(cString: sqlite3_errmsg(conexion))
+        } else {
+            mensaje = String(cString: sqlite3_errstr(codigo))
+        }
+    }
+
+    var description: String {
+        return "SQLite \(codigo): \(mensaje)" + (sql.map { " [\($0)]" } ?? "")
+    }
+}
+
+//Conexion propia a una base de datos SQLite con cache de sentencias compiladas.
+//RBSQLiteConnection recibe el SQL como texto en cada llamada y lo vuelve a compilar siempre, y
+//Redbeard es un framework binario: no podemos cambiarla ni llegar a su sqlite3*. Esta conexion
+//abre el mismo fichero (con el VFS que se indique) y guarda las sentencias en una cache LRU,
+//asi repetir una consulta o un guardado del ORM es vincular y ejecutar, sin compilar.
+//Se puede usar desde cualquier hilo: cada operacion se hace entera bajo el cerrojo.
+final class ConexionSQLite {
+
+    static let identificadorPorDefecto = "*default*"
+    static let capacidadCachePorDefecto = 64
+    //Para que SQLite copie los textos y blobs que se vinculan
+    static let transitorio = unsafeBitCast(-1, to: sqlite3_destructor_type.self)
+
+    let ruta: String
+    //Identificador de base de datos de Redbeard que se asigna a los objetos del ORM que se leen
+    let identificador: String
+
+    let baseDatos: OpaquePointer
+    private let cerrojo = NSRecursiveLock()
+    private let sentencias: CacheSentencias
+    //Filas cambiadas en la transaccion en curso, que se envian a CentroCambiosORM al confirmarla
+    private let registroCambios = RegistroCambios()
+    //Clases del ORM cuyos indices ya estan al dia en esta conexion, ver asegurarIndices()
+    var clasesIndexadas = Set<ObjectIdentifier>()
+
+    init(ruta: String, identificador: String = ConexionSQLite.identificadorPorDefecto,
+         flags: Int32 = SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE, vfs: String? = nil,
+         capacidadCache: Int = ConexionSQLite.capacidadCachePorDefecto) throws {
+        var conexion: OpaquePointer? = nil
+        let resultado = sqlite3_open_v2(ruta, &conexion, flags, vfs)
+        guard resultado == SQLITE_OK, let abierta = conexion else {
+            let error = ErrorSQLite(conexion: conexion, codigo: resultado)
+            sqlite3_close_v2(conexion)
+            throw error
+        }
+        sqlite3_busy_timeout(abierta, 5000)
+        self.ruta = ruta
+        self.identificador = identificador
+        baseDatos = abierta
+        sentencias = CacheSentencias(capacidad: capacidadCache)
+        registroCambios.instalar(en: abierta)
+    }
+
+    //Abre el mismo fichero que una conexion de Redbeard
+    convenience init(conexion: RBSQLiteConnection, identificador: String = ConexionSQLite.identificadorPorDefecto, vfs: String? = nil) throws {
+        try self.init(ruta: conexion.dataFilePath, identificador: identificador, vfs: vfs)
+    }
+
+    deinit {
+        sentencias.vaciar()
+        sqlite3_close_v2(baseDatos)
+    }
+
+    var estadisticasSentencias: EstadisticasCacheSentencias {
+        cerrojo.lock()
+        defer { cerrojo.unlock() }
+        return sentencias.estadisticas
+    }
+
+    //Abierta con SQLITE_OPEN_READONLY, como los lectores de un PoolConexiones
+    var soloLectura: Bool {
+        return sqlite3_db_readonly(baseDatos, "main") == 1
+    }
+
+    var ultimoRowid: Int64 {
+        cerrojo.lock()
+        defer { cerrojo.unlock() }
+        return sqlite3_last_insert_rowid(baseDatos)
+    }
+
+    //Corta la sentencia que se este ejecutando, que termina con SQLITE_INTERRUPT. Se llama desde
+    //otro hilo, por eso no toma el cerrojo: lo tiene la sentencia que se quiere cortar
+    func interrumpir() {
+        sqlite3_interrupt(baseDatos)
+    }
+
+    //Ejecuta el bloque con la conexion bloqueada para los demas hilos
+    func conCerrojo<T>(_ bloque: () throws -> T) rethrows -> T {
+        cerrojo.lock()
+        defer { cerrojo.unlock() }
+        return try bloque()
+    }
+
+    //Ejecuta SQL sin pasar por la cache de sentencias, para lo que solo se ejecuta una vez como
+    //crear o borrar tablas e indices. Admite varias sentencias separadas por punto y coma
+    func ejecutarScript(_ sql: String) throws {
+        cerrojo.lock()
+        defer { cerrojo.unlock() }
+        let marca = registroCambios.marca
+        let resultado = sqlite3_exec(baseDatos, sql, nil, nil, nil)
+        guard resultado == SQLITE_OK else {
+            registroCambios.deshacer(hasta: marca)
+            throw ErrorSQLite(conexion: baseDatos, codigo: resultado, sql: sql)
+        }
+        confirmarCambios()
+    }
+
+    // MARK: - Sentencias
+
+    //Saca la sentencia de la cache, la vincula con los valores y se la pasa al bloque. Al terminar
+    //vuelve a la cache aunque el bloque falle. El cerrojo se mantiene durante todo el bloque
+    func conSentencia<T>(_ sql: String, valores: [Any] = [], _ bloque: (OpaquePointer) throws -> T) throws -> T {
+        cerrojo.lock()
+        defer { cerrojo.unlock() }
+        let sentencia = try sentencias.obtener(sql, conexion: baseDatos)
+        defer { sentencias.devolver(sentencia, sql: sql) }
+        try vincular(valores, a: sentencia, sql: sql)
+        let marca = registroCambios.marca
+        do {
+            let resultado = try bloque(sentencia)
+            confirmarCambios()
+            return resultado
+        } catch {
+            //La sentencia que falla deshace sus filas, pero sqlite3_update_hook ya las ha contado
+            registroCambios.deshacer(hasta: marca)
+            throw error
+        }
+    }
+
+    //Ejecuta una sentencia que no devuelve filas y devuelve las filas afectadas
+    @discardableResult
+    func ejecutar(_ sql: String, valores: [Any] = []) throws -> Int {
+        return try conSentencia(sql, valores: valores) { sentencia in
+            var resultado = sqlite3_step(sentencia)
+            while resultado == SQLITE_ROW {
+                resultado = sqlite3_step(sentencia)
+            }
+            guard resultado == SQLITE_DONE else {
+                throw ErrorSQLite(conexion: baseDatos, codigo: resultado, sql: sql)
+            }
+            return Int(sqlite3_changes(baseDatos))
+        }
+    }
+
+    //Ejecuta una consulta y devuelve todas las filas en un RBSQLiteResultSet, el mismo tipo que
+    //devuelve RBSQLiteConnection, para poder pasarlo a populateWithResultSet del ORM
+    func consultar(_ sql: String, valores: [Any] = []) throws -> RBSQLiteResultSet {
+        return try conSentencia(sql, valores: valores) { sentencia in
+            let columnas = Int(sqlite3_column_count(sentencia))
+            let nombres = (0..<columnas).map { String(cString: sqlite3_column_name(sentencia, Int32($0))) }
+            var tipos: [NSNumber]? = nil
+            var campos = [Any]()
+
+            var resultado = sqlite3_step(sentencia)
+            while resultado == SQLITE_ROW {
+                if tipos == nil {
+                    tipos = (0..<columnas).map { NSNumber(value: ConexionSQLite.tipoCampo(sqlite3_column_type(sentencia, Int32($0))).rawValue) }
+                }
+                for columna in 0..<Int32(columnas) {
+                    campos.append(ConexionSQLite.valor(de: sentencia, columna: columna))
+                }
+                resultado = sqlite3_step(sentencia)
+            }
+            guard resultado == SQLITE_DONE else {
+                throw ErrorSQLite(conexion: baseDatos, codigo: resultado, sql: sql)
+            }
+            let sinFilas = [NSNumber](repeating: NSNumber(value: RBSQLiteFieldType.null.rawValue), count: columnas)
+            return RBSQLiteResultSet(columnNames: nombres, columnTypes: tipos ?? sinFilas, fieldValues: campos)
+        }
+    }
+
+    // MARK: - Transacciones
+
+    //Ejecuta el bloque en una transaccion: COMMIT si termina bien y ROLLBACK si lanza un error.
+    //Si ya hay una transaccion abierta en la conexion el bloque se une a ella
+    @discardableResult
+    func enTransaccion<T>(_ bloque: () throws -> T) throws -> T {
+        cerrojo.lock()
+        defer { cerrojo.unlock() }
+        guard sqlite3_get_autocommit(baseDatos) != 0 else {
+            return try bloque()
+        }
+        //IMMEDIATE toma ya el cerrojo de escritura y no falla a mitad por otra conexion
+        try ejecutar("BEGIN IMMEDIATE")
+        do {
+            let resultado = try bloque()
+            try ejecutar("COMMIT")
+            return resultado
+        } catch {
+            _ = try? ejecutar("ROLLBACK")
+            throw error
+        }
+    }
+
+    //Deshace solo lo que haga el bloque si lanza un error, sin tocar el resto de la transaccion
+    @discardableResult
+    func conPuntoGuardado<T>(_ bloque: () throws -> T) throws -> T {
+        cerrojo.lock()
+        defer { cerrojo.unlock() }
+        let marca = registroCambios.marca
+        try ejecutar("SAVEPOINT punto")
+        do {
+            let resultado = try bloque()
+            try ejecutar("RELEASE punto")
+            return resultado
+        } catch {
+            _ = try? ejecutar("ROLLBACK TO punto")
+            //Antes del RELEASE: fuera de una transaccion es el que confirma
+            registroCambios.deshacer(hasta: marca)
+            _ = try? ejecutar("RELEASE punto")
+            throw error
+        }
+    }
+
+    //Si la sentencia ha terminado una transaccion (un COMMIT o una sentencia suelta) que ha
+    //cambiado filas, envia el resumen a CentroCambiosORM. El ROLLBACK lo descarta el propio registro
+    private func confirmarCambios() {
+        guard sqlite3_get_autocommit(baseDatos) != 0, let cambios = registroCambios.confirmar(identificador: identificador) else {
+            return
+        }
+        CentroCambiosORM.shared.notificar(cambios)
+    }
+
+    // MARK: - Valores
+
+    //Vincula los valores con los mismos tipos que acepta Redbeard en sus bindings
+    private func vincular(_ valores: [Any], a sentencia: OpaquePointer, sql: String) throws {
+        for (posicion, valor) in valores.enumerated() {
+            let indice = Int32(posicion + 1)
+            let resultado: Int32
+            switch valor {
+            case is NSNull:
+                resultado = sqlite3_bind_null(sentencia, indice)
+            case let numero as NSNumber:
+                //Los NSNumber de coma flotante van como REAL y el resto (incluidos los Bool) como INTEGER
+                let tipo = String(cString: numero.objCType)
+                if tipo == "d" || tipo == "f" {
+                    resultado = sqlite3_bind_double(sentencia, indice, numero.doubleValue)
+                } else {
+                    resultado = sqlite3_bind_int64(sentencia, indice, numero.int64Value)
+                }
+            case let texto as String:
+                resultado = sqlite3_bind_text(sentencia, indice, texto, -1, ConexionSQLite.transitorio)
+            case let datos as Data:
+                resultado = datos.withUnsafeBytes { (bytes: UnsafePointer<UInt8>) in
+                    sqlite3_bind_blob(sentencia, indice, bytes, Int32(datos.count), ConexionSQLite.transitorio)
+                }
+            case let fecha as Date:
+                let texto = RBSQLiteCenter.shared()?.string(from: fecha) ?? ISO8601DateFormatter().string(from: fecha)
+                resultado = sqlite3_bind_text(sentencia, indice, texto, -1, ConexionSQLite.transitorio)
+            default:
+                resultado = sqlite3_bind_text(sentencia, indice, "\(valor)", -1, ConexionSQLite.transitorio)
+            }
+            guard resultado == SQLITE_OK else {
+                throw ErrorSQLite(conexion: baseDatos, codigo: resultado, sql: sql)
+            }
+        }
+    }
+
+    //Valor de una columna de la fila actual como objeto, igual que los campos de RBSQLiteResultSet
+    class func valor(de sentencia: OpaquePointer, columna: Int32) -> Any {
+        switch sqlite3_column_type(sentencia, columna) {
+        case SQLITE_INTEGER:
+            return NSNumber(value: sqlite3_column_int64(sentencia, columna))
+        case SQLITE_FLOAT:
+            return NSNumber(value: sqlite3_column_double(sentencia, columna))
+        case SQLITE_TEXT:
+            guard let texto = sqlite3_column_text(sentencia, columna) else {
+                return ""
+            }
+            return String(cString: texto)
+        case SQLITE_BLOB:
+            guard let bytes = sqlite3_column_blob(sentencia, columna) else {
+                return Data()
+            }
+            return Data(bytes: bytes, count: Int(sqlite3_column_bytes(sentencia, columna)))
+        default:
+            return NSNull()
+        }
+    }
+
+    class func tipoCampo(_ tipoSQLite: Int32) -> RBSQLiteFieldType {
+        switch tipoSQLite {
+        case SQLITE_INTEGER:
+            return .integer
+        case SQLITE_FLOAT:
+            return .float
+        case SQLITE_TEXT:
+            return .text
+        case SQLITE_BLOB:
+            return .blob
+        case SQLITE_NULL:
+            return .null
+        default:
+            return .unknown
+        }
+    }
+}
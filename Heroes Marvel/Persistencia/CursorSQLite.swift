@@ -0,0 +1,141 @@
+//
+//  CursorSQLite.swift
+//  Heroes Marvel
+//
+//  Created by Borja Gil Herrero on 19/10/2026.
+//  Copyright © 2026 Alsis GHE. All rights reserved.
+//
+
+import Foundation
+import SQLite3
+import Redbeard
+
+//Fila actual de un recorrido. Lee directamente de la sentencia, sin crear objetos: los textos y
+//blobs son de SQLite y solo valen hasta pasar a la siguiente fila, no se pueden guardar fuera
+//del bloque de recorrer() (para eso estan cadena() y datos(), que copian)
+struct FilaSQLite {
+
+    let sentencia: OpaquePointer
+
+    var numeroColumnas: Int {
+        return Int(sqlite3_column_count(sentencia))
+    }
+
+    func nombre(_ columna: Int) -> String {
+        return String(cString: sqlite3_column_name(sentencia, Int32(columna)))
+    }
+
+    func tipo(_ columna: Int) -> RBSQLiteFieldType {
+        return ConexionSQLite.tipoCampo(sqlite3_column_type(sentencia, Int32(columna)))
+    }
+
+    func esNulo(_ columna: Int) -> Bool {
+        return sqlite3_column_type(sentencia, Int32(columna)) == SQLITE_NULL
+    }
+
+    func int64(_ columna: Int) -> Int64 {
+        return sqlite3_column_int64(sentencia, Int32(columna))
+    }
+
+    func double(_ columna: Int) -> Double {
+        return sqlite3_column_double(sentencia, Int32(columna))
+    }
+
+    //UTF-8 del texto sin el cero final. Vacio si la columna es NULL
+    func texto(_ columna: Int) -> UnsafeBufferPointer<UInt8> {
+        //Primero el puntero y despues los bytes, en este orden para que SQLite no convierta dos veces
+        guard let bytes = sqlite3_column_text(sentencia, Int32(columna)) else {
+            return UnsafeBufferPointer(start: nil, count: 0)
+        }
+        return UnsafeBufferPointer(start: bytes, count: Int(sqlite3_column_bytes(sentencia, Int32(columna))))
+    }
+
+    //Bytes del blob. Vacio si la columna es NULL o el blob no tiene bytes
+    func blob(_ columna: Int) -> UnsafeRawBufferPointer {
+        guard let bytes = sqlite3_column_blob(sentencia, Int32(columna)) else {
+            return UnsafeRawBufferPointer(start: nil, count: 0)
+        }
+        return UnsafeRawBufferPointer(start: bytes, count: Int(sqlite3_column_bytes(sentencia, Int32(columna))))
+    }
+
+    func cadena(_ columna: Int) -> String? {
+        guard !esNulo(columna) else {
+            return nil
+        }
+        return String(decoding: texto(columna), as: UTF8.self)
+    }
+
+    func datos(_ columna: Int) -> Data? {
+        guard !esNulo(columna) else {
+            return nil
+        }
+        return Data(blob(columna))
+    }
+
+    //El mismo objeto que tendria el campo en un RBSQLiteResultSet
+    func valor(_ columna: Int) -> Any {
+        return ConexionSQLite.valor(de: sentencia, columna: Int32(columna))
+    }
+}
+
+extension ConexionSQLite {
+
+    //Recorre las filas de la consulta segun las va dando SQLite, sin guardarlas: la memoria no
+    //crece con el resultado y la primera fila llega sin esperar a las demas. El bloque devuelve
+    //false para parar. Devuelve las filas recorridas.
+    //La conexion queda bloqueada para otros hilos hasta terminar el recorrido
+    @discardableResult
+    func recorrer(_ sql: String, valores: [Any] = [], _ bloque: (FilaSQLite) throws -> Bool) throws -> Int {
+        return try conSentencia(sql, valores: valores) { sentencia in
+            let fila = FilaSQLite(sentencia: sentencia)
+            var filas = 0
+            var resultado = sqlite3_step(sentencia)
+            while resultado == SQLITE_ROW {
+                filas += 1
+                //Al parar, devolver la sentencia a la cache la resetea y suelta la lectura
+                guard try bloque(fila) else {
+                    return filas
+                }
+                resultado = sqlite3_step(sentencia)
+            }
+            guard resultado == SQLITE_DONE else {
+                throw ErrorSQLite(conexion: baseDatos, codigo: resultado, sql: sql)
+            }
+            return filas
+        }
+    }
+}
+
+extension RBORMObject {
+
+    //Variante de populateWithResultSet:atRow: para recorrer(): crea el objeto a partir de la fila
+    //actual con un RBSQLiteResultSet de una sola fila, asi las conversiones son las de Redbeard.
+    //Los nombres de columna se leen una vez por recorrido y se pasan en cada fila
+    class func poblar(con fila: FilaSQLite, columnas nombres: [String], databaseIdentifier: String) -> Self {
+        let tipos = (0..<nombres.count).map { NSNumber(value: fila.tipo($0).rawValue) }
+        let campos = (0..<nombres.count).map { fila.valor($0) }
+        let resultado = RBSQLiteResultSet(columnNames: nombres, columnTypes: tipos, fieldValues: campos)
+        return populate(with: resultado, atRow: 0, databaseIdentifier: databaseIdentifier)
+    }
+}
+
+extension RBORMQuery {
+
+    //Como ejecutar(en:) pero entregando los objetos de uno en uno mientras se leen. El bloque
+    //devuelve false para parar. Solo para consultas que devuelven objetos
+    @discardableResult
+    func recorrer(en conexion: ConexionSQLite, _ bloque: (RBORMObject) throws -> Bool) throws -> Int {
+        guard !isNonQuery, !isScalar, let clase = objectType as? RBORMObject.Type else {
+            throw ErrorSQLite(codigo: SQLITE_MISUSE, mensaje: "La consulta no devuelve objetos", sql: queryString)
+        }
+        conexion.asegurarIndices(clase)
+        conexion.comprobarPlan(queryString, valores: bindings ?? [])
+        var nombres: [String]? = nil
+        return try conexion.recorrer(queryString, valores: bindings ?? []) { fila in
+            if nombres == nil {
+                nombres = (0..<fila.numeroColumnas).map { fila.nombre($0) }
+            }
+            return try bloque(clase.poblar(con: fila, columnas: nombres ?? [], databaseIdentifier: conexion.identificador))
+        }
+    }
+}
@@ -0,0 +1,203 @@
+//
+//  EjecutorConsultas.swift
+//  Heroes Marvel
+//
+//  Created by Borja Gil Herrero on 19/10/2026.
+//  Copyright © 2026 Alsis GHE. All rights reserved.
+//
+
+import Foundation
+import SQLite3
+import Redbeard
+
+enum ResultadoConsulta {
+    //Lo mismo que devuelve RBORMQuery.ejecutar(en:)
+    case filas([Any])
+    case fallo(Error)
+}
+
+//Peticion de un llamante. Varias pueden compartir la misma ejecucion si piden la misma consulta
+final class TareaConsulta: NSObject, RBCancellableTask {
+
+    fileprivate let cola: DispatchQueue
+    fileprivate let completion: (ResultadoConsulta) -> Void
+    fileprivate weak var ejecutor: EjecutorConsultas?
+    fileprivate var vuelo: VueloConsulta?
+    fileprivate var cancelada = false
+
+    fileprivate init(cola: DispatchQueue, completion: @escaping (ResultadoConsulta) -> Void) {
+        self.cola = cola
+        self.completion = completion
+    }
+
+    //El completion ya no se llama. Si nadie mas espera la consulta se corta
+    func cancel() {
+        ejecutor?.cancelar(self)
+    }
+}
+
+//Una consulta encolada o ejecutandose y las tareas que esperan su resultado
+private final class VueloConsulta {
+    let clave: String
+    var tareas = [TareaConsulta]()
+    var cancelado = false
+    //Conexion que la esta ejecutando, para poder interrumpirla
+    var conexion: ConexionSQLite?
+
+    init(clave: String) {
+        self.clave = clave
+    }
+}
+
+//Ejecuta consultas del ORM fuera del hilo que las pide y entrega el resultado en la cola que se
+//indique. Una consulta igual a otra que aun no ha terminado se une a ella en lugar de repetirse.
+//Cancelar la ultima tarea de una consulta la corta con sqlite3_interrupt aunque ya este en marcha,
+//asi al buscar mientras se escribe las consultas viejas no se acumulan
+final class EjecutorConsultas {
+
+    private let pool: PoolConexiones?
+    private let conexion: ConexionSQLite?
+    private let colaConsultas: DispatchQueue
+    private let cerrojo = NSLock()
+    private var vuelos = [String: VueloConsulta]()
+
+    //Con una conexion las consultas van de una en una
+    init(conexion: ConexionSQLite) {
+        self.conexion = conexion
+        pool = nil
+        colaConsultas = DispatchQueue(label: "EjecutorConsultas.\(conexion.identificador)", qos: .userInitiated)
+    }
+
+    //Con un pool se ejecutan a la vez tantas lecturas como lectores tenga
+    init(pool: PoolConexiones) {
+        self.pool = pool
+        conexion = nil
+        colaConsultas = DispatchQueue(label: "EjecutorConsultas.\(pool.identificador)", qos: .userInitiated, attributes: .concurrent)
+    }
+
+    @discardableResult
+    func ejecutar(_ consulta: RBORMQuery, cola: DispatchQueue = .main, completion: @escaping (ResultadoConsulta) -> Void) -> RBCancellableTask {
+        let tarea = TareaConsulta(cola: cola, completion: completion)
+        tarea.ejecutor = self
+        //Las que modifican no se unen: cada una tiene que ejecutarse
+        let clave = consulta.isNonQuery ? UUID().uuidString : EjecutorConsultas.clave(de: consulta)
+
+        cerrojo.lock()
+        if let vuelo = vuelos[clave], !vuelo.cancelado {
+            vuelo.tareas.append(tarea)
+            tarea.vuelo = vuelo
+            cerrojo.unlock()
+            return tarea
+        }
+        let vuelo = VueloConsulta(clave: clave)
+        vuelo.tareas.append(tarea)
+        tarea.vuelo = vuelo
+        vuelos[clave] = vuelo
+        cerrojo.unlock()
+
+        colaConsultas.async {
+            self.lanzar(consulta, vuelo: vuelo)
+        }
+        return tarea
+    }
+
+    fileprivate func cancelar(_ tarea: TareaConsulta) {
+        cerrojo.lock()
+        defer { cerrojo.unlock() }
+        tarea.cancelada = true
+        guard let vuelo = tarea.vuelo else {
+            return
+        }
+        tarea.vuelo = nil
+        vuelo.tareas = vuelo.tareas.filter { $0 !== tarea }
+        guard vuelo.tareas.isEmpty else {
+            return
+        }
+        vuelo.cancelado = true
+        if vuelos[vuelo.clave] === vuelo {
+            vuelos[vuelo.clave] = nil
+        }
+        //Bajo el cerrojo: la conexion no se suelta hasta que la sentencia ha terminado, asi la
+        //interrupcion no puede caer en otra consulta
+        vuelo.conexion?.interrumpir()
+    }
+
+    private func lanzar(_ consulta: RBORMQuery, vuelo: VueloConsulta) {
+        cerrojo.lock()
+        let cancelado = vuelo.cancelado
+        cerrojo.unlock()
+        guard !cancelado else {
+            return
+        }
+
+        let resultado: ResultadoConsulta
+        do {
+            let filas = try conConexion(consulta) { conexion -> [Any] in
+                cerrojo.lock()
+                vuelo.conexion = conexion
+                let cancelado = vuelo.cancelado
+                cerrojo.unlock()
+                defer {
+                    cerrojo.lock()
+                    vuelo.conexion = nil
+                    cerrojo.unlock()
+                }
+                guard !cancelado else {
+                    throw ErrorSQLite(codigo: SQLITE_INTERRUPT, mensaje: "Consulta cancelada", sql: consulta.queryString)
+                }
+                return try consulta.ejecutar(en: conexion)
+            }
+            resultado = .filas(filas)
+        } catch {
+            resultado = .fallo(error)
+        }
+
+        cerrojo.lock()
+        if vuelos[vuelo.clave] === vuelo {
+            vuelos[vuelo.clave] = nil
+        }
+        let tareas = vuelo.tareas
+        vuelo.tareas.removeAll()
+        for tarea in tareas {
+            tarea.vuelo = nil
+        }
+        cerrojo.unlock()
+
+        for tarea in tareas {
+            tarea.cola.async {
+                //Se puede haber cancelado despues de terminar la consulta
+                self.cerrojo.lock()
+                let cancelada = tarea.cancelada
+                self.cerrojo.unlock()
+                if !cancelada {
+                    tarea.completion(resultado)
+                }
+            }
+        }
+    }
+
+    //Con pool, las consultas a un lector y las que modifican al escritor
+    private func conConexion(_ consulta: RBORMQuery, _ bloque: (ConexionSQLite) throws -> [Any]) throws -> [Any] {
+        //El bloque anota la conexion para cancelar: tiene que estar ya bloqueada, como en el pool,
+        //para que la interrupcion no caiga en la sentencia de otro hilo
+        if let conexion = conexion {
+            return try conexion.conCerrojo { try bloque(conexion) }
+        }
+        guard let pool = pool else {
+            return []
+        }
+        if consulta.isNonQuery {
+            return try pool.escribir(bloque)
+        }
+        if let clase = consulta.objectType as? RBORMObject.Type {
+            pool.escritor.asegurarIndices(clase)
+        }
+        return try pool.leer(bloque)
+    }
+
+    //Dos consultas son la misma si tienen el mismo SQL, valores y clase de objeto
+    private class func clave(de consulta: RBORMQuery) -> String {
+        let valores = (consulta.bindings ?? []).map { "\(type(of: $0)):\($0)" }.joined(separator: "\u{1}")
+        return ["\(consulta.objectType)", consulta.queryString, valores].joined(separator: "\u{0}")
+    }
+}
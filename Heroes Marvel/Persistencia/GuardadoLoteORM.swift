@@ -0,0 +1,204 @@
+//
+//  GuardadoLoteORM.swift
+//  Heroes Marvel
+//
+//  Created by Borja Gil Herrero on 19/10/2026.
+//  Copyright © 2026 Alsis GHE. All rights reserved.
+//
+
+import Foundation
+import SQLite3
+import Redbeard
+
+//Resultado de cada objeto del lote, en el mismo orden en que se han pasado
+struct ResultadoLoteORM {
+    //nil si el objeto se ha guardado
+    let errores: [Error?]
+
+    var guardados: Int {
+        return errores.filter { $0 == nil }.count
+    }
+
+    func guardado(_ indice: Int) -> Bool {
+        return errores[indice] == nil
+    }
+}
+
+extension RBORMObject {
+
+    //Tope de filas por sentencia aunque SQLite admita mas variables: sentencias mas largas
+    //apenas ahorran y ocupan mas en la cache
+    static let filasPorSentenciaMaximas = 100
+
+    //Guarda objetos de esta clase en una sola transaccion con INSERT de varias filas que quedan
+    //compiladas en la cache de la conexion. Los objetos sin clave primaria la reciben de SQLite,
+    //como en save, asi no se reutiliza la de una fila borrada. Los que ya tienen clave van en un
+    //INSERT ... ON CONFLICT de varias filas o, con SQLite anterior a 3.24, fila a fila. Si un grupo
+    //de filas falla se repite fila a fila para saber cuales son: las demas se guardan igual. Llama
+    //a los will/did de cada objeto; los observadores de CentroCambiosORM reciben todas las claves
+    //en un solo aviso al confirmar
+    @discardableResult
+    class func guardar(_ objetos: [RBORMObject], en conexion: ConexionSQLite) throws -> ResultadoLoteORM {
+        guard !objetos.isEmpty else {
+            return ResultadoLoteORM(errores: [])
+        }
+        guard objetos.allSatisfy({ type(of: $0) == self }) else {
+            throw ErrorSQLite(codigo: SQLITE_MISUSE, mensaje: "El lote solo puede tener objetos de \(self)")
+        }
+        let sentencias = SentenciasORM.para(self)
+        conexion.asegurarIndices(self)
+        let nuevos = objetos.map { !$0.hasPrimaryKey }
+        if nuevos.contains(true) {
+            try comprobarClaveAsignable()
+        }
+        for (objeto, nuevo) in zip(objetos, nuevos) {
+            if nuevo {
+                objeto.willInsert()
+            } else {
+                objeto.willUpdate()
+            }
+        }
+
+        var lote = LoteGuardado(objetos: objetos, sentencias: sentencias, conexion: conexion)
+        do {
+            try conexion.enTransaccion { () throws -> Void in
+                try lote.insertar(objetos.indices.filter { nuevos[$0] })
+                try lote.actualizar(objetos.indices.filter { !nuevos[$0] })
+            }
+        } catch {
+            for (objeto, nuevo) in zip(objetos, nuevos) {
+                if nuevo {
+                    objeto.didInsert(false)
+                } else {
+                    objeto.didUpdate(false)
+                }
+            }
+            throw error
+        }
+
+        var errores = lote.errores
+        for (indice, objeto) in objetos.enumerated() {
+            if nuevos[indice] {
+                if errores[indice] == nil {
+                    do {
+                        try objeto.asignarClavePrimaria(lote.claves[indice])
+                    } catch {
+                        errores[indice] = error
+                    }
+                }
+                objeto.didInsert(errores[indice] == nil)
+            } else {
+                objeto.didUpdate(errores[indice] == nil)
+            }
+        }
+        return ResultadoLoteORM(errores: errores)
+    }
+}
+
+//Estado de un guardado por lotes dentro de su transaccion
+private struct LoteGuardado {
+
+    let objetos: [RBORMObject]
+    let sentencias: SentenciasORM
+    let conexion: ConexionSQLite
+    var errores: [Error?]
+    var claves: [Int64]
+
+    init(objetos: [RBORMObject], sentencias: SentenciasORM, conexion: ConexionSQLite) {
+        self.objetos = objetos
+        self.sentencias = sentencias
+        self.conexion = conexion
+        errores = [Error?](repeating: nil, count: objetos.count)
+        claves = objetos.map { Int64($0.pk) }
+    }
+
+    //Filas por sentencia segun el limite de variables de SQLite
+    private func filasPorSentencia(valoresPorFila: Int) -> Int {
+        let limite = Int(sqlite3_limit(conexion.baseDatos, SQLITE_LIMIT_VARIABLE_NUMBER, -1))
+        return max(1, min(RBORMObject.filasPorSentenciaMaximas, limite / max(1, valoresPorFila)))
+    }
+
+    //Recorre los indices en grupos llenos; el resto que no llena una sentencia va fila a fila, asi
+    //solo hay dos textos SQL por clase. Si el grupo falla tambien se repite fila a fila
+    private mutating func porGrupos(_ indices: [Int], filas: Int, grupo: ([Int]) throws -> Bool, fila: (Int) throws -> Void) {
+        var inicio = 0
+        while inicio < indices.count {
+            let fin = min(inicio + filas, indices.count)
+            let seleccion = Array(indices[inicio..<fin])
+            inicio = fin
+            if seleccion.count == filas && filas > 1 && (try? conexion.conPuntoGuardado { try grupo(seleccion) }) == true {
+                continue
+            }
+            for indice in seleccion {
+                do {
+                    try conexion.conPuntoGuardado { try fila(indice) }
+                } catch {
+                    errores[indice] = error
+                }
+            }
+        }
+    }
+
+    mutating func insertar(_ indices: [Int]) throws {
+        guard !indices.isEmpty else {
+            return
+        }
+        let sentencias = self.sentencias
+        let conexion = self.conexion
+        let objetos = self.objetos
+        let tabla = SentenciasORM.identificador(sentencias.tabla)
+        let filas = sentencias.columnas.isEmpty ? 1 : filasPorSentencia(valoresPorFila: sentencias.columnas.count)
+        var claves = self.claves
+        porGrupos(indices, filas: filas, grupo: { grupo -> Bool in
+            //Con el cerrojo de escritura SQLite da a cada fila el rowid siguiente al mayor (o al de
+            //sqlite_sequence con AUTOINCREMENT), asi las del grupo quedan seguidas y la ultima es
+            //last_insert_rowid. Solo si el mayor ya es el maximo de Int64 los elige al azar
+            let maxima = try conexion.consultar("SELECT max(rowid) FROM \(tabla)").scalarValue as? NSNumber
+            guard (maxima?.int64Value ?? 0) < Int64.max else {
+                return false
+            }
+            try conexion.ejecutar(sentencias.insercionMultiple(filas: grupo.count), valores: grupo.flatMap { sentencias.valores(de: objetos[$0]) })
+            let ultima = conexion.ultimoRowid
+            for (posicion, indice) in grupo.enumerated() {
+                claves[indice] = ultima - Int64(grupo.count - 1 - posicion)
+            }
+            return true
+        }, fila: { indice in
+            try conexion.ejecutar(sentencias.insercion, valores: sentencias.valores(de: objetos[indice]))
+            claves[indice] = conexion.ultimoRowid
+        })
+        self.claves = claves
+    }
+
+    mutating func actualizar(_ indices: [Int]) throws {
+        guard !indices.isEmpty else {
+            return
+        }
+        let sentencias = self.sentencias
+        let conexion = self.conexion
+        let objetos = self.objetos
+        let claves = self.claves
+        let fila = { (indice: Int) -> [Any] in [NSNumber(value: claves[indice])] + sentencias.valores(de: objetos[indice]) }
+        guard SentenciasORM.admiteUpsert else {
+            //Sin ON CONFLICT: UPDATE y, si la fila ya no existe, INSERT con su clave como haria el upsert
+            porGrupos(indices, filas: 1, grupo: { _ in false }, fila: { indice in
+                guard !sentencias.columnas.isEmpty else {
+                    //Sin columnas no hay nada que actualizar, solo que la fila exista
+                    try conexion.ejecutar("INSERT OR IGNORE" + sentencias.insercionConClave.dropFirst("INSERT".count), valores: fila(indice))
+                    return
+                }
+                let valores = sentencias.valores(de: objetos[indice])
+                if try conexion.ejecutar(sentencias.actualizacion, valores: valores + [NSNumber(value: claves[indice])]) == 0 {
+                    try conexion.ejecutar(sentencias.insercionConClave, valores: fila(indice))
+                }
+            })
+            return
+        }
+        porGrupos(indices, filas: filasPorSentencia(valoresPorFila: sentencias.columnas.count + 1), grupo: { grupo -> Bool in
+            try conexion.ejecutar(sentencias.upsert(filas: grupo.count), valores: grupo.flatMap { fila($0) })
+            return true
+        }, fila: { indice in
+            try conexion.ejecutar(sentencias.upsert(filas: 1), valores: fila(indice))
+        })
+    }
+}
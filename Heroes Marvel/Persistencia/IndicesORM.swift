@@ -0,0 +1,143 @@
+//
+//  IndicesORM.swift
+//  Heroes Marvel
+//
+//  Created by Borja Gil Herrero on 19/10/2026.
+//  Copyright © 2026 Alsis GHE. All rights reserved.
+//
+
+import Foundation
+import SQLite3
+import Redbeard
+
+//Indice de una tabla del ORM: de una o varias columnas, unico o no, y parcial si tiene condicion
+struct IndiceSQLite {
+
+    //Solo se tocan los indices con este prefijo, los demas de la tabla no son nuestros
+    static let prefijo = "orm_"
+
+    let columnas: [String]
+    let unico: Bool
+    //Expresion del WHERE de un indice parcial, por ejemplo "borrado = 0"
+    let condicion: String?
+    private let nombrePropio: String?
+
+    //Las columnas son nombres de columna de la tabla, no de propiedad. Dos indices de las mismas
+    //columnas necesitan nombre para distinguirse
+    init(_ columnas: [String], unico: Bool = false, donde condicion: String? = nil, nombre: String? = nil) {
+        self.columnas = columnas
+        self.unico = unico
+        self.condicion = condicion
+        nombrePropio = nombre
+    }
+
+    func nombre(en tabla: String) -> String {
+        return IndiceSQLite.prefijo + (nombrePropio ?? ([tabla] + columnas).joined(separator: "_"))
+    }
+
+    //Mismo texto que guarda SQLite en sqlite_master, asi se sabe si el indice ha cambiado
+    func creacion(en tabla: String) -> String {
+        var sql = "CREATE\(unico ? " UNIQUE" : "") INDEX \(SentenciasORM.identificador(nombre(en: tabla))) ON \(SentenciasORM.identificador(tabla)) (\(columnas.map { SentenciasORM.identificador($0) }.joined(separator: ", ")))"
+        if let condicion = condicion {
+            sql += " WHERE \(condicion)"
+        }
+        return sql
+    }
+}
+
+//Las subclases de RBORMObject que lo adoptan declaran sus indices. Se crean la primera vez que
+//la clase se guarda o se consulta en una ConexionSQLite y se rehacen si cambia su declaracion
+protocol IndicesORM {
+    static var indicesSQLite: [IndiceSQLite] { get }
+}
+
+extension ConexionSQLite {
+
+    //Crea, rehace o borra los indices declarados de la clase, una vez por conexion. Si la tabla
+    //todavia no existe no hace nada y lo vuelve a intentar la proxima vez. En una conexion de solo
+    //lectura tampoco: los crea el escritor del pool
+    func asegurarIndices(_ clase: RBORMObject.Type) {
+        guard !soloLectura, let declarados = clase as? IndicesORM.Type else {
+            return
+        }
+        conCerrojo { () -> Void in
+            guard !clasesIndexadas.contains(ObjectIdentifier(clase)) else {
+                return
+            }
+            do {
+                if try sincronizarIndices(declarados.indicesSQLite, tabla: clase.tableName()) {
+                    clasesIndexadas.insert(ObjectIdentifier(clase))
+                }
+            } catch {
+                NSLog("No se han podido crear los indices de \(clase.tableName()): \(error)")
+            }
+        }
+    }
+
+    //Deja en la tabla exactamente los indices con prefijo orm_ de la lista. Devuelve false si la
+    //tabla no existe
+    @discardableResult
+    func sincronizarIndices(_ indices: [IndiceSQLite], tabla: String) throws -> Bool {
+        let tablas = try consultar("SELECT count(*) FROM sqlite_master WHERE type = 'table' AND name = ?", valores: [tabla])
+        guard ((tablas.scalarValue as? NSNumber)?.intValue ?? 0) > 0 else {
+            return false
+        }
+        let existentes = try consultar("SELECT name, sql FROM sqlite_master WHERE type = 'index' AND tbl_name = ? AND sql IS NOT NULL", valores: [tabla])
+        var actuales = [String: String]()
+        for fila in 0..<existentes.rowCount {
+            if let nombre = existentes.value(at: 0, forRow: fila) as? String, nombre.hasPrefix(IndiceSQLite.prefijo) {
+                actuales[nombre] = existentes.value(at: 1, forRow: fila) as? String
+            }
+        }
+        try enTransaccion { () throws -> Void in
+            for indice in indices {
+                let nombre = indice.nombre(en: tabla)
+                let creacion = indice.creacion(en: tabla)
+                if let actual = actuales.removeValue(forKey: nombre) {
+                    if actual == creacion {
+                        continue
+                    }
+                    try ejecutarScript("DROP INDEX \(SentenciasORM.identificador(nombre))")
+                }
+                try ejecutarScript(creacion)
+            }
+            //Indices que ya no se declaran
+            for nombre in actuales.keys {
+                try ejecutarScript("DROP INDEX \(SentenciasORM.identificador(nombre))")
+            }
+        }
+        return true
+    }
+
+    // MARK: - Plan de consulta
+
+    //Pasos del plan de la consulta segun EXPLAIN QUERY PLAN, por ejemplo
+    //"SEARCH TABLE heroe USING INDEX orm_heroe_nombre (nombre=?)"
+    func planConsulta(_ sql: String, valores: [Any] = []) throws -> [String] {
+        let plan = try consultar("EXPLAIN QUERY PLAN " + sql, valores: valores)
+        let columna = plan.columnIndex(forName: "detail")
+        return (0..<plan.rowCount).compactMap { plan.value(at: columna, forRow: $0) as? String }
+    }
+
+    //Pasos del plan que recorren una tabla o un indice entero en lugar de buscar en el
+    func recorridosCompletos(_ sql: String, valores: [Any] = []) throws -> [String] {
+        return try planConsulta(sql, valores: valores).filter { $0.hasPrefix("SCAN") }
+    }
+
+    //En depuracion avisa por consola de las consultas que recorren tablas enteras, una vez por
+    //texto SQL. En release no hace nada
+    func comprobarPlan(_ sql: String, valores: [Any] = []) {
+        #if DEBUG
+        ConexionSQLite.cerrojoPlanes.lock()
+        let nueva = ConexionSQLite.planesComprobados.insert(sql).inserted
+        ConexionSQLite.cerrojoPlanes.unlock()
+        guard nueva, let recorridos = try? recorridosCompletos(sql, valores: valores), !recorridos.isEmpty else {
+            return
+        }
+        NSLog("%@", "Consulta sin indice: \(sql) -> \(recorridos.joined(separator: "; "))")
+        #endif
+    }
+
+    private static let cerrojoPlanes = NSLock()
+    private static var planesComprobados = Set<String>()
+}
@@ -0,0 +1,161 @@
+//
+//  PoolConexiones.swift
+//  Heroes Marvel
+//
+//  Created by Borja Gil Herrero on 19/10/2026.
+//  Copyright © 2026 Alsis GHE. All rights reserved.
+//
+
+import Foundation
+import SQLite3
+import Redbeard
+
+struct ConfiguracionPool {
+    //Conexiones de solo lectura: lecturas simultaneas como maximo
+    var lectores = 3
+    var capacidadCache = ConexionSQLite.capacidadCachePorDefecto
+    var vfs: String? = nil
+}
+
+//Una conexion de escritura y varias de lectura a la misma base de datos en modo WAL. En WAL los
+//lectores no esperan al escritor ni entre ellos: cada uno ve la base de datos como estaba al
+//empezar su transaccion, asi una importacion en segundo plano no frena las consultas de la UI.
+//Las escrituras siguen siendo de una en una, en la conexion de escritura
+final class PoolConexiones {
+
+    let ruta: String
+    let identificador: String
+    let escritor: ConexionSQLite
+
+    private let lectores: [ConexionSQLite]
+    private var libres: [ConexionSQLite]
+    private let cerrojo = NSLock()
+    private let disponibles: DispatchSemaphore
+
+    init(ruta: String, identificador: String = ConexionSQLite.identificadorPorDefecto, configuracion: ConfiguracionPool = ConfiguracionPool()) throws {
+        self.ruta = ruta
+        self.identificador = identificador
+        escritor = try ConexionSQLite(ruta: ruta, identificador: identificador, vfs: configuracion.vfs, capacidadCache: configuracion.capacidadCache)
+        //El modo WAL queda guardado en el fichero; hay que ponerlo antes de abrir los lectores.
+        //Con WAL basta synchronous NORMAL: un corte de luz puede perder la ultima transaccion pero
+        //no corrompe la base de datos
+        try escritor.ejecutarScript("PRAGMA journal_mode = WAL; PRAGMA synchronous = NORMAL")
+
+        var lectores = [ConexionSQLite]()
+        for _ in 0..<max(1, configuracion.lectores) {
+            lectores.append(try ConexionSQLite(ruta: ruta, identificador: identificador, flags: SQLITE_OPEN_READONLY,
+                                               vfs: configuracion.vfs, capacidadCache: configuracion.capacidadCache))
+        }
+        self.lectores = lectores
+        libres = lectores
+        disponibles = DispatchSemaphore(value: lectores.count)
+    }
+
+    //Abre el mismo fichero que una conexion de Redbeard
+    convenience init(conexion: RBSQLiteConnection, identificador: String = ConexionSQLite.identificadorPorDefecto, configuracion: ConfiguracionPool = ConfiguracionPool()) throws {
+        try self.init(ruta: conexion.dataFilePath, identificador: identificador, configuracion: configuracion)
+    }
+
+    var numeroLectores: Int {
+        return lectores.count
+    }
+
+    // MARK: - Acceso
+
+    //Ejecuta el bloque con un lector dentro de una transaccion de lectura: todas las consultas del
+    //bloque ven la misma version de la base de datos aunque el escritor confirme cambios entre
+    //medias. Si todos los lectores estan ocupados espera a que se libere uno
+    func leer<T>(_ bloque: (ConexionSQLite) throws -> T) throws -> T {
+        disponibles.wait()
+        cerrojo.lock()
+        let lector = libres.removeLast()
+        cerrojo.unlock()
+        defer {
+            cerrojo.lock()
+            libres.append(lector)
+            cerrojo.unlock()
+            disponibles.signal()
+        }
+        //BEGIN sin IMMEDIATE: no toma el cerrojo de escritura, la instantanea empieza en la primera lectura
+        try lector.ejecutar("BEGIN")
+        do {
+            let resultado = try bloque(lector)
+            try lector.ejecutar("COMMIT")
+            return resultado
+        } catch {
+            _ = try? lector.ejecutar("ROLLBACK")
+            throw error
+        }
+    }
+
+    //Ejecuta el bloque en una transaccion de la conexion de escritura
+    @discardableResult
+    func escribir<T>(_ bloque: (ConexionSQLite) throws -> T) throws -> T {
+        return try escritor.enTransaccion {
+            try bloque(escritor)
+        }
+    }
+}
+
+extension RBORMCenter {
+
+    private static let cerrojoPools = NSLock()
+    private static var pools = [String: PoolConexiones]()
+
+    //Asocia un pool a un identificador de base de datos, como attachDatabaseConnection:withIdentifier:
+    //con una conexion. Las consultas de ese identificador que se lanzan con ejecutar() van al pool
+    func adjuntarPool(_ pool: PoolConexiones) {
+        RBORMCenter.cerrojoPools.lock()
+        RBORMCenter.pools[pool.identificador] = pool
+        RBORMCenter.cerrojoPools.unlock()
+    }
+
+    @discardableResult
+    func separarPool(identificador: String) -> PoolConexiones? {
+        RBORMCenter.cerrojoPools.lock()
+        defer { RBORMCenter.cerrojoPools.unlock() }
+        return RBORMCenter.pools.removeValue(forKey: identificador)
+    }
+
+    func pool(identificador: String) -> PoolConexiones? {
+        RBORMCenter.cerrojoPools.lock()
+        defer { RBORMCenter.cerrojoPools.unlock() }
+        return RBORMCenter.pools[identificador]
+    }
+}
+
+extension RBORMQuery {
+
+    //Las consultas van a un lector y las que modifican (isNonQuery) al escritor
+    func ejecutar(en pool: PoolConexiones) throws -> [Any] {
+        if isNonQuery {
+            return try pool.escribir { try ejecutar(en: $0) }
+        }
+        //Los lectores no pueden crear indices
+        if let clase = objectType as? RBORMObject.Type {
+            pool.escritor.asegurarIndices(clase)
+        }
+        return try pool.leer { try ejecutar(en: $0) }
+    }
+
+    //Como execute de Redbeard, pero si hay un pool adjunto al databaseIdentifer de la consulta la
+    //lleva a ese pool. Sin pool la ejecuta Redbeard con su conexion
+    func ejecutar() throws -> [Any] {
+        if let pool = RBORMCenter.shared().pool(identificador: databaseIdentifer) {
+            return try ejecutar(en: pool)
+        }
+        return execute() ?? []
+    }
+}
+
+extension RBORMObject {
+
+    func guardar(en pool: PoolConexiones) throws {
+        try pool.escribir { try guardar(en: $0) }
+    }
+
+    @discardableResult
+    class func guardar(_ objetos: [RBORMObject], en pool: PoolConexiones) throws -> ResultadoLoteORM {
+        return try guardar(objetos, en: pool.escritor)
+    }
+}
@@ -0,0 +1,210 @@
+//
+//  RBORMObject+ConexionSQLite.swift
+//  Heroes Marvel
+//
+//  Created by Borja Gil Herrero on 19/10/2026.
+//  Copyright © 2026 Alsis GHE. All rights reserved.
+//
+
+import Foundation
+import SQLite3
+import Redbeard
+
+//SQL de guardado de cada clase del ORM. Se genera una vez por clase y siempre con el mismo
+//texto, asi la cache de sentencias de la conexion lo reconoce en cada guardado
+final class SentenciasORM {
+
+    static let columnaClavePrimaria = "pk"
+    //INSERT ... ON CONFLICT DO UPDATE llega con SQLite 3.24 (iOS 12); antes se actualiza fila a fila
+    static let admiteUpsert = sqlite3_libversion_number() >= 3_024_000
+    //DELETE FROM de una tabla entera. SQLite lo hace truncando la tabla sin llamar al update hook
+    private static let borradoCompleto = try! NSRegularExpression(pattern: "^\\s*DELETE\\s+FROM\\s+(\"[^\"]*\"|\\[[^\\]]*\\]|`[^`]*`|[\\w.]+)\\s*;?\\s*$",
+                                                                  options: .caseInsensitive)
+    //Propiedades de RBORMObject que no son columnas
+    static let propiedadesInternas: Set<String> = ["pk", "hasPrimaryKey", "databaseIdentifier"]
+
+    let tabla: String
+    //Propiedad y columna de cada campo, sin la clave primaria, en un orden fijo
+    let columnas: [(propiedad: String, columna: String)]
+    let insercion: String
+    let actualizacion: String
+    //Insercion de una fila con su clave primaria, los valores van como en upsert(filas:)
+    let insercionConClave: String
+    //Partes de los INSERT de varias filas que usa el guardado por lotes
+    private let cabeceraInsercion: String
+    private let filaInsercion: String
+    private let cabeceraUpsert: String
+    private let filaUpsert: String
+    private let conflictoUpsert: String
+
+    private static let cerrojo = NSLock()
+    private static var porClase = [ObjectIdentifier: SentenciasORM]()
+
+    class func para(_ clase: RBORMObject.Type) -> SentenciasORM {
+        cerrojo.lock()
+        defer { cerrojo.unlock() }
+        if let existentes = porClase[ObjectIdentifier(clase)] {
+            return existentes
+        }
+        let nuevas = SentenciasORM(clase: clase)
+        porClase[ObjectIdentifier(clase)] = nuevas
+        return nuevas
+    }
+
+    private init(clase: RBORMObject.Type) {
+        tabla = clase.tableName()
+        CentroCambiosORM.shared.anotar(clase)
+        let nombresColumnas = clase.propertiesToColumnNames()
+        columnas = clase.propertySchemas().keys
+            .filter { !SentenciasORM.propiedadesInternas.contains($0) }
+            .sorted()
+            .map { (propiedad: $0, columna: nombresColumnas[$0] ?? $0) }
+
+        let lista = columnas.map { SentenciasORM.identificador($0.columna) }
+        let clave = SentenciasORM.identificador(SentenciasORM.columnaClavePrimaria)
+        cabeceraInsercion = "INSERT INTO \(SentenciasORM.identificador(tabla)) (\(lista.joined(separator: ", "))) VALUES "
+        filaInsercion = "(" + [String](repeating: "?", count: lista.count).joined(separator: ", ") + ")"
+        insercion = lista.isEmpty ? "INSERT INTO \(SentenciasORM.identificador(tabla)) DEFAULT VALUES" : cabeceraInsercion + filaInsercion
+        actualizacion = "UPDATE \(SentenciasORM.identificador(tabla)) SET \(lista.map { "\($0) = ?" }.joined(separator: ", ")) WHERE \(clave) = ?"
+
+        cabeceraUpsert = "INSERT INTO \(SentenciasORM.identificador(tabla)) (\(([clave] + lista).joined(separator: ", "))) VALUES "
+        filaUpsert = "(" + [String](repeating: "?", count: lista.count + 1).joined(separator: ", ") + ")"
+        insercionConClave = cabeceraUpsert + filaUpsert
+        if lista.isEmpty {
+            conflictoUpsert = " ON CONFLICT(\(clave)) DO NOTHING"
+        } else {
+            conflictoUpsert = " ON CONFLICT(\(clave)) DO UPDATE SET " + lista.map { "\($0) = excluded.\($0)" }.joined(separator: ", ")
+        }
+    }
+
+    //Inserta varias filas sin clave primaria, la pone SQLite. Los valores van por filas como los
+    //de valores(de:). Sin columnas no hay forma de poner varias filas: una con DEFAULT VALUES
+    func insercionMultiple(filas: Int) -> String {
+        guard !columnas.isEmpty, filas > 1 else {
+            return insercion
+        }
+        return cabeceraInsercion + [String](repeating: filaInsercion, count: filas).joined(separator: ", ")
+    }
+
+    //Inserta o actualiza varias filas por clave primaria. Solo si admiteUpsert
+    //Los valores van por filas: la clave primaria y despues los de valores(de:)
+    func upsert(filas: Int) -> String {
+        return cabeceraUpsert + [String](repeating: filaUpsert, count: filas).joined(separator: ", ") + conflictoUpsert
+    }
+
+    //Valores del objeto en el orden de columnas
+    func valores(de objeto: RBORMObject) -> [Any] {
+        return columnas.map { objeto.value(forKey: $0.propiedad) ?? NSNull() }
+    }
+
+    //Con WHERE 1 SQLite borra fila a fila y cada una llega a RegistroCambios, asi vaciar una tabla
+    //tambien avisa a los observadores de CentroCambiosORM. Sin observadores se deja tal cual: SQLite
+    //vacia la tabla de una vez, sin recorrerla
+    class func conBorradoPorFilas(_ sql: String) -> String {
+        let rango = NSRange(sql.startIndex..., in: sql)
+        guard CentroCambiosORM.shared.haySuscripciones, borradoCompleto.firstMatch(in: sql, options: [], range: rango) != nil else {
+            return sql
+        }
+        let sinFinal = sql.trimmingCharacters(in: CharacterSet.whitespacesAndNewlines.union(CharacterSet(charactersIn: ";")))
+        return sinFinal + " WHERE 1"
+    }
+
+    class func identificador(_ nombre: String) -> String {
+        return "\"" + nombre.replacingOccurrences(of: "\"", with: "\"\"") + "\""
+    }
+}
+
+extension RBORMObject {
+
+    //pk es readonly en la cabecera de Redbeard: su save lo escribe por KVC, que llega a la ivar si
+    //no hay setter. Si una version de Redbeard cambia eso setValue lanzaria una excepcion de
+    //Objective-C que Swift no puede capturar, por eso se comprueba antes de escribir nada
+    private static let claveAsignable: Bool = {
+        let clase: AnyClass = RBORMObject.self
+        if clase.instancesRespond(to: NSSelectorFromString("setPk:")) {
+            return true
+        }
+        return RBORMObject.accessInstanceVariablesDirectly
+            && (class_getInstanceVariable(clase, "_pk") != nil || class_getInstanceVariable(clase, "pk") != nil)
+    }()
+
+    class func comprobarClaveAsignable() throws {
+        guard claveAsignable else {
+            throw ErrorSQLite(codigo: SQLITE_MISUSE, mensaje: "Esta version de Redbeard no permite asignar pk")
+        }
+    }
+
+    //Unico sitio donde se escribe pk: despues de insertar la fila, con el rowid que le ha dado SQLite
+    func asignarClavePrimaria(_ clave: Int64) throws {
+        try RBORMObject.comprobarClaveAsignable()
+        setValue(NSNumber(value: clave), forKey: SentenciasORM.columnaClavePrimaria)
+        guard Int64(pk) == clave else {
+            throw ErrorSQLite(codigo: SQLITE_MISUSE, mensaje: "pk no ha cambiado al asignar \(clave)")
+        }
+    }
+
+    //Como save pero con las sentencias en cache de la conexion: despues del primer guardado de
+    //una clase cada insercion o actualizacion es vincular y ejecutar. Llama a los mismos
+    //willInsert/didInsert (o willUpdate/didUpdate) que save. Los observadores de RBORMCenter no se
+    //enteran: Redbeard no permite notificarles desde fuera. Los de CentroCambiosORM si, al confirmar
+    func guardar(en conexion: ConexionSQLite) throws {
+        let sentencias = SentenciasORM.para(type(of: self))
+        conexion.asegurarIndices(type(of: self))
+        if hasPrimaryKey {
+            willUpdate()
+            do {
+                try conexion.ejecutar(sentencias.actualizacion, valores: sentencias.valores(de: self) + [NSNumber(value: pk)])
+            } catch {
+                didUpdate(false)
+                throw error
+            }
+            didUpdate(true)
+        } else {
+            try RBORMObject.comprobarClaveAsignable()
+            willInsert()
+            do {
+                //La insercion y la lectura del rowid tienen que ir juntas bajo el cerrojo de la conexion
+                let rowid: Int64 = try conexion.conSentencia(sentencias.insercion, valores: sentencias.valores(de: self)) { sentencia in
+                    let resultado = sqlite3_step(sentencia)
+                    guard resultado == SQLITE_DONE else {
+                        throw ErrorSQLite(conexion: conexion.baseDatos, codigo: resultado, sql: sentencias.insercion)
+                    }
+                    return sqlite3_last_insert_rowid(conexion.baseDatos)
+                }
+                try asignarClavePrimaria(rowid)
+            } catch {
+                didInsert(false)
+                throw error
+            }
+            didInsert(true)
+        }
+    }
+}
+
+extension RBORMQuery {
+
+    //Ejecuta la consulta con la cache de sentencias de la conexion. Devuelve los objetos leidos,
+    //el valor escalar (count, sum...) como unico elemento o nada si no es una consulta
+    func ejecutar(en conexion: ConexionSQLite) throws -> [Any] {
+        if isNonQuery {
+            //Para que los borrados lleguen a CentroCambiosORM con su clase
+            if let clase = objectType as? RBORMObject.Type {
+                CentroCambiosORM.shared.anotar(clase)
+            }
+            try conexion.ejecutar(SentenciasORM.conBorradoPorFilas(queryString), valores: bindings ?? [])
+            return []
+        }
+        if let clase = objectType as? RBORMObject.Type {
+            conexion.asegurarIndices(clase)
+        }
+        conexion.comprobarPlan(queryString, valores: bindings ?? [])
+        let filas = try conexion.consultar(queryString, valores: bindings ?? [])
+        if isScalar {
+            return [filas.scalarValue ?? NSNull()]
+        }
+        guard let clase = objectType as? RBORMObject.Type else {
+            return []
+        }
+        return (0..<filas.rowCount).map { clase.populate(with: filas, atRow: $0, databaseIdentifier: conexion.identificador) }
+    }
+}
@@ -0,0 +1,331 @@
+//
+//  ResultadoColumnar.swift
+//  Heroes Marvel
+//
+//  Created by Borja Gil Herrero on 19/10/2026.
+//  Copyright © 2026 Alsis GHE. All rights reserved.
+//
+
+import Foundation
+import SQLite3
+import Redbeard
+
+//Celdas de una columna. El tipo es el de su primera celda no nula: los enteros y reales van en
+//arrays contiguos (las celdas nulas con un 0), los textos y blobs seguidos en el monton de la
+//columna con su inicio en desplazamientos, y los nulos en un mapa de bits
+private struct Columna {
+    var tipo = RBSQLiteFieldType.null
+    var enteros = [Int64]()
+    var reales = [Double]()
+    //Bytes de los textos o blobs de la columna, uno detras de otro. Cada columna tiene el suyo:
+    //con uno compartido los desplazamientos de una columna no marcarian donde empieza su celda
+    var monton = [UInt8]()
+    //Inicio de cada celda en el monton mas uno final, la celda i va de [i] a [i + 1]
+    var desplazamientos = [Int]()
+    var nulos = [UInt64]()
+    //Celdas de otro tipo que el de la columna (SQLite lo permite), ya como objeto
+    var otras = [Int: Any]()
+
+    func esNulo(_ fila: Int) -> Bool {
+        return nulos[fila >> 6] & (1 << UInt64(fila & 63)) != 0
+    }
+}
+
+private struct Constructor {
+    let nombres: [String]
+    var columnas: [Columna]
+    var filas = 0
+
+    init(nombres: [String]) {
+        self.nombres = nombres
+        columnas = [Columna](repeating: Columna(), count: nombres.count)
+    }
+
+    mutating func anadir(_ fila: FilaSQLite) {
+        if filas & 63 == 0 {
+            for indice in columnas.indices {
+                columnas[indice].nulos.append(0)
+            }
+        }
+        for indice in columnas.indices {
+            let tipo = fila.tipo(indice)
+            if tipo == .null {
+                columnas[indice].nulos[filas >> 6] |= 1 << UInt64(filas & 63)
+                rellenar(indice)
+                continue
+            }
+            if columnas[indice].tipo == .null {
+                fijarTipo(tipo, columna: indice)
+            }
+            guard tipo == columnas[indice].tipo else {
+                columnas[indice].otras[filas] = fila.valor(indice)
+                rellenar(indice)
+                continue
+            }
+            switch tipo {
+            case .integer:
+                columnas[indice].enteros.append(fila.int64(indice))
+            case .float:
+                columnas[indice].reales.append(fila.double(indice))
+            case .text:
+                columnas[indice].monton.append(contentsOf: fila.texto(indice))
+                columnas[indice].desplazamientos.append(columnas[indice].monton.count)
+            case .blob:
+                columnas[indice].monton.append(contentsOf: fila.blob(indice))
+                columnas[indice].desplazamientos.append(columnas[indice].monton.count)
+            default:
+                columnas[indice].otras[filas] = fila.valor(indice)
+            }
+        }
+        filas += 1
+    }
+
+    //Hueco de la fila actual para una celda nula o de otro tipo
+    private mutating func rellenar(_ indice: Int) {
+        switch columnas[indice].tipo {
+        case .integer:
+            columnas[indice].enteros.append(0)
+        case .float:
+            columnas[indice].reales.append(0)
+        case .text, .blob:
+            columnas[indice].desplazamientos.append(columnas[indice].monton.count)
+        default:
+            break
+        }
+    }
+
+    //Las filas anteriores eran todas nulas: se rellenan con huecos
+    private mutating func fijarTipo(_ tipo: RBSQLiteFieldType, columna indice: Int) {
+        columnas[indice].tipo = tipo
+        switch tipo {
+        case .integer:
+            columnas[indice].enteros = [Int64](repeating: 0, count: filas)
+        case .float:
+            columnas[indice].reales = [Double](repeating: 0, count: filas)
+        case .text, .blob:
+            columnas[indice].desplazamientos = [Int](repeating: 0, count: filas + 1)
+        default:
+            break
+        }
+    }
+}
+
+//Resultado completo guardado por columnas en lugar de un objeto por celda. Se puede usar como
+//cualquier RBSQLiteResultSet: fields, valueAtIndex:forRow: y los demas accesos crean los objetos
+//al pedirlos. Para sumar u ordenar columnas numericas mejor enteros()/reales(), que son arrays
+//sin objetos
+final class ResultadoColumnar: RBSQLiteResultSet {
+
+    private let columnas: [Columna]
+    let numeroFilas: Int
+
+    private lazy var camposEnCaja: [Any] = {
+        var campos = [Any]()
+        campos.reserveCapacity(self.numeroFilas * self.columnas.count)
+        for fila in 0..<self.numeroFilas {
+            for columna in self.columnas.indices {
+                campos.append(self.valor(columna, fila: fila))
+            }
+        }
+        return campos
+    }()
+
+    fileprivate init(_ constructor: Constructor) {
+        columnas = constructor.columnas
+        numeroFilas = constructor.filas
+        super.init(columnNames: constructor.nombres,
+                   columnTypes: constructor.columnas.map { NSNumber(value: $0.tipo.rawValue) },
+                   fieldValues: [])
+    }
+
+    // MARK: - Columnas
+
+    //Valores de una columna de enteros, con 0 en las filas nulas o de otro tipo. nil si la
+    //columna no es de enteros
+    func enteros(_ columna: Int) -> [Int64]? {
+        return columnas[columna].tipo == .integer ? columnas[columna].enteros : nil
+    }
+
+    func reales(_ columna: Int) -> [Double]? {
+        return columnas[columna].tipo == .float ? columnas[columna].reales : nil
+    }
+
+    func esNulo(_ columna: Int, fila: Int) -> Bool {
+        return columnas[columna].esNulo(fila)
+    }
+
+    //Suma de una columna numerica sin contar los nulos
+    func suma(_ columna: Int) -> Double {
+        let datos = columnas[columna]
+        var total: Double = 0
+        switch datos.tipo {
+        case .integer:
+            for valor in datos.enteros {
+                total += Double(valor)
+            }
+        case .float:
+            for valor in datos.reales {
+                total += valor
+            }
+        default:
+            break
+        }
+        //Las celdas de otro tipo no estan en el array
+        for valor in datos.otras.values {
+            total += (valor as? NSNumber)?.doubleValue ?? 0
+        }
+        return total
+    }
+
+    //Indices de las filas ordenados por una columna numerica, con los nulos al final
+    func filasOrdenadas(por columna: Int, ascendente: Bool = true) -> [Int] {
+        let datos = columnas[columna]
+        var nulas = [Int]()
+        var filas = [Int]()
+        filas.reserveCapacity(numeroFilas)
+        for fila in 0..<numeroFilas {
+            if datos.esNulo(fila) {
+                nulas.append(fila)
+            } else {
+                filas.append(fila)
+            }
+        }
+        if datos.otras.isEmpty && datos.tipo == .integer {
+            let valores = datos.enteros
+            filas.sort { ascendente ? valores[$0] < valores[$1] : valores[$0] > valores[$1] }
+        } else if datos.otras.isEmpty && datos.tipo == .float {
+            let valores = datos.reales
+            filas.sort { ascendente ? valores[$0] < valores[$1] : valores[$0] > valores[$1] }
+        } else {
+            filas.sort { ascendente ? double(columna, fila: $0) < double(columna, fila: $1) : double(columna, fila: $0) > double(columna, fila: $1) }
+        }
+        return filas + nulas
+    }
+
+    // MARK: - Celdas
+
+    func int64(_ columna: Int, fila: Int) -> Int64 {
+        let datos = columnas[columna]
+        if !datos.otras.isEmpty, let otra = datos.otras[fila] {
+            return (otra as? NSNumber)?.int64Value ?? 0
+        }
+        switch datos.tipo {
+        case .integer:
+            return datos.enteros[fila]
+        case .float:
+            return Int64(datos.reales[fila])
+        default:
+            return 0
+        }
+    }
+
+    func double(_ columna: Int, fila: Int) -> Double {
+        let datos = columnas[columna]
+        if !datos.otras.isEmpty, let otra = datos.otras[fila] {
+            return (otra as? NSNumber)?.doubleValue ?? 0
+        }
+        switch datos.tipo {
+        case .integer:
+            return Double(datos.enteros[fila])
+        case .float:
+            return datos.reales[fila]
+        default:
+            return 0
+        }
+    }
+
+    //Bytes del texto o blob en el monton de la columna, prestados solo durante el bloque
+    func conBytes<T>(_ columna: Int, fila: Int, _ bloque: (UnsafeBufferPointer<UInt8>) throws -> T) rethrows -> T {
+        let datos = columnas[columna]
+        guard datos.tipo == .text || datos.tipo == .blob else {
+            return try bloque(UnsafeBufferPointer(start: nil, count: 0))
+        }
+        let inicio = datos.desplazamientos[fila]
+        let fin = datos.desplazamientos[fila + 1]
+        return try datos.monton.withUnsafeBufferPointer { try bloque(UnsafeBufferPointer(rebasing: $0[inicio..<fin])) }
+    }
+
+    func cadena(_ columna: Int, fila: Int) -> String? {
+        let datos = columnas[columna]
+        if datos.esNulo(fila) {
+            return nil
+        }
+        if !datos.otras.isEmpty, let otra = datos.otras[fila] {
+            return "\(otra)"
+        }
+        return conBytes(columna, fila: fila) { String(decoding: $0, as: UTF8.self) }
+    }
+
+    //La celda como objeto, igual que en los fields de un RBSQLiteResultSet
+    func valor(_ columna: Int, fila: Int) -> Any {
+        let datos = columnas[columna]
+        if datos.esNulo(fila) {
+            return NSNull()
+        }
+        if !datos.otras.isEmpty, let otra = datos.otras[fila] {
+            return otra
+        }
+        switch datos.tipo {
+        case .integer:
+            return NSNumber(value: datos.enteros[fila])
+        case .float:
+            return NSNumber(value: datos.reales[fila])
+        case .text:
+            return conBytes(columna, fila: fila) { String(decoding: $0, as: UTF8.self) }
+        case .blob:
+            return conBytes(columna, fila: fila) { Data($0) }
+        default:
+            return NSNull()
+        }
+    }
+
+    // MARK: - RBSQLiteResultSet
+
+    override var hasResults: Bool {
+        return numeroFilas > 0
+    }
+
+    override var rowCount: Int {
+        return numeroFilas
+    }
+
+    override var fields: [Any] {
+        return camposEnCaja
+    }
+
+    override var scalarValue: Any? {
+        return numeroFilas > 0 && !columnas.isEmpty ? valor(0, fila: 0) : nil
+    }
+
+    override func value(at index: Int, forRow row: Int) -> Any {
+        return valor(index, fila: row)
+    }
+
+    override func value(forColumnName columnName: String, forRow row: Int) -> Any {
+        return valor(columnIndex(forName: columnName), fila: row)
+    }
+
+    override func values(atRow row: Int) -> [Any] {
+        return columnas.indices.map { valor($0, fila: row) }
+    }
+}
+
+extension ConexionSQLite {
+
+    //Como consultar() pero guardando el resultado por columnas
+    func consultarColumnas(_ sql: String, valores: [Any] = []) throws -> ResultadoColumnar {
+        return try conSentencia(sql, valores: valores) { sentencia in
+            let fila = FilaSQLite(sentencia: sentencia)
+            var constructor = Constructor(nombres: (0..<fila.numeroColumnas).map { fila.nombre($0) })
+            var resultado = sqlite3_step(sentencia)
+            while resultado == SQLITE_ROW {
+                constructor.anadir(fila)
+                resultado = sqlite3_step(sentencia)
+            }
+            guard resultado == SQLITE_DONE else {
+                throw ErrorSQLite(conexion: baseDatos, codigo: resultado, sql: sql)
+            }
+            return ResultadoColumnar(constructor)
+        }
+    }
+}
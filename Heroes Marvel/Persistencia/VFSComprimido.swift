@@ -0,0 +1,649 @@
+//
+//  VFSComprimido.swift
+//  Heroes Marvel
+//
+//  Created by Borja Gil Herrero on 19/10/2026.
+//  Copyright © 2026 Alsis GHE. All rights reserved.
+//
+
+import Foundation
+import SQLite3
+import Compression
+
+//Bloques comprimidos y leidos por el VFS, acumulados, o los de una estimacion con estimar()
+struct EstadisticasCompresion {
+    var bloquesEscritos: Int64 = 0
+    var bytesSinComprimir: Int64 = 0
+    var bytesComprimidos: Int64 = 0
+    //Bloques que no se reducian y se han guardado tal cual
+    var bloquesSinReducir: Int64 = 0
+    var bloquesDescomprimidos: Int64 = 0
+    var aciertosCache: Int64 = 0
+    var nanosegundosCompresion: Int64 = 0
+    var nanosegundosDescompresion: Int64 = 0
+
+    //Cuantas veces mas pequeño queda lo escrito
+    var ratio: Double {
+        return bytesComprimidos > 0 ? Double(bytesSinComprimir) / Double(bytesComprimidos) : 0
+    }
+
+    var microsegundosPorBloqueEscrito: Double {
+        return bloquesEscritos > 0 ? Double(nanosegundosCompresion) / Double(bloquesEscritos) / 1000 : 0
+    }
+
+    var microsegundosPorBloqueLeido: Double {
+        return bloquesDescomprimidos > 0 ? Double(nanosegundosDescompresion) / Double(bloquesDescomprimidos) / 1000 : 0
+    }
+}
+
+//Donde esta un bloque en el fichero. Longitud 0 es un bloque que nunca se ha escrito (ceros) y
+//longitud igual a tamanoBloque uno guardado sin comprimir
+private struct Entrada {
+    var offset: UInt64 = 0
+    var longitud: UInt32 = 0
+    var capacidad: UInt32 = 0
+}
+
+//Un fichero principal abierto con el VFS. El fichero real tiene una cabecera en el primer bloque,
+//los bloques comprimidos donde haya sitio y el mapa de bloques (offset, longitud y capacidad de
+//cada uno). El mapa se escribe en un sitio nuevo en cada xSync y despues la cabecera apunta a el:
+//hasta entonces el mapa anterior sigue siendo valido, asi que un bloque que el no conoce no puede
+//escribirse encima. La primera escritura de cada bloque despues de guardar el mapa va a un sitio
+//nuevo aunque quepa en el suyo, y el sitio viejo no se reutiliza hasta guardar el mapa otra vez.
+//Si SQLite reproduce un diario caliente lee los bloques segun el mapa anterior y los encuentra
+//intactos. Sin xSync (PRAGMA synchronous=OFF) el mapa se guarda al soltar el cerrojo y al cerrar.
+//SQLite no usa el mismo fichero desde dos hilos a la vez, asi que no necesita cerrojo
+private final class ArchivoComprimido {
+
+    static let tamanoBloque = 4096
+    //Los huecos se reservan en multiplos de esto, para que un bloque que crece un poco quepa en su sitio
+    static let granulo = 512
+    static let bloquesEnCache = 64
+    //"HMCZ"
+    static let magia: UInt32 = 0x5A43_4D48
+    static let version: UInt32 = 1
+    static let tamanoCabecera = 56
+    static let tamanoEntrada = 16
+
+    let interno: UnsafeMutablePointer<sqlite3_file>
+    var tamanoLogico: Int64 = 0
+    private var entradas = [Entrada]()
+    private var mapa = Entrada()
+    private var finFichero = UInt64(ArchivoComprimido.tamanoBloque)
+    private var generacion: UInt64 = 0
+    private var libres = [UInt32: [UInt64]]()
+    private var porLiberar = [Entrada]()
+    //Bloques que ya estan en un sitio que el mapa guardado no conoce: se pueden escribir en su sitio
+    private var movidos = Set<Int>()
+    private var modificado = false
+
+    private var cache = [Int: [UInt8]]()
+    private var usos = [Int: UInt64]()
+    private var reloj: UInt64 = 0
+
+    private let comprimido = UnsafeMutablePointer<UInt8>.allocate(capacity: ArchivoComprimido.tamanoBloque)
+    private let memoriaCodificar = UnsafeMutableRawPointer.allocate(byteCount: max(1, compression_encode_scratch_buffer_size(COMPRESSION_LZ4)), alignment: 16)
+    private let memoriaDecodificar = UnsafeMutableRawPointer.allocate(byteCount: max(1, compression_decode_scratch_buffer_size(COMPRESSION_LZ4)), alignment: 16)
+
+    init(interno: UnsafeMutablePointer<sqlite3_file>) {
+        self.interno = interno
+    }
+
+    deinit {
+        comprimido.deallocate()
+        memoriaCodificar.deallocate()
+        memoriaDecodificar.deallocate()
+    }
+
+    // MARK: - Apertura
+
+    //Un fichero vacio se convierte en uno comprimido; uno que ya tiene datos tiene que serlo
+    func abrir(soloLectura: Bool) -> Int32 {
+        var tamano: sqlite3_int64 = 0
+        let resultado = interno.pointee.pMethods.pointee.xFileSize!(interno, &tamano)
+        guard resultado == SQLITE_OK else {
+            return resultado
+        }
+        if tamano == 0 {
+            return soloLectura ? SQLITE_OK : escribirCabecera()
+        }
+        return cargar(forzar: true)
+    }
+
+    //Vuelve a leer el mapa si otra conexion ha sincronizado cambios. Se llama al empezar cada
+    //transaccion de lectura
+    func recargarSiHaCambiado() {
+        guard !modificado else {
+            return
+        }
+        _ = cargar(forzar: false)
+    }
+
+    private func cargar(forzar: Bool) -> Int32 {
+        var cabecera = [UInt8](repeating: 0, count: ArchivoComprimido.tamanoCabecera)
+        var resultado = cabecera.withUnsafeMutableBytes { leerReal($0.baseAddress!, ArchivoComprimido.tamanoCabecera, 0) }
+        if resultado == SQLITE_IOERR_SHORT_READ && cabecera.allSatisfy({ $0 == 0 }) {
+            //Creado por otra conexion que aun no ha escrito la cabecera
+            return SQLITE_OK
+        }
+        guard resultado == SQLITE_OK else {
+            return resultado
+        }
+        let campos = cabecera.withUnsafeBytes { bytes -> (UInt32, UInt32, Int64, Entrada, UInt64, UInt64) in
+            let mapa = Entrada(offset: UInt64(littleEndian: bytes.load(fromByteOffset: 24, as: UInt64.self)),
+                               longitud: UInt32(littleEndian: bytes.load(fromByteOffset: 32, as: UInt32.self)),
+                               capacidad: UInt32(littleEndian: bytes.load(fromByteOffset: 36, as: UInt32.self)))
+            return (UInt32(littleEndian: bytes.load(fromByteOffset: 0, as: UInt32.self)),
+                    UInt32(littleEndian: bytes.load(fromByteOffset: 8, as: UInt32.self)),
+                    Int64(littleEndian: bytes.load(fromByteOffset: 16, as: Int64.self)),
+                    mapa,
+                    UInt64(littleEndian: bytes.load(fromByteOffset: 40, as: UInt64.self)),
+                    UInt64(littleEndian: bytes.load(fromByteOffset: 48, as: UInt64.self)))
+        }
+        guard campos.0 == ArchivoComprimido.magia, campos.1 == UInt32(ArchivoComprimido.tamanoBloque) else {
+            return SQLITE_NOTADB
+        }
+        guard forzar || campos.4 != generacion else {
+            return SQLITE_OK
+        }
+
+        var bytesMapa = [UInt8](repeating: 0, count: Int(campos.3.longitud))
+        if !bytesMapa.isEmpty {
+            resultado = bytesMapa.withUnsafeMutableBytes { leerReal($0.baseAddress!, Int(campos.3.longitud), campos.3.offset) }
+            guard resultado == SQLITE_OK else {
+                return resultado
+            }
+        }
+        entradas = bytesMapa.withUnsafeBytes { bytes in
+            (0..<(bytes.count / ArchivoComprimido.tamanoEntrada)).map { indice -> Entrada in
+                let base = indice * ArchivoComprimido.tamanoEntrada
+                return Entrada(offset: UInt64(littleEndian: bytes.load(fromByteOffset: base, as: UInt64.self)),
+                               longitud: UInt32(littleEndian: bytes.load(fromByteOffset: base + 8, as: UInt32.self)),
+                               capacidad: UInt32(littleEndian: bytes.load(fromByteOffset: base + 12, as: UInt32.self)))
+            }
+        }
+        tamanoLogico = campos.2
+        mapa = campos.3
+        generacion = campos.4
+        finFichero = campos.5
+        porLiberar.removeAll()
+        movidos.removeAll()
+        reconstruirLibres()
+        cache.removeAll()
+        usos.removeAll()
+        return SQLITE_OK
+    }
+
+    //Los huecos entre bloques ocupados segun el mapa
+    private func reconstruirLibres() {
+        var ocupados = entradas.filter { $0.capacidad > 0 }
+        if mapa.capacidad > 0 {
+            ocupados.append(mapa)
+        }
+        ocupados.sort { $0.offset < $1.offset }
+        libres.removeAll()
+        var cursor = UInt64(ArchivoComprimido.tamanoBloque)
+        for entrada in ocupados {
+            if entrada.offset > cursor {
+                anadirHueco(cursor, longitud: entrada.offset - cursor)
+            }
+            cursor = max(cursor, entrada.offset + UInt64(entrada.capacidad))
+        }
+        if finFichero > cursor {
+            anadirHueco(cursor, longitud: finFichero - cursor)
+        }
+    }
+
+    // MARK: - Sitio en el fichero
+
+    private func anadirHueco(_ inicio: UInt64, longitud: UInt64) {
+        let granulo = UInt64(ArchivoComprimido.granulo)
+        var offset = inicio
+        var resto = longitud
+        while resto >= granulo {
+            let trozo = min(resto, UInt64(ArchivoComprimido.tamanoBloque)) / granulo * granulo
+            libres[UInt32(trozo), default: []].append(offset)
+            offset += trozo
+            resto -= trozo
+        }
+    }
+
+    //El hueco libre mas ajustado o, si no hay, al final del fichero
+    private func reservar(_ capacidad: UInt32) -> UInt64 {
+        var tamano = capacidad
+        while tamano <= UInt32(ArchivoComprimido.tamanoBloque) {
+            if let offset = libres[tamano]?.popLast() {
+                if tamano > capacidad {
+                    anadirHueco(offset + UInt64(capacidad), longitud: UInt64(tamano - capacidad))
+                }
+                return offset
+            }
+            tamano += UInt32(ArchivoComprimido.granulo)
+        }
+        let offset = finFichero
+        finFichero += UInt64(capacidad)
+        return offset
+    }
+
+    private class func redondear(_ longitud: Int) -> UInt32 {
+        return UInt32((max(longitud, 1) + granulo - 1) / granulo * granulo)
+    }
+
+    // MARK: - Bloques
+
+    private func bloque(_ indice: Int) -> [UInt8]? {
+        reloj += 1
+        if let datos = cache[indice] {
+            usos[indice] = reloj
+            VFSComprimido.shared.contar(.aciertosCache)
+            return datos
+        }
+        let tamanoBloque = ArchivoComprimido.tamanoBloque
+        var datos = [UInt8](repeating: 0, count: tamanoBloque)
+        if indice < entradas.count && entradas[indice].longitud > 0 {
+            let entrada = entradas[indice]
+            if Int(entrada.longitud) == tamanoBloque {
+                guard datos.withUnsafeMutableBytes({ leerReal($0.baseAddress!, tamanoBloque, entrada.offset) }) == SQLITE_OK else {
+                    return nil
+                }
+            } else {
+                guard leerReal(comprimido, Int(entrada.longitud), entrada.offset) == SQLITE_OK else {
+                    return nil
+                }
+                let inicio = DispatchTime.now().uptimeNanoseconds
+                let obtenidos = datos.withUnsafeMutableBufferPointer {
+                    compression_decode_buffer($0.baseAddress!, tamanoBloque, comprimido, Int(entrada.longitud), memoriaDecodificar, COMPRESSION_LZ4)
+                }
+                VFSComprimido.shared.contar(.nanosegundosDescompresion, Int64(DispatchTime.now().uptimeNanoseconds - inicio))
+                VFSComprimido.shared.contar(.bloquesDescomprimidos)
+                guard obtenidos == tamanoBloque else {
+                    return nil
+                }
+            }
+        }
+        guardarEnCache(indice, datos)
+        return datos
+    }
+
+    private func guardarEnCache(_ indice: Int, _ datos: [UInt8]) {
+        if cache[indice] == nil && cache.count >= ArchivoComprimido.bloquesEnCache,
+            let menosUsado = usos.min(by: { $0.value < $1.value })?.key {
+            cache[menosUsado] = nil
+            usos[menosUsado] = nil
+        }
+        cache[indice] = datos
+        usos[indice] = reloj
+    }
+
+    private func escribirBloque(_ indice: Int, _ datos: [UInt8]) -> Int32 {
+        let tamanoBloque = ArchivoComprimido.tamanoBloque
+        let inicio = DispatchTime.now().uptimeNanoseconds
+        //Si no ahorra al menos un granulo no merece la pena: se guarda tal cual
+        let longitudComprimida = datos.withUnsafeBufferPointer {
+            compression_encode_buffer(comprimido, tamanoBloque - ArchivoComprimido.granulo, $0.baseAddress!, tamanoBloque, memoriaCodificar, COMPRESSION_LZ4)
+        }
+        VFSComprimido.shared.contar(.nanosegundosCompresion, Int64(DispatchTime.now().uptimeNanoseconds - inicio))
+        let crudo = longitudComprimida == 0
+        let longitud = crudo ? tamanoBloque : longitudComprimida
+        let capacidad = crudo ? UInt32(tamanoBloque) : ArchivoComprimido.redondear(longitud)
+
+        while entradas.count <= indice {
+            entradas.append(Entrada())
+        }
+        var entrada = entradas[indice]
+        //Se mueve si el mapa guardado apunta a su sitio o si no cabe en el
+        if !movidos.contains(indice) || entrada.capacidad < UInt32(longitud) {
+            liberar(indice, entrada)
+            entrada = Entrada(offset: reservar(capacidad), longitud: 0, capacidad: capacidad)
+        }
+        entrada.longitud = UInt32(longitud)
+        let resultado = crudo
+            ? datos.withUnsafeBytes { escribirReal($0.baseAddress!, tamanoBloque, entrada.offset) }
+            : escribirReal(comprimido, longitud, entrada.offset)
+        guard resultado == SQLITE_OK else {
+            return resultado
+        }
+        entradas[indice] = entrada
+        movidos.insert(indice)
+        modificado = true
+        guardarEnCache(indice, datos)
+
+        let vfs = VFSComprimido.shared
+        vfs.contar(.bloquesEscritos)
+        vfs.contar(.bytesSinComprimir, Int64(tamanoBloque))
+        vfs.contar(.bytesComprimidos, Int64(longitud))
+        if crudo {
+            vfs.contar(.bloquesSinReducir)
+        }
+        return SQLITE_OK
+    }
+
+    //El sitio que deja un bloque: si lo conoce el mapa guardado espera a que se guarde el nuevo
+    private func liberar(_ indice: Int, _ entrada: Entrada) {
+        guard entrada.capacidad > 0 else {
+            return
+        }
+        if movidos.contains(indice) {
+            anadirHueco(entrada.offset, longitud: UInt64(entrada.capacidad))
+        } else {
+            porLiberar.append(entrada)
+        }
+    }
+
+    // MARK: - Operaciones de SQLite
+
+    func leer(_ destino: UnsafeMutableRawPointer, _ cantidad: Int, _ desplazamiento: Int64) -> Int32 {
+        let tamanoBloque = ArchivoComprimido.tamanoBloque
+        let disponible = Int(max(0, min(Int64(cantidad), tamanoLogico - desplazamiento)))
+        var hecho = 0
+        while hecho < disponible {
+            let posicion = desplazamiento + Int64(hecho)
+            let dentro = Int(posicion % Int64(tamanoBloque))
+            let parte = min(tamanoBloque - dentro, disponible - hecho)
+            guard let datos = bloque(Int(posicion / Int64(tamanoBloque))) else {
+                return SQLITE_IOERR_READ
+            }
+            datos.withUnsafeBytes { _ = memcpy(destino + hecho, $0.baseAddress! + dentro, parte) }
+            hecho += parte
+        }
+        //Lo que pasa del final se rellena con ceros y se avisa, como el VFS de por defecto
+        if disponible < cantidad {
+            memset(destino + disponible, 0, cantidad - disponible)
+            return SQLITE_IOERR_SHORT_READ
+        }
+        return SQLITE_OK
+    }
+
+    func escribir(_ origen: UnsafeRawPointer, _ cantidad: Int, _ desplazamiento: Int64) -> Int32 {
+        let tamanoBloque = ArchivoComprimido.tamanoBloque
+        var hecho = 0
+        while hecho < cantidad {
+            let posicion = desplazamiento + Int64(hecho)
+            let indice = Int(posicion / Int64(tamanoBloque))
+            let dentro = Int(posicion % Int64(tamanoBloque))
+            let parte = min(tamanoBloque - dentro, cantidad - hecho)
+            var datos: [UInt8]
+            if parte == tamanoBloque {
+                datos = [UInt8](UnsafeRawBufferPointer(start: origen + hecho, count: tamanoBloque))
+            } else {
+                //Escritura de una parte del bloque: se lee, se cambia y se vuelve a comprimir entero
+                guard let actual = bloque(indice) else {
+                    return SQLITE_IOERR_READ
+                }
+                datos = actual
+                datos.withUnsafeMutableBytes { _ = memcpy($0.baseAddress! + dentro, origen + hecho, parte) }
+            }
+            let resultado = escribirBloque(indice, datos)
+            guard resultado == SQLITE_OK else {
+                return resultado
+            }
+            hecho += parte
+        }
+        tamanoLogico = max(tamanoLogico, desplazamiento + Int64(cantidad))
+        modificado = true
+        return SQLITE_OK
+    }
+
+    func truncar(_ tamano: Int64) -> Int32 {
+        let bloques = Int((tamano + Int64(ArchivoComprimido.tamanoBloque) - 1) / Int64(ArchivoComprimido.tamanoBloque))
+        while entradas.count > bloques {
+            let entrada = entradas.removeLast()
+            liberar(entradas.count, entrada)
+            movidos.remove(entradas.count)
+            cache[entradas.count] = nil
+            usos[entradas.count] = nil
+        }
+        tamanoLogico = tamano
+        modificado = true
+        return SQLITE_OK
+    }
+
+    func sincronizar(_ flags: Int32) -> Int32 {
+        return guardarMapa(sincronizando: flags)
+    }
+
+    //Al soltar el cerrojo de escritura y al cerrar. Con xSync no queda nada; sin el (synchronous=OFF)
+    //es la unica forma de que los cambios lleguen a otras conexiones y no se pierdan al cerrar
+    func guardarSinSincronizar() -> Int32 {
+        return modificado ? guardarMapa(sincronizando: nil) : SQLITE_OK
+    }
+
+    //Escribe el mapa en un sitio nuevo, sincroniza, apunta la cabecera a el y vuelve a sincronizar.
+    //Solo entonces se pueden reutilizar los sitios que han quedado libres. Sin flags no se sincroniza
+    private func guardarMapa(sincronizando flags: Int32?) -> Int32 {
+        let sincronizarReal = { () -> Int32 in
+            guard let flags = flags else {
+                return SQLITE_OK
+            }
+            return self.interno.pointee.pMethods.pointee.xSync!(self.interno, flags)
+        }
+        guard modificado else {
+            return sincronizarReal()
+        }
+        var bytesMapa = [UInt8](repeating: 0, count: entradas.count * ArchivoComprimido.tamanoEntrada)
+        bytesMapa.withUnsafeMutableBytes { bytes in
+            for (indice, entrada) in entradas.enumerated() {
+                let base = indice * ArchivoComprimido.tamanoEntrada
+                bytes.storeBytes(of: entrada.offset.littleEndian, toByteOffset: base, as: UInt64.self)
+                bytes.storeBytes(of: entrada.longitud.littleEndian, toByteOffset: base + 8, as: UInt32.self)
+                bytes.storeBytes(of: entrada.capacidad.littleEndian, toByteOffset: base + 12, as: UInt32.self)
+            }
+        }
+        let capacidad = ArchivoComprimido.redondear(bytesMapa.count)
+        let nuevo = Entrada(offset: reservar(capacidad), longitud: UInt32(bytesMapa.count), capacidad: capacidad)
+        if !bytesMapa.isEmpty {
+            let resultado = bytesMapa.withUnsafeBytes { escribirReal($0.baseAddress!, bytesMapa.count, nuevo.offset) }
+            guard resultado == SQLITE_OK else {
+                return resultado
+            }
+        }
+        var resultado = sincronizarReal()
+        guard resultado == SQLITE_OK else {
+            return resultado
+        }
+        if mapa.capacidad > 0 {
+            porLiberar.append(mapa)
+        }
+        mapa = nuevo
+        generacion += 1
+        resultado = escribirCabecera()
+        guard resultado == SQLITE_OK else {
+            return resultado
+        }
+        resultado = sincronizarReal()
+        guard resultado == SQLITE_OK else {
+            return resultado
+        }
+        for entrada in porLiberar {
+            anadirHueco(entrada.offset, longitud: UInt64(entrada.capacidad))
+        }
+        porLiberar.removeAll()
+        movidos.removeAll()
+        modificado = false
+        return SQLITE_OK
+    }
+
+    // MARK: - Fichero real
+
+    private func escribirCabecera() -> Int32 {
+        var cabecera = [UInt8](repeating: 0, count: ArchivoComprimido.tamanoCabecera)
+        cabecera.withUnsafeMutableBytes { bytes in
+            bytes.storeBytes(of: ArchivoComprimido.magia.littleEndian, toByteOffset: 0, as: UInt32.self)
+            bytes.storeBytes(of: ArchivoComprimido.version.littleEndian, toByteOffset: 4, as: UInt32.self)
+            bytes.storeBytes(of: UInt32(ArchivoComprimido.tamanoBloque).littleEndian, toByteOffset: 8, as: UInt32.self)
+            bytes.storeBytes(of: tamanoLogico.littleEndian, toByteOffset: 16, as: Int64.self)
+            bytes.storeBytes(of: mapa.offset.littleEndian, toByteOffset: 24, as: UInt64.self)
+            bytes.storeBytes(of: mapa.longitud.littleEndian, toByteOffset: 32, as: UInt32.self)
+            bytes.storeBytes(of: mapa.capacidad.littleEndian, toByteOffset: 36, as: UInt32.self)
+            bytes.storeBytes(of: generacion.littleEndian, toByteOffset: 40, as: UInt64.self)
+            bytes.storeBytes(of: finFichero.littleEndian, toByteOffset: 48, as: UInt64.self)
+        }
+        return cabecera.withUnsafeBytes { escribirReal($0.baseAddress!, ArchivoComprimido.tamanoCabecera, 0) }
+    }
+
+    private func leerReal(_ destino: UnsafeMutableRawPointer, _ cantidad: Int, _ offset: UInt64) -> Int32 {
+        return interno.pointee.pMethods.pointee.xRead!(interno, destino, Int32(cantidad), sqlite3_int64(offset))
+    }
+
+    private func escribirReal(_ origen: UnsafeRawPointer, _ cantidad: Int, _ offset: UInt64) -> Int32 {
+        return interno.pointee.pMethods.pointee.xWrite!(interno, origen, Int32(cantidad), sqlite3_int64(offset))
+    }
+}
+
+//VFS que guarda comprimido el fichero principal de la base de datos, en bloques de 4 KB con LZ4,
+//y descomprime al leer con una pequeña cache de bloques por fichero. Para bases de datos con
+//mucho JSON o blobs: el fichero ocupa menos en disco y se lee menos de la flash al abrirla.
+//Diarios, WAL y temporales van sin comprimir por el VFS de por defecto. Un fichero que no se ha
+//creado con este VFS no se puede abrir con el: hay que copiar los datos (por ejemplo con
+//populateDatabaseFromFile:withFlags:usingVFS: de RBSQLiteConnection).
+//estimar() dice cuanto se comprime una base de datos que ya existe y a que coste de CPU, para
+//decidir si merece la pena
+final class VFSComprimido: VFSEnvoltorio {
+
+    static let nombre = "comprimido"
+    static let shared = VFSComprimido()
+
+    fileprivate enum Contador: Int {
+        case bloquesEscritos, bytesSinComprimir, bytesComprimidos, bloquesSinReducir, bloquesDescomprimidos,
+            aciertosCache, nanosegundosCompresion, nanosegundosDescompresion
+        static let total = 8
+    }
+
+    private let contadores = TablaContadores(cantidad: Contador.total)
+
+    private init() {
+        //Hasta la version 2 (memoria compartida para WAL). Sin xFetch: las paginas no estan en el fichero tal cual
+        super.init(nombre: VFSComprimido.nombre, versionMaxima: 2)
+    }
+
+    // MARK: - Estadisticas
+
+    func estadisticas() -> EstadisticasCompresion {
+        let copia = contadores.leer()
+        let valor = { (contador: Contador) in copia[contador.rawValue] }
+        return EstadisticasCompresion(bloquesEscritos: valor(.bloquesEscritos), bytesSinComprimir: valor(.bytesSinComprimir),
+                                      bytesComprimidos: valor(.bytesComprimidos), bloquesSinReducir: valor(.bloquesSinReducir),
+                                      bloquesDescomprimidos: valor(.bloquesDescomprimidos), aciertosCache: valor(.aciertosCache),
+                                      nanosegundosCompresion: valor(.nanosegundosCompresion),
+                                      nanosegundosDescompresion: valor(.nanosegundosDescompresion))
+    }
+
+    fileprivate func contar(_ contador: Contador, _ cantidad: Int64 = 1) {
+        contadores.sumar(contador.rawValue, cantidad)
+    }
+
+    //Comprime y descomprime cada bloque de una base de datos normal sin cambiarla, para saber que
+    //ratio y que coste tendria con este VFS
+    class func estimar(ruta: String) throws -> EstadisticasCompresion {
+        let datos = try Data(contentsOf: URL(fileURLWithPath: ruta), options: .alwaysMapped)
+        let tamanoBloque = ArchivoComprimido.tamanoBloque
+        var estadisticas = EstadisticasCompresion()
+        let comprimido = UnsafeMutablePointer<UInt8>.allocate(capacity: tamanoBloque)
+        let descomprimido = UnsafeMutablePointer<UInt8>.allocate(capacity: tamanoBloque)
+        defer {
+            comprimido.deallocate()
+            descomprimido.deallocate()
+        }
+        var bloque = [UInt8](repeating: 0, count: tamanoBloque)
+        var inicio = 0
+        while inicio < datos.count {
+            let fin = min(inicio + tamanoBloque, datos.count)
+            //El ultimo bloque puede estar incompleto: el resto va con ceros
+            bloque.withUnsafeMutableBufferPointer { destino in
+                destino.baseAddress!.assign(repeating: 0, count: tamanoBloque)
+                _ = datos.copyBytes(to: destino, from: inicio..<fin)
+            }
+            let antes = DispatchTime.now().uptimeNanoseconds
+            let longitud = compression_encode_buffer(comprimido, tamanoBloque - ArchivoComprimido.granulo, bloque, tamanoBloque, nil, COMPRESSION_LZ4)
+            let medio = DispatchTime.now().uptimeNanoseconds
+            estadisticas.bloquesEscritos += 1
+            estadisticas.bytesSinComprimir += Int64(tamanoBloque)
+            estadisticas.nanosegundosCompresion += Int64(medio - antes)
+            if longitud == 0 {
+                estadisticas.bloquesSinReducir += 1
+                estadisticas.bytesComprimidos += Int64(tamanoBloque)
+            } else {
+                estadisticas.bytesComprimidos += Int64(longitud)
+                _ = compression_decode_buffer(descomprimido, tamanoBloque, comprimido, longitud, nil, COMPRESSION_LZ4)
+                estadisticas.bloquesDescomprimidos += 1
+                estadisticas.nanosegundosDescompresion += Int64(DispatchTime.now().uptimeNanoseconds - medio)
+            }
+            inicio = fin
+        }
+        return estadisticas
+    }
+
+    // MARK: - Ficheros
+
+    override func abrirPrincipal(_ archivo: UnsafeMutablePointer<sqlite3_file>, flags: Int32) -> Int32 {
+        let estado = ArchivoComprimido(interno: VFSComprimido.interno(archivo))
+        asignarEstado(estado, a: archivo)
+        return estado.abrir(soloLectura: flags & SQLITE_OPEN_READONLY != 0)
+    }
+
+    private class func estado(_ archivo: UnsafeMutablePointer<sqlite3_file>) -> ArchivoComprimido {
+        return estado(archivo, como: ArchivoComprimido.self)
+    }
+
+    override func cerrar(_ archivo: UnsafeMutablePointer<sqlite3_file>) -> Int32 {
+        return VFSComprimido.estado(archivo).guardarSinSincronizar()
+    }
+
+    //Otra conexion puede haber cambiado el mapa
+    override func empiezaLectura(_ archivo: UnsafeMutablePointer<sqlite3_file>) {
+        VFSComprimido.estado(archivo).recargarSiHaCambiado()
+    }
+
+    //Antes de que otra conexion pueda leer el mapa. En modo WAL el fichero solo se escribe en los
+    //checkpoint: se guarda antes de soltar su cerrojo de la memoria compartida
+    override func soltandoCerrojo(_ archivo: UnsafeMutablePointer<sqlite3_file>) -> Int32 {
+        return VFSComprimido.estado(archivo).guardarSinSincronizar()
+    }
+
+    override func leer(_ archivo: UnsafeMutablePointer<sqlite3_file>, _ buffer: UnsafeMutableRawPointer, _ cantidad: Int32,
+                       _ desplazamiento: sqlite3_int64) -> Int32 {
+        return VFSComprimido.estado(archivo).leer(buffer, Int(cantidad), desplazamiento)
+    }
+
+    override func escribir(_ archivo: UnsafeMutablePointer<sqlite3_file>, _ buffer: UnsafeRawPointer, _ cantidad: Int32,
+                           _ desplazamiento: sqlite3_int64) -> Int32 {
+        return VFSComprimido.estado(archivo).escribir(buffer, Int(cantidad), desplazamiento)
+    }
+
+    override func truncar(_ archivo: UnsafeMutablePointer<sqlite3_file>, _ tamano: sqlite3_int64) -> Int32 {
+        return VFSComprimido.estado(archivo).truncar(tamano)
+    }
+
+    override func sincronizar(_ archivo: UnsafeMutablePointer<sqlite3_file>, _ flags: Int32) -> Int32 {
+        return VFSComprimido.estado(archivo).sincronizar(flags)
+    }
+
+    override func tamano(_ archivo: UnsafeMutablePointer<sqlite3_file>, _ tamano: UnsafeMutablePointer<sqlite3_int64>) -> Int32 {
+        tamano.pointee = VFSComprimido.estado(archivo).tamanoLogico
+        return SQLITE_OK
+    }
+
+    override func controlar(_ archivo: UnsafeMutablePointer<sqlite3_file>, _ operacion: Int32, _ argumento: UnsafeMutableRawPointer?) -> Int32 {
+        switch operacion {
+        case SQLITE_FCNTL_SIZE_HINT, SQLITE_FCNTL_CHUNK_SIZE:
+            //Son del tamaño sin comprimir: reservar ese sitio en el fichero real no tiene sentido
+            return SQLITE_OK
+        case SQLITE_FCNTL_MMAP_SIZE:
+            //El fichero real no se puede mapear: sus bytes no son las paginas
+            argumento?.assumingMemoryBound(to: sqlite3_int64.self).pointee = 0
+            return SQLITE_OK
+        default:
+            return super.controlar(archivo, operacion, argumento)
+        }
+    }
+
+    //Cada escritura reescribe el bloque entero: el diario tiene que guardar todas sus paginas
+    override func tamanoSector(_ archivo: UnsafeMutablePointer<sqlite3_file>) -> Int32 {
+        return Int32(ArchivoComprimido.tamanoBloque)
+    }
+
+    //Ninguna garantia de escritura atomica ni segura: un bloque comprimido puede moverse
+    override func caracteristicas(_ archivo: UnsafeMutablePointer<sqlite3_file>) -> Int32 {
+        return 0
+    }
+}
@@ -0,0 +1,353 @@
+//
+//  VFSEnvoltorio.swift
+//  Heroes Marvel
+//
+//  Created by Borja Gil Herrero on 19/10/2026.
+//  Copyright © 2026 Alsis GHE. All rights reserved.
+//
+
+import Foundation
+import SQLite3
+
+//Contadores que suman los ficheros de un VFS desde cualquier hilo
+final class TablaContadores {
+
+    private let valores: UnsafeMutablePointer<Int64>
+    private let cantidad: Int
+    private let cerrojo: UnsafeMutablePointer<os_unfair_lock>
+
+    init(cantidad: Int) {
+        self.cantidad = cantidad
+        valores = UnsafeMutablePointer<Int64>.allocate(capacity: cantidad)
+        valores.initialize(repeating: 0, count: cantidad)
+        cerrojo = UnsafeMutablePointer<os_unfair_lock>.allocate(capacity: 1)
+        cerrojo.initialize(to: os_unfair_lock())
+    }
+
+    deinit {
+        valores.deallocate()
+        cerrojo.deallocate()
+    }
+
+    func sumar(_ indice: Int, _ valor: Int64 = 1) {
+        os_unfair_lock_lock(cerrojo)
+        valores[indice] += valor
+        os_unfair_lock_unlock(cerrojo)
+    }
+
+    func leer() -> [Int64] {
+        os_unfair_lock_lock(cerrojo)
+        defer { os_unfair_lock_unlock(cerrojo) }
+        return [Int64](UnsafeBufferPointer(start: valores, count: cantidad))
+    }
+}
+
+//Base de los VFS que envuelven al de por defecto y solo cambian el fichero principal de la base
+//de datos. Diarios, WAL y temporales los abre el VFS real en nuestro sitio, con sus metodos.
+//Cada sqlite3_file del principal lleva detras el envoltorio, el estado que le da la subclase en
+//abrirPrincipal y el fichero del VFS real. Las operaciones que no sobrescribe la subclase van
+//tal cual al fichero real
+class VFSEnvoltorio {
+
+    private static let desplazamientoEnvoltorio = MemoryLayout<sqlite3_file>.stride
+    private static let desplazamientoEstado = desplazamientoEnvoltorio + MemoryLayout<UnsafeMutableRawPointer>.stride
+    private static let desplazamientoInterno = desplazamientoEstado + MemoryLayout<UnsafeMutableRawPointer>.stride
+
+    let real: UnsafeMutablePointer<sqlite3_vfs>
+    private let vfs: UnsafeMutablePointer<sqlite3_vfs>
+    //Los metodos de fichero nunca pasan de esta version aunque el VFS real tenga una mayor
+    private let versionMaxima: Int32
+    private let cerrojo = NSLock()
+    private var metodos = [UnsafeRawPointer: UnsafeMutablePointer<sqlite3_io_methods>]()
+
+    init(nombre: String, versionMaxima: Int32) {
+        self.versionMaxima = versionMaxima
+        real = sqlite3_vfs_find(nil)
+        vfs = UnsafeMutablePointer<sqlite3_vfs>.allocate(capacity: 1)
+        vfs.initialize(to: sqlite3_vfs())
+        vfs.pointee.iVersion = 2
+        vfs.pointee.szOsFile = Int32(VFSEnvoltorio.desplazamientoInterno) + real.pointee.szOsFile
+        vfs.pointee.mxPathname = real.pointee.mxPathname
+        vfs.pointee.zName = UnsafePointer(strdup(nombre))
+        vfs.pointee.xOpen = { vfs, nombre, archivo, flags, flagsSalida in
+            return VFSEnvoltorio.envoltorio(de: vfs!).abrir(nombre, archivo!, flags, flagsSalida)
+        }
+        //El resto es del VFS real
+        vfs.pointee.xDelete = { vfs, nombre, sincronizar in
+            let real = VFSEnvoltorio.envoltorio(de: vfs!).real
+            return real.pointee.xDelete!(real, nombre, sincronizar)
+        }
+        vfs.pointee.xAccess = { vfs, nombre, flags, resultado in
+            let real = VFSEnvoltorio.envoltorio(de: vfs!).real
+            return real.pointee.xAccess!(real, nombre, flags, resultado)
+        }
+        vfs.pointee.xFullPathname = { vfs, nombre, tamano, salida in
+            let real = VFSEnvoltorio.envoltorio(de: vfs!).real
+            return real.pointee.xFullPathname!(real, nombre, tamano, salida)
+        }
+        vfs.pointee.xDlOpen = real.pointee.xDlOpen
+        vfs.pointee.xDlError = real.pointee.xDlError
+        vfs.pointee.xDlSym = real.pointee.xDlSym
+        vfs.pointee.xDlClose = real.pointee.xDlClose
+        vfs.pointee.xRandomness = { vfs, bytes, salida in
+            let real = VFSEnvoltorio.envoltorio(de: vfs!).real
+            return real.pointee.xRandomness!(real, bytes, salida)
+        }
+        vfs.pointee.xSleep = { vfs, microsegundos in
+            let real = VFSEnvoltorio.envoltorio(de: vfs!).real
+            return real.pointee.xSleep!(real, microsegundos)
+        }
+        vfs.pointee.xCurrentTime = { vfs, tiempo in
+            let real = VFSEnvoltorio.envoltorio(de: vfs!).real
+            return real.pointee.xCurrentTime!(real, tiempo)
+        }
+        vfs.pointee.xGetLastError = { vfs, tamano, salida in
+            let real = VFSEnvoltorio.envoltorio(de: vfs!).real
+            return real.pointee.xGetLastError!(real, tamano, salida)
+        }
+        vfs.pointee.xCurrentTimeInt64 = { vfs, tiempo in
+            let real = VFSEnvoltorio.envoltorio(de: vfs!).real
+            return real.pointee.xCurrentTimeInt64!(real, tiempo)
+        }
+        //Los VFS son singletons: no hace falta retenerlo
+        vfs.pointee.pAppData = Unmanaged.passUnretained(self).toOpaque()
+    }
+
+    //Registra el VFS en SQLite. Con predeterminado las conexiones que no indiquen VFS tambien lo usan
+    @discardableResult
+    func registrar(predeterminado: Bool = false) -> Bool {
+        return sqlite3_vfs_register(vfs, predeterminado ? 1 : 0) == SQLITE_OK
+    }
+
+    // MARK: - Para las subclases
+
+    //Con el fichero real ya abierto. Tiene que dar el estado con asignarEstado; si devuelve un
+    //error el fichero real se cierra
+    func abrirPrincipal(_ archivo: UnsafeMutablePointer<sqlite3_file>, flags: Int32) -> Int32 {
+        return SQLITE_OK
+    }
+
+    //Antes de cerrar el fichero real
+    func cerrar(_ archivo: UnsafeMutablePointer<sqlite3_file>) -> Int32 {
+        return SQLITE_OK
+    }
+
+    //Empieza una transaccion de lectura, en modo diario o WAL: otra conexion puede haber cambiado el fichero
+    func empiezaLectura(_ archivo: UnsafeMutablePointer<sqlite3_file>) {
+    }
+
+    //Antes de soltar un cerrojo del fichero o de la memoria compartida de WAL
+    func soltandoCerrojo(_ archivo: UnsafeMutablePointer<sqlite3_file>) -> Int32 {
+        return SQLITE_OK
+    }
+
+    func leer(_ archivo: UnsafeMutablePointer<sqlite3_file>, _ buffer: UnsafeMutableRawPointer, _ cantidad: Int32,
+              _ desplazamiento: sqlite3_int64) -> Int32 {
+        let interno = VFSEnvoltorio.interno(archivo)
+        return interno.pointee.pMethods.pointee.xRead!(interno, buffer, cantidad, desplazamiento)
+    }
+
+    func escribir(_ archivo: UnsafeMutablePointer<sqlite3_file>, _ buffer: UnsafeRawPointer, _ cantidad: Int32,
+                  _ desplazamiento: sqlite3_int64) -> Int32 {
+        let interno = VFSEnvoltorio.interno(archivo)
+        return interno.pointee.pMethods.pointee.xWrite!(interno, buffer, cantidad, desplazamiento)
+    }
+
+    func truncar(_ archivo: UnsafeMutablePointer<sqlite3_file>, _ tamano: sqlite3_int64) -> Int32 {
+        let interno = VFSEnvoltorio.interno(archivo)
+        return interno.pointee.pMethods.pointee.xTruncate!(interno, tamano)
+    }
+
+    func sincronizar(_ archivo: UnsafeMutablePointer<sqlite3_file>, _ flags: Int32) -> Int32 {
+        let interno = VFSEnvoltorio.interno(archivo)
+        return interno.pointee.pMethods.pointee.xSync!(interno, flags)
+    }
+
+    func tamano(_ archivo: UnsafeMutablePointer<sqlite3_file>, _ tamano: UnsafeMutablePointer<sqlite3_int64>) -> Int32 {
+        let interno = VFSEnvoltorio.interno(archivo)
+        return interno.pointee.pMethods.pointee.xFileSize!(interno, tamano)
+    }
+
+    func controlar(_ archivo: UnsafeMutablePointer<sqlite3_file>, _ operacion: Int32, _ argumento: UnsafeMutableRawPointer?) -> Int32 {
+        let interno = VFSEnvoltorio.interno(archivo)
+        return interno.pointee.pMethods.pointee.xFileControl!(interno, operacion, argumento)
+    }
+
+    func tamanoSector(_ archivo: UnsafeMutablePointer<sqlite3_file>) -> Int32 {
+        let interno = VFSEnvoltorio.interno(archivo)
+        return interno.pointee.pMethods.pointee.xSectorSize!(interno)
+    }
+
+    func caracteristicas(_ archivo: UnsafeMutablePointer<sqlite3_file>) -> Int32 {
+        let interno = VFSEnvoltorio.interno(archivo)
+        return interno.pointee.pMethods.pointee.xDeviceCharacteristics!(interno)
+    }
+
+    //Solo si versionMaxima es 3
+    func entregar(_ archivo: UnsafeMutablePointer<sqlite3_file>, _ desplazamiento: sqlite3_int64, _ cantidad: Int32,
+                  _ salida: UnsafeMutablePointer<UnsafeMutableRawPointer?>) -> Int32 {
+        let interno = VFSEnvoltorio.interno(archivo)
+        return interno.pointee.pMethods.pointee.xFetch!(interno, desplazamiento, cantidad, salida)
+    }
+
+    func devolver(_ archivo: UnsafeMutablePointer<sqlite3_file>, _ desplazamiento: sqlite3_int64, _ pagina: UnsafeMutableRawPointer?) -> Int32 {
+        let interno = VFSEnvoltorio.interno(archivo)
+        return interno.pointee.pMethods.pointee.xUnfetch!(interno, desplazamiento, pagina)
+    }
+
+    final func asignarEstado(_ estado: AnyObject, a archivo: UnsafeMutablePointer<sqlite3_file>) {
+        (UnsafeMutableRawPointer(archivo) + VFSEnvoltorio.desplazamientoEstado).storeBytes(of: Unmanaged.passRetained(estado).toOpaque(), as: UnsafeMutableRawPointer?.self)
+    }
+
+    final class func estado<T: AnyObject>(_ archivo: UnsafeMutablePointer<sqlite3_file>, como: T.Type) -> T {
+        let puntero = (UnsafeMutableRawPointer(archivo) + desplazamientoEstado).load(as: UnsafeMutableRawPointer.self)
+        return Unmanaged<T>.fromOpaque(puntero).takeUnretainedValue()
+    }
+
+    final class func interno(_ archivo: UnsafeMutablePointer<sqlite3_file>) -> UnsafeMutablePointer<sqlite3_file> {
+        return (UnsafeMutableRawPointer(archivo) + desplazamientoInterno).assumingMemoryBound(to: sqlite3_file.self)
+    }
+
+    // MARK: - Ficheros
+
+    private class func envoltorio(de vfs: UnsafeMutablePointer<sqlite3_vfs>) -> VFSEnvoltorio {
+        return Unmanaged<VFSEnvoltorio>.fromOpaque(vfs.pointee.pAppData).takeUnretainedValue()
+    }
+
+    private class func envoltorio(de archivo: UnsafeMutablePointer<sqlite3_file>) -> VFSEnvoltorio {
+        let puntero = (UnsafeMutableRawPointer(archivo) + desplazamientoEnvoltorio).load(as: UnsafeMutableRawPointer.self)
+        return Unmanaged<VFSEnvoltorio>.fromOpaque(puntero).takeUnretainedValue()
+    }
+
+    private class func liberarEstado(_ archivo: UnsafeMutablePointer<sqlite3_file>) {
+        let posicion = UnsafeMutableRawPointer(archivo) + desplazamientoEstado
+        if let puntero = posicion.load(as: UnsafeMutableRawPointer?.self) {
+            Unmanaged<AnyObject>.fromOpaque(puntero).release()
+        }
+        posicion.storeBytes(of: nil, as: UnsafeMutableRawPointer?.self)
+    }
+
+    private func abrir(_ nombre: UnsafePointer<Int8>?, _ archivo: UnsafeMutablePointer<sqlite3_file>, _ flags: Int32,
+                       _ flagsSalida: UnsafeMutablePointer<Int32>?) -> Int32 {
+        guard flags & SQLITE_OPEN_MAIN_DB != 0 else {
+            return real.pointee.xOpen!(real, nombre, archivo, flags, flagsSalida)
+        }
+        let interno = VFSEnvoltorio.interno(archivo)
+        var resultado = real.pointee.xOpen!(real, nombre, interno, flags, flagsSalida)
+        guard resultado == SQLITE_OK, let reales = interno.pointee.pMethods else {
+            //Sin metodos SQLite no llama a xClose
+            archivo.pointee.pMethods = nil
+            return resultado
+        }
+        (UnsafeMutableRawPointer(archivo) + VFSEnvoltorio.desplazamientoEnvoltorio).storeBytes(of: Unmanaged.passUnretained(self).toOpaque(), as: UnsafeMutableRawPointer.self)
+        (UnsafeMutableRawPointer(archivo) + VFSEnvoltorio.desplazamientoEstado).storeBytes(of: nil, as: UnsafeMutableRawPointer?.self)
+        resultado = abrirPrincipal(archivo, flags: flags)
+        guard resultado == SQLITE_OK else {
+            VFSEnvoltorio.liberarEstado(archivo)
+            _ = reales.pointee.xClose!(interno)
+            archivo.pointee.pMethods = nil
+            return resultado
+        }
+        archivo.pointee.pMethods = metodos(para: reales)
+        return SQLITE_OK
+    }
+
+    private func metodos(para reales: UnsafePointer<sqlite3_io_methods>) -> UnsafePointer<sqlite3_io_methods> {
+        cerrojo.lock()
+        defer { cerrojo.unlock() }
+        if let existentes = metodos[UnsafeRawPointer(reales)] {
+            return UnsafePointer(existentes)
+        }
+        let nuevos = UnsafeMutablePointer<sqlite3_io_methods>.allocate(capacity: 1)
+        nuevos.initialize(to: sqlite3_io_methods())
+        //La misma version que el real: sin memoria compartida (version 2) no hay WAL
+        nuevos.pointee.iVersion = min(reales.pointee.iVersion, versionMaxima)
+        nuevos.pointee.xClose = { archivo in
+            let cerrado = VFSEnvoltorio.envoltorio(de: archivo!).cerrar(archivo!)
+            VFSEnvoltorio.liberarEstado(archivo!)
+            let interno = VFSEnvoltorio.interno(archivo!)
+            let resultado = interno.pointee.pMethods.pointee.xClose!(interno)
+            return cerrado == SQLITE_OK ? resultado : cerrado
+        }
+        nuevos.pointee.xRead = { archivo, buffer, cantidad, desplazamiento in
+            return VFSEnvoltorio.envoltorio(de: archivo!).leer(archivo!, buffer!, cantidad, desplazamiento)
+        }
+        nuevos.pointee.xWrite = { archivo, buffer, cantidad, desplazamiento in
+            return VFSEnvoltorio.envoltorio(de: archivo!).escribir(archivo!, buffer!, cantidad, desplazamiento)
+        }
+        nuevos.pointee.xTruncate = { archivo, tamano in
+            return VFSEnvoltorio.envoltorio(de: archivo!).truncar(archivo!, tamano)
+        }
+        nuevos.pointee.xSync = { archivo, flags in
+            return VFSEnvoltorio.envoltorio(de: archivo!).sincronizar(archivo!, flags)
+        }
+        nuevos.pointee.xFileSize = { archivo, tamano in
+            return VFSEnvoltorio.envoltorio(de: archivo!).tamano(archivo!, tamano!)
+        }
+        nuevos.pointee.xLock = { archivo, nivel in
+            let interno = VFSEnvoltorio.interno(archivo!)
+            let resultado = interno.pointee.pMethods.pointee.xLock!(interno, nivel)
+            if resultado == SQLITE_OK && nivel == SQLITE_LOCK_SHARED {
+                VFSEnvoltorio.envoltorio(de: archivo!).empiezaLectura(archivo!)
+            }
+            return resultado
+        }
+        nuevos.pointee.xUnlock = { archivo, nivel in
+            let soltado = VFSEnvoltorio.envoltorio(de: archivo!).soltandoCerrojo(archivo!)
+            let interno = VFSEnvoltorio.interno(archivo!)
+            let resultado = interno.pointee.pMethods.pointee.xUnlock!(interno, nivel)
+            return soltado == SQLITE_OK ? resultado : soltado
+        }
+        nuevos.pointee.xCheckReservedLock = { archivo, resultado in
+            let interno = VFSEnvoltorio.interno(archivo!)
+            return interno.pointee.pMethods.pointee.xCheckReservedLock!(interno, resultado)
+        }
+        nuevos.pointee.xFileControl = { archivo, operacion, argumento in
+            return VFSEnvoltorio.envoltorio(de: archivo!).controlar(archivo!, operacion, argumento)
+        }
+        nuevos.pointee.xSectorSize = { archivo in
+            return VFSEnvoltorio.envoltorio(de: archivo!).tamanoSector(archivo!)
+        }
+        nuevos.pointee.xDeviceCharacteristics = { archivo in
+            return VFSEnvoltorio.envoltorio(de: archivo!).caracteristicas(archivo!)
+        }
+        if nuevos.pointee.iVersion >= 2 {
+            nuevos.pointee.xShmMap = { archivo, region, tamano, extender, salida in
+                let interno = VFSEnvoltorio.interno(archivo!)
+                return interno.pointee.pMethods.pointee.xShmMap!(interno, region, tamano, extender, salida)
+            }
+            nuevos.pointee.xShmLock = { archivo, desplazamiento, cantidad, flags in
+                if flags & SQLITE_SHM_UNLOCK != 0 {
+                    let soltado = VFSEnvoltorio.envoltorio(de: archivo!).soltandoCerrojo(archivo!)
+                    guard soltado == SQLITE_OK else {
+                        return soltado
+                    }
+                }
+                let interno = VFSEnvoltorio.interno(archivo!)
+                let resultado = interno.pointee.pMethods.pointee.xShmLock!(interno, desplazamiento, cantidad, flags)
+                if resultado == SQLITE_OK && flags == SQLITE_SHM_LOCK | SQLITE_SHM_SHARED {
+                    VFSEnvoltorio.envoltorio(de: archivo!).empiezaLectura(archivo!)
+                }
+                return resultado
+            }
+            nuevos.pointee.xShmBarrier = { archivo in
+                let interno = VFSEnvoltorio.interno(archivo!)
+                interno.pointee.pMethods.pointee.xShmBarrier!(interno)
+            }
+            nuevos.pointee.xShmUnmap = { archivo, borrar in
+                let interno = VFSEnvoltorio.interno(archivo!)
+                return interno.pointee.pMethods.pointee.xShmUnmap!(interno, borrar)
+            }
+        }
+        if nuevos.pointee.iVersion >= 3 {
+            nuevos.pointee.xFetch = { archivo, desplazamiento, cantidad, salida in
+                return VFSEnvoltorio.envoltorio(de: archivo!).entregar(archivo!, desplazamiento, cantidad, salida!)
+            }
+            nuevos.pointee.xUnfetch = { archivo, desplazamiento, pagina in
+                return VFSEnvoltorio.envoltorio(de: archivo!).devolver(archivo!, desplazamiento, pagina)
+            }
+        }
+        metodos[UnsafeRawPointer(reales)] = nuevos
+        return UnsafePointer(nuevos)
+    }
+}
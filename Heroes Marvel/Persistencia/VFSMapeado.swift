@@ -0,0 +1,262 @@
+//
+//  VFSMapeado.swift
+//  Heroes Marvel
+//
+//  Created by Borja Gil Herrero on 19/10/2026.
+//  Copyright © 2026 Alsis GHE. All rights reserved.
+//
+
+import Foundation
+import SQLite3
+
+//Lecturas del fichero principal de las bases de datos abiertas con el VFS, acumuladas
+struct ContadoresVFS {
+    //Paginas pedidas con xRead
+    var lecturas: Int64 = 0
+    //Lecturas dentro del mapa en memoria del VFS real, que su xRead sirve con memcpy
+    var desdeMapa: Int64 = 0
+    //Lecturas que han ido al fichero: fuera del mapa o sin mapa
+    var desdeDisco: Int64 = 0
+    //Paginas entregadas con xFetch, sin copiar (solo con PRAGMA mmap_size)
+    var sinCopia: Int64 = 0
+    //Avisos de lectura anticipada al sistema y bytes que cubren
+    var anticipaciones: Int64 = 0
+    var bytesAnticipados: Int64 = 0
+    var remapeos: Int64 = 0
+
+    static func - (a: ContadoresVFS, b: ContadoresVFS) -> ContadoresVFS {
+        return ContadoresVFS(lecturas: a.lecturas - b.lecturas, desdeMapa: a.desdeMapa - b.desdeMapa,
+                             desdeDisco: a.desdeDisco - b.desdeDisco, sinCopia: a.sinCopia - b.sinCopia,
+                             anticipaciones: a.anticipaciones - b.anticipaciones,
+                             bytesAnticipados: a.bytesAnticipados - b.bytesAnticipados, remapeos: a.remapeos - b.remapeos)
+    }
+}
+
+//Lectura anticipada de un fichero principal abierto con el VFS. SQLite no usa el mismo fichero
+//desde dos hilos a la vez, asi que no necesita cerrojo
+private final class EstadoArchivo {
+
+    //Bytes del fichero que cubre el mapa del VFS real; -1 si no se sabe (aun sin mapa o soltado)
+    var tamanoMapeado: Int64 = -1
+    //Limite de mmap del VFS real para este fichero
+    var limiteMapa = VFSMapeado.tamanoMaximoMapa
+    //El primer SQLITE_FCNTL_MMAP_SIZE lo manda SQLite al abrir con el valor por defecto de la
+    //conexion; los siguientes son de PRAGMA mmap_size
+    var limitePorDefectoRecibido = false
+    //Paginas entregadas con xFetch que SQLite aun no ha devuelto: mientras haya no se remapea
+    var pendientes = 0
+
+    var ultimoFin: Int64 = -1
+    var seguidas = 0
+    var anticipadoHasta: Int64 = 0
+}
+
+//VFS que envuelve al de por defecto para que las lecturas del fichero principal de la base de
+//datos salgan de un mmap: el VFS real, con limite de mmap y el fichero mapeado, sirve cada xRead
+//dentro del mapa con una copia de memoria en lugar de una llamada a read(). El mapa es el suyo,
+//sobre su propio descriptor: abrir otro y cerrarlo soltaria los cerrojos POSIX que el proceso
+//tiene sobre el fichero. Este VFS solo sube el limite, hace que el mapa siga el tamaño del
+//fichero y, cuando las lecturas van seguidas (un recorrido de tabla), pide al sistema por
+//adelantado el siguiente tramo con madvise. PRAGMA mmap_size se respeta, tambien 0 para no
+//mapear. Diarios, WAL y temporales van tal cual al VFS de por defecto.
+//Se usa por nombre: ConexionSQLite(ruta:vfs: VFSMapeado.nombre) o connectToFile:withFlags:usingVFS:
+//de RBSQLiteConnection, despues de registrar()
+final class VFSMapeado: VFSEnvoltorio {
+
+    static let nombre = "mapeado"
+    static let shared = VFSMapeado()
+    //Tramo que se pide por adelantado en los recorridos
+    static let ventanaAnticipacion: Int64 = 512 * 1024
+    //Lecturas seguidas a partir de las que se considera un recorrido
+    static let lecturasSeguidas = 2
+    //De los ficheros mas grandes solo se mapea el principio; el resto se lee como siempre
+    static let tamanoMaximoMapa: Int64 = 1 << 30
+
+    private enum Contador: Int {
+        case lecturas, desdeMapa, desdeDisco, sinCopia, anticipaciones, bytesAnticipados, remapeos
+        static let total = 7
+    }
+
+    private let contadores = TablaContadores(cantidad: Contador.total)
+    private let pagina = Int64(getpagesize())
+
+    private init() {
+        //Version 3 para pasar xFetch al VFS real
+        super.init(nombre: VFSMapeado.nombre, versionMaxima: 3)
+    }
+
+    // MARK: - Contadores
+
+    func leerContadores() -> ContadoresVFS {
+        let copia = contadores.leer()
+        let valor = { (contador: Contador) in copia[contador.rawValue] }
+        return ContadoresVFS(lecturas: valor(.lecturas), desdeMapa: valor(.desdeMapa), desdeDisco: valor(.desdeDisco),
+                             sinCopia: valor(.sinCopia), anticipaciones: valor(.anticipaciones),
+                             bytesAnticipados: valor(.bytesAnticipados), remapeos: valor(.remapeos))
+    }
+
+    //Lecturas hechas mientras se ejecuta el bloque. Son de todas las conexiones: para ver las de una
+    //consulta no tiene que haber otras a la vez
+    func medir<T>(_ bloque: () throws -> T) rethrows -> (T, ContadoresVFS) {
+        let antes = leerContadores()
+        let resultado = try bloque()
+        return (resultado, leerContadores() - antes)
+    }
+
+    private func contar(_ contador: Contador, _ cantidad: Int64 = 1) {
+        contadores.sumar(contador.rawValue, cantidad)
+    }
+
+    // MARK: - Ficheros
+
+    override func abrirPrincipal(_ archivo: UnsafeMutablePointer<sqlite3_file>, flags: Int32) -> Int32 {
+        asignarEstado(EstadoArchivo(), a: archivo)
+        //Sin limite el VFS real no mapea nada
+        let interno = VFSMapeado.interno(archivo)
+        var limite = VFSMapeado.tamanoMaximoMapa
+        _ = interno.pointee.pMethods.pointee.xFileControl!(interno, SQLITE_FCNTL_MMAP_SIZE, &limite)
+        return SQLITE_OK
+    }
+
+    private class func estado(_ archivo: UnsafeMutablePointer<sqlite3_file>) -> EstadoArchivo {
+        return estado(archivo, como: EstadoArchivo.self)
+    }
+
+    //Al empezar cada transaccion de lectura. El VFS real solo mapea cuando alguien le pide una
+    //pagina con xFetch, y no vuelve a mapear si el fichero crece (otra conexion ha escrito): lo
+    //nuevo se leeria con read(). Si el mapa no cubre el fichero se suelta y se pide la primera
+    //pagina, que lo rehace con el tamaño actual, salvo si SQLite tiene paginas suyas sin devolver.
+    //Es una vez por cambio de tamaño, no por lectura
+    override func empiezaLectura(_ archivo: UnsafeMutablePointer<sqlite3_file>) {
+        let estado = VFSMapeado.estado(archivo)
+        let interno = VFSMapeado.interno(archivo)
+        var tamano: sqlite3_int64 = 0
+        guard interno.pointee.pMethods.pointee.iVersion >= 3,
+            interno.pointee.pMethods.pointee.xFileSize!(interno, &tamano) == SQLITE_OK else {
+            return
+        }
+        let mapear = min(tamano, estado.limiteMapa)
+        guard mapear != estado.tamanoMapeado, estado.pendientes == 0 else {
+            return
+        }
+        if estado.tamanoMapeado != 0 {
+            _ = interno.pointee.pMethods.pointee.xUnfetch!(interno, 0, nil)
+            if estado.tamanoMapeado > 0 {
+                contar(.remapeos)
+            }
+        }
+        estado.anticipadoHasta = 0
+        //El mapa cubre lo pedido si el VFS real da un puntero a todo el tramo
+        estado.tamanoMapeado = mapear > 0 && conMapa(interno, 0, mapear, { _ in }) ? mapear : 0
+    }
+
+    //Pide al VFS real un puntero a las paginas dentro de su mapa y lo devuelve enseguida. false si
+    //no estan mapeadas (fuera del mapa, limite 0 o sin soporte de mmap)
+    private func conMapa(_ interno: UnsafeMutablePointer<sqlite3_file>, _ desplazamiento: Int64, _ cantidad: Int64,
+                         _ bloque: (UnsafeMutableRawPointer) -> Void) -> Bool {
+        let metodos = interno.pointee.pMethods.pointee
+        guard metodos.iVersion >= 3, cantidad > 0, cantidad <= Int64(Int32.max) else {
+            return false
+        }
+        var puntero: UnsafeMutableRawPointer? = nil
+        guard metodos.xFetch!(interno, desplazamiento, Int32(cantidad), &puntero) == SQLITE_OK, let mapa = puntero else {
+            return false
+        }
+        bloque(mapa)
+        _ = metodos.xUnfetch!(interno, desplazamiento, mapa)
+        return true
+    }
+
+    //La lectura va tal cual al VFS real, que ya copia del mapa lo que esta dentro: aqui solo se
+    //cuenta de donde sale segun lo que cubre el mapa
+    override func leer(_ archivo: UnsafeMutablePointer<sqlite3_file>, _ buffer: UnsafeMutableRawPointer, _ cantidad: Int32,
+                       _ desplazamiento: sqlite3_int64) -> Int32 {
+        let estado = VFSMapeado.estado(archivo)
+        contar(.lecturas)
+        contar(desplazamiento + Int64(cantidad) <= estado.tamanoMapeado ? .desdeMapa : .desdeDisco)
+        anticipar(estado, VFSMapeado.interno(archivo), desplazamiento: desplazamiento, cantidad: Int64(cantidad))
+        return super.leer(archivo, buffer, cantidad, desplazamiento)
+    }
+
+    //Si las lecturas van una detras de otra, pide al sistema el siguiente tramo antes de que SQLite
+    //lo necesite, para que las paginas ya esten en memoria y no haya fallos de pagina uno a uno
+    private func anticipar(_ estado: EstadoArchivo, _ interno: UnsafeMutablePointer<sqlite3_file>, desplazamiento: Int64, cantidad: Int64) {
+        if desplazamiento == estado.ultimoFin {
+            estado.seguidas += 1
+        } else {
+            estado.seguidas = 0
+        }
+        estado.ultimoFin = desplazamiento + cantidad
+        guard estado.seguidas >= VFSMapeado.lecturasSeguidas,
+            estado.ultimoFin + VFSMapeado.ventanaAnticipacion / 2 > estado.anticipadoHasta else {
+            return
+        }
+        let inicio = max(estado.ultimoFin, estado.anticipadoHasta) & ~(pagina - 1)
+        let fin = min(inicio + VFSMapeado.ventanaAnticipacion, estado.tamanoMapeado)
+        //Todo el tramo tiene que estar dentro del mapa; el mapa empieza en una pagina, asi que el
+        //puntero a inicio tambien
+        guard fin > inicio, conMapa(interno, inicio, fin - inicio, { _ = madvise($0, Int(fin - inicio), MADV_WILLNEED) }) else {
+            return
+        }
+        estado.anticipadoHasta = fin
+        contar(.anticipaciones)
+        contar(.bytesAnticipados, fin - inicio)
+    }
+
+    //El limite de PRAGMA mmap_size llega aqui. Se respeta, 0 incluido; solo el valor por defecto
+    //que SQLite manda al abrir se cambia por tamanoMaximoMapa si no pide mapa, porque sin
+    //PRAGMA es 0 y dejaria al VFS sin mapa
+    override func controlar(_ archivo: UnsafeMutablePointer<sqlite3_file>, _ operacion: Int32, _ argumento: UnsafeMutableRawPointer?) -> Int32 {
+        guard operacion == SQLITE_FCNTL_MMAP_SIZE, let limite = argumento?.assumingMemoryBound(to: sqlite3_int64.self),
+            limite.pointee >= 0 else {
+            return super.controlar(archivo, operacion, argumento)
+        }
+        let estado = VFSMapeado.estado(archivo)
+        if !estado.limitePorDefectoRecibido {
+            estado.limitePorDefectoRecibido = true
+            if limite.pointee == 0 {
+                limite.pointee = VFSMapeado.tamanoMaximoMapa
+            }
+        }
+        //El VFS real devuelve en el argumento el limite anterior, y no cambia el suyo mientras
+        //SQLite tenga paginas entregadas
+        let nuevo = limite.pointee
+        let aplicable = estado.pendientes == 0
+        let resultado = super.controlar(archivo, operacion, argumento)
+        if resultado == SQLITE_OK && aplicable && nuevo != estado.limiteMapa {
+            //Rehace o quita el mapa con el limite nuevo: se vuelve a medir al empezar la siguiente lectura
+            estado.limiteMapa = nuevo
+            estado.tamanoMapeado = -1
+        }
+        return resultado
+    }
+
+    //Paginas sin copia cuando la conexion tiene PRAGMA mmap_size: las del mapa del VFS real
+    override func entregar(_ archivo: UnsafeMutablePointer<sqlite3_file>, _ desplazamiento: sqlite3_int64, _ cantidad: Int32,
+                           _ salida: UnsafeMutablePointer<UnsafeMutableRawPointer?>) -> Int32 {
+        let resultado = super.entregar(archivo, desplazamiento, cantidad, salida)
+        if resultado == SQLITE_OK && salida.pointee != nil {
+            let estado = VFSMapeado.estado(archivo)
+            estado.pendientes += 1
+            contar(.sinCopia)
+            //Si SQLite habia soltado el mapa, este xFetch lo ha rehecho con el tamaño del fichero
+            var tamano: sqlite3_int64 = 0
+            let interno = VFSMapeado.interno(archivo)
+            if estado.tamanoMapeado < 0 && interno.pointee.pMethods.pointee.xFileSize!(interno, &tamano) == SQLITE_OK {
+                estado.tamanoMapeado = min(tamano, estado.limiteMapa)
+            }
+        }
+        return resultado
+    }
+
+    override func devolver(_ archivo: UnsafeMutablePointer<sqlite3_file>, _ desplazamiento: sqlite3_int64, _ pagina: UnsafeMutableRawPointer?) -> Int32 {
+        //Con pagina nil SQLite pide soltar el mapa entero, antes de truncar o si el fichero ha cambiado
+        let estado = VFSMapeado.estado(archivo)
+        if pagina != nil {
+            estado.pendientes = max(0, estado.pendientes - 1)
+        } else {
+            estado.tamanoMapeado = -1
+        }
+        return super.devolver(archivo, desplazamiento, pagina)
+    }
+}
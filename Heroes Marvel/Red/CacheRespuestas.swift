@@ -0,0 +1,126 @@
+//
+//  CacheRespuestas.swift
+//  Heroes Marvel
+//
+//  Created by Borja Gil Herrero on 19/10/2026.
+//  Copyright © 2026 Alsis GHE. All rights reserved.
+//
+
+import Foundation
+import Redbeard
+
+//Cache en disco de las respuestas de la API. Cada url lleva un ts y un hash nuevos, asi que la
+//clave es la peticion canonica: endpoint y parametros ordenados sin los de autenticacion.
+//El cuerpo se guarda comprimido con gzip y junto a el la etag y la fecha de descarga: mientras
+//no caduca se sirve directamente y despues se revalida con If-None-Match.
+class CacheRespuestas {
+
+    static let shared = CacheRespuestas()
+    static let parametrosAutenticacion: Set<String> = ["ts", "apikey", "hash"]
+
+    //Tiempo durante el que una respuesta se sirve sin preguntar al servidor
+    var vigencia: TimeInterval = 24 * 60 * 60
+
+    private let directorio: URL
+    private let cola = DispatchQueue(label: "CacheRespuestas")
+
+    private init() {
+        let caches = FileManager.default.urls(for: .cachesDirectory, in: .userDomainMask)[0]
+        directorio = caches.appendingPathComponent("RespuestasAPI", isDirectory: true)
+        try? FileManager.default.createDirectory(at: directorio, withIntermediateDirectories: true, attributes: nil)
+    }
+
+    //Clave canonica de una peticion: endpoint + parametros ordenados, sin ts, apikey ni hash
+    class func clave(para url: URL) -> String {
+        guard var componentes = URLComponents(url: url, resolvingAgainstBaseURL: false) else {
+            return url.absoluteString
+        }
+        let parametros = (componentes.queryItems ?? [])
+            .filter { !parametrosAutenticacion.contains($0.name) }
+            .sorted { $0.name < $1.name }
+        componentes.queryItems = parametros.isEmpty ? nil : parametros
+        return componentes.string ?? url.absoluteString
+    }
+
+    // MARK: - Consulta
+
+    //Cuerpo guardado si todavia no ha caducado
+    func respuestaVigente(clave: String) -> Data? {
+        return cola.sync {
+            guard let metadatos = leerMetadatos(clave: clave), let fecha = metadatos["fecha"] as? Date,
+                Date().timeIntervalSince(fecha) < vigencia else {
+                return nil
+            }
+            return leerCuerpo(clave: clave)
+        }
+    }
+
+    //Etag de la ultima respuesta guardada, para revalidar con If-None-Match
+    func etag(clave: String) -> String? {
+        return cola.sync {
+            return leerMetadatos(clave: clave)?["etag"] as? String
+        }
+    }
+
+    //El servidor ha contestado 304: la respuesta guardada vuelve a ser vigente
+    func revalidar(clave: String) -> Data? {
+        return cola.sync {
+            guard var metadatos = leerMetadatos(clave: clave), let cuerpo = leerCuerpo(clave: clave) else {
+                return nil
+            }
+            metadatos["fecha"] = Date()
+            (metadatos as NSDictionary).write(to: urlMetadatos(clave: clave), atomically: true)
+            return cuerpo
+        }
+    }
+
+    // MARK: - Guardado
+
+    func guardar(_ datos: Data, etag: String?, clave: String) {
+        cola.async {
+            let comprimido = (datos as NSData).gzipDeflate()
+            do {
+                try comprimido.write(to: self.urlCuerpo(clave: clave), options: .atomic)
+            } catch {
+                return
+            }
+            var metadatos: [String: Any] = ["clave": clave, "fecha": Date()]
+            if let etag = etag {
+                metadatos["etag"] = etag
+            }
+            (metadatos as NSDictionary).write(to: self.urlMetadatos(clave: clave), atomically: true)
+        }
+    }
+
+    func vaciar() {
+        cola.sync {
+            try? FileManager.default.removeItem(at: directorio)
+            try? FileManager.default.createDirectory(at: directorio, withIntermediateDirectories: true, attributes: nil)
+        }
+    }
+
+    // MARK: - Ficheros
+
+    private func urlCuerpo(clave: String) -> URL {
+        return directorio.appendingPathComponent(clave.md5() + ".gz")
+    }
+
+    private func urlMetadatos(clave: String) -> URL {
+        return directorio.appendingPathComponent(clave.md5() + ".plist")
+    }
+
+    private func leerMetadatos(clave: String) -> [String: Any]? {
+        guard let metadatos = NSDictionary(contentsOf: urlMetadatos(clave: clave)) as? [String: Any],
+            metadatos["clave"] as? String == clave else {
+            return nil
+        }
+        return metadatos
+    }
+
+    private func leerCuerpo(clave: String) -> Data? {
+        guard let comprimido = try? Data(contentsOf: urlCuerpo(clave: clave)) else {
+            return nil
+        }
+        return (comprimido as NSData).gzipInflate()
+    }
+}
@@ -10,143 +10,221 @@ import Foundation
 import CoreData
 import UIKit
 
+//Resultado de pedir una pagina de personajes
+enum ResultadoPagina {
+    //Se han guardado los personajes de la pagina
+    case personajes(Int)
+    //No quedan mas personajes
+    case fin
+    //La pagina no se ha podido obtener ni siquiera con reintentos
+    case fallo(Error)
+}
+
 class MarvelRed: NSObject{
-    static var semaforo: DispatchGroup = DispatchGroup()
+    static let firma = FirmaMarvel(clavePublica: "c0252ec5bc3ee9b2c6a0a26e2dfb306d", clavePrivada: "c124cdc74823164742598e641674842fa2de600c")
+    //Formato de fecha de la API de Marvel, por ejemplo 2014-04-29T14:18:17-0400
+    static var formatoFecha: DateFormatter {
+        return PaginadorPersonajes.formatoFecha
+    }
+    static let latenciaDescarga = RegistroLatencias.shared.histograma("pagina.descarga")
+    static let latenciaDecodificacion = RegistroLatencias.shared.histograma("pagina.decodificacion")
+    static let latenciaGuardado = RegistroLatencias.shared.histograma("pagina.guardado")
     //Funcion que nos genera una sesion de red a partir de una url a la que conectarse
-    class func crearSesionRed(url: String, limit:String, offset: String) -> (NSMutableURLRequest, URLSession) {
-        
-        let request: NSMutableURLRequest
-        let session = URLSession.shared
-        
-        let APIKEY: String = "c0252ec5bc3ee9b2c6a0a26e2dfb306d"
-        let PRIVKEY: String = "c124cdc74823164742598e641674842fa2de600c"
-        
-        let ts = NSDate().timeIntervalSince1970.description
-        let hash = "\(ts)\(PRIVKEY)\(APIKEY)".md5()!
-
-        
-        let urlFinal: String = url + "?ts=" + ts + "&apikey="  + APIKEY + "&hash=" + hash + "&limit=" + limit + "&offset=" + offset
-        
-        request = NSMutableURLRequest(url: URL(string: urlFinal)!)
-        
-        return (request, session)
+    class func crearSesionRed(url: String, limit:String, offset: String, parametros: [String: String] = [:]) -> (NSMutableURLRequest, URLSession) {
+        //La firma y el orden de los parametros son los del paquete MarvelSync, igual que en el banco de pruebas
+        let urlFinal = PaginadorPersonajes.url(url, firma: firma, limit: limit, offset: offset, parametros: parametros)
+        return (NSMutableURLRequest(url: urlFinal), URLSession.shared)
     }
     
-    class func llamadaPersonajes(limit: String, offset: String) -> Bool{
-        
-        var request: NSMutableURLRequest = NSMutableURLRequest()
-        var session: URLSession = URLSession()
+    //Pide una pagina de personajes. Con modificadoDesde solo se piden los cambiados despues de esa fecha.
+    //La llamada espera su turno en el planificador segun la prioridad y la cuota que quede, y los
+    //fallos transitorios se reintentan en TransporteResiliente
+    class func llamadaPersonajes(limit: String, offset: String, modificadoDesde: Date? = nil, prioridad: PrioridadPeticion = .sincronizacion) -> ResultadoPagina{
+        return Traza.shared.intervalo("pagina", categoria: "sincronizacion", argumentos: ["offset": Double(offset) ?? 0]){
+            return pedirPagina(limit: limit, offset: offset, modificadoDesde: modificadoDesde, prioridad: prioridad)
+        }
+    }
 
-        var retorno: Bool = true
+    private class func pedirPagina(limit: String, offset: String, modificadoDesde: Date?, prioridad: PrioridadPeticion) -> ResultadoPagina{
+        var request: NSMutableURLRequest = NSMutableURLRequest()
         
-        (request,session) = crearSesionRed(url : "https://gateway.marvel.com/v1/public/characters", limit: limit, offset: offset)
-
-        semaforo.enter()
-        let task = session.dataTask(with: request as URLRequest, completionHandler: {data, response, error -> Void in
-
-            do{
-                let result = NSString(data: data!, encoding: String.Encoding.ascii.rawValue)!
-                let cadData:String = (result as String)
-
-                //let dataA : Data = cadData.data(using: String.Encoding.utf8)!
-                //Transformamos la informacion a un diccionario
-
-                //let dataB : NSDictionary = try JSONSerialization.jsonObject(with: dataA, options:JSONSerialization.ReadingOptions.mutableContainers) as! NSDictionary
-                
-                if let jsonData = cadData.data(using: .utf8)
-                {
-                    let respuestaAPI = try? JSONDecoder().decode(RespuestaAPI.self, from: jsonData)
-                    //Only with name, age, gender properties decoded from json as we have defined CodingKeys enum in Person class.
-                    //while respuestaAPI == nil{
-                   // }
-	                    print(respuestaAPI?.data.results[2].name)
-                    print(respuestaAPI?.code)
-                    
-
-                    //person.phone and person.country will be empty
-                
-                //Recorremos la informacion que nos devuelve la API de Marvel para llegar a la información
-                ///*
-                //let code: [Int64] = dataB.objects(forKeys: ["code"], notFoundMarker: self) as! [Int64]
-                    if respuestaAPI!.code == 200{
-                //if code[0] == 200{
-                    //let datos:[NSDictionary]  = dataB.objects(forKeys: ["data"], notFoundMarker: self) as! [NSDictionary]
-            
-                    //let resultados: [NSArray] = datos.first!.objects(forKeys: ["results"], notFoundMarker: self) as! [NSArray]
-                        if respuestaAPI!.data.count != 0{
-                    //if resultados.count != 0{
-                            if respuestaAPI!.data.results.count != 0{
-                        //if resultados[0].count != 0{
-                            //crearPersonajes(datos: resultados[0])
-                                crearPersonajes(datos: respuestaAPI!.data.results)
-                            retorno =  true
-                            print("entro2 :" + String(retorno))
-                        }else{
-                            retorno = false
-                        }
-                    }else{
-                        retorno = false
-                    }
-                }else{
-                    retorno = false
-                        print("Codigo de error: " + (respuestaAPI?.code.description)!)
-                }
-                }else{
-                    retorno = false
+        var parametros: [String: String] = ["orderBy": "modified"]
+        if let desde = modificadoDesde{
+            parametros["modifiedSince"] = formatoFecha.string(from: desde)
+        }
+        (request, _) = crearSesionRed(url : PaginadorPersonajes.urlProduccion.absoluteString + PaginadorPersonajes.rutaPersonajes, limit: limit, offset: offset, parametros: parametros)
+
+        //Si la pagina esta en cache y no ha caducado no hace falta ir a la red
+        let clave = CacheRespuestas.clave(para: request.url!)
+        if let cuerpo = CacheRespuestas.shared.respuestaVigente(clave: clave){
+            return procesarPagina(datos: cuerpo)
+        }
+        //La cache de URLSession no sirve aqui porque la url cambia en cada llamada
+        request.cachePolicy = .reloadIgnoringLocalCacheData
+        if let etag = CacheRespuestas.shared.etag(clave: clave){
+            request.setValue(etag, forHTTPHeaderField: "If-None-Match")
+        }
+
+        do{
+            let (data, http) = try Traza.shared.intervalo("pagina.descarga", categoria: "red"){
+                try latenciaDescarga.medir{
+                    try TransporteResiliente.shared.enviar(request as URLRequest, prioridad: prioridad)
                 }
- 
-            }catch{
-                print(error)
-                semaforo.leave()
             }
-            semaforo.leave()
-        })
-        task.resume()
-        semaforo.wait()
-        return retorno
+            var cuerpo = data
+            if http.statusCode == 304{
+                cuerpo = CacheRespuestas.shared.revalidar(clave: clave)
+            }else if http.statusCode == 200, let data = data{
+                CacheRespuestas.shared.guardar(data, etag: cabecera("ETag", de: http), clave: clave)
+            }else{
+                return .fallo(ErrorTransporte.servidor(http.statusCode))
+            }
+            return procesarPagina(datos: cuerpo)
+        }catch{
+            return .fallo(error)
+        }
+    }
 
+    //Busca una cabecera de la respuesta sin distinguir mayusculas
+    class func cabecera(_ nombre: String, de respuesta: HTTPURLResponse) -> String?{
+        for (clave, valor) in respuesta.allHeaderFields{
+            if let clave = clave as? String, clave.caseInsensitiveCompare(nombre) == .orderedSame{
+                return valor as? String
+            }
+        }
+        return nil
     }
 
+    //Decodifica una pagina de personajes y los guarda. Una pagina vacia es el final del catalogo;
+    //una respuesta que no se puede leer es un fallo y no debe confundirse con el final
+    class func procesarPagina(datos: Data?) -> ResultadoPagina{
+        let pagina: DataAPI
+        do{
+            pagina = try Traza.shared.intervalo("pagina.decodificacion", categoria: "sincronizacion", argumentos: ["bytes": Double(datos?.count ?? 0)]){
+                try latenciaDecodificacion.medir{
+                    try DecodificadorPagina().decodificar(datos)
+                }
+            }
+        }catch{
+            return .fallo(error)
+        }
+        if pagina.results.isEmpty{
+            return .fin
+        }
+        Traza.shared.intervalo("pagina.guardado", categoria: "sincronizacion", argumentos: ["filas": Double(pagina.results.count)]){
+            latenciaGuardado.medir{
+                crearPersonajes(datos: pagina.results)
+            }
+        }
+        Traza.shared.contador("sincronizacion", valores: ["filas": Double(pagina.results.count), "bytes": Double(datos?.count ?? 0)])
+        return .personajes(pagina.results.count)
+    }
+
+    //Guarda una pagina de personajes. El contexto es de cola privada y tambien lo usan la lista, la
+    //cache de imagenes y el indice de nombres: todo acceso va por performAndWait. Las imagenes se
+    //descargan fuera para no tener el contexto ocupado mientras se espera a la red
     class func crearPersonajes(datos: [CharacterAPI]){
+        let context = CoreDataStack.store.managedObjectContext
+
+        //Buscamos de una vez los heroes que ya tenemos para actualizarlos en lugar de duplicarlos;
+        //el plan descarta los que no han cambiado desde la ultima vez
+        var plan = PlanIngesta(personajes: [], existentes: [:])
+        context.performAndWait {
+            let existentes = heroesExistentes(personajes: datos)
+            plan = PlanIngesta(personajes: datos, existentes: existentes.mapValues { ($0.modificado as Date?) ?? Date.distantPast })
+        }
+        let registros = plan.altas + plan.cambios
+        if registros.isEmpty{
+            return
+        }
+        let imagenes = registros.map { descargarImagen($0.urlImagen) }
 
-        for item in datos{
-            
-            let nombre: String = item.name
-            let descripcion :String = item.descriptionString
-            //let thumbnail = (item as AnyObject).value(forKey: "thumbnail")
-            let rutaImagen: String = item.thumbnail.path
-            let extensionImagen: String = item.thumbnail.extensionString
-            let rutaCompleta: String = rutaImagen + "." + extensionImagen
-            //let rutaCompleta: String = rutaImagen + "." + "jpg"
-            print(rutaCompleta)
-            crearHeroe(nombre: nombre, descripcion: descripcion, imagen: rutaCompleta)
+        //La pagina entera se aplica y se guarda de una vez en la cola del contexto
+        context.performAndWait {
+            let existentes = heroesExistentes(personajes: datos)
+            for (registro, imagen) in zip(registros, imagenes){
+                crearHeroe(id: registro.id, nombre: registro.nombre, descripcion: registro.descripcion, imagen: imagen, modificado: registro.modificado, existente: existentes[registro.id])
+            }
+            CoreDataStack.store.saveContext()
+        }
+    }
+
+    //Devuelve los heroes guardados de los personajes indicados, por su id. Solo lee: se llama dentro
+    //de performAndWait del contexto
+    class func heroesExistentes(personajes: [CharacterAPI]) -> [Int32: Heroe]{
+        let store = CoreDataStack.store
+        let fetchRequest: NSFetchRequest<Heroe> = Heroe.fetchRequest()
+        fetchRequest.predicate = NSPredicate(format: "idMarvel IN %@", personajes.map { $0.id })
+
+        var existentes = [Int32: Heroe]()
+        if let heroes = try? store.managedObjectContext.fetch(fetchRequest){
+            for heroe in heroes{
+                existentes[heroe.idMarvel] = heroe
+            }
         }
+        adoptarHeroesAntiguos(personajes.filter { existentes[$0.id] == nil }, en: &existentes)
+        return existentes
+    }
 
+    //Los heroes guardados antes de que existiera idMarvel se han migrado con idMarvel 0 y sin fecha
+    //de modificacion. La primera vez que llega su personaje se reconocen por el nombre y crearHeroe
+    //les asigna el id, asi se actualizan en lugar de duplicarse. Sin fecha el plan los trata como
+    //cambiados y se guardan con la de la API
+    private class func adoptarHeroesAntiguos(_ personajes: [CharacterAPI], en existentes: inout [Int32: Heroe]){
+        guard !personajes.isEmpty else{
+            return
+        }
+        let fetchRequest: NSFetchRequest<Heroe> = Heroe.fetchRequest()
+        fetchRequest.predicate = NSPredicate(format: "idMarvel == 0 AND nombre IN %@", personajes.map { $0.name })
+        guard let antiguos = try? CoreDataStack.store.managedObjectContext.fetch(fetchRequest), !antiguos.isEmpty else{
+            return
+        }
+        var porNombre = [String: [Heroe]]()
+        for heroe in antiguos{
+            porNombre[heroe.nombre ?? "", default: []].append(heroe)
+        }
+        for personaje in personajes{
+            //Si hay dos con el mismo nombre cada personaje se queda con uno
+            guard let heroe = porNombre[personaje.name]?.popLast() else{
+                continue
+            }
+            existentes[personaje.id] = heroe
+        }
+    }
 
+    //Descarga la imagen de un personaje; nil si no tiene, la url no es valida o la descarga falla
+    class func descargarImagen(_ urlImagen: String?) -> Data?{
+        guard let texto = urlImagen, let url = URL(string: texto) else{
+            return nil
+        }
+        return try? Traza.shared.intervalo("imagen.descarga", categoria: "red"){
+            try Data(contentsOf: url)
+        }
     }
 
-    class func crearHeroe(nombre:String, descripcion: String, imagen: String){
+    //Se llama dentro de performAndWait del contexto; quien llama guarda la pagina al terminar
+    class func crearHeroe(id: Int32, nombre:String, descripcion: String, imagen: Data?, modificado: Date?, existente: NSManagedObject? = nil){
         let store = CoreDataStack.store
-        let heroeEntity = NSEntityDescription.entity(forEntityName: "Heroe", in: store.managedObjectContext)
-        
-        let heroe = NSManagedObject(entity: heroeEntity!,insertInto: store.managedObjectContext)
+        let heroe: NSManagedObject
+        if existente != nil{
+            heroe = existente!
+        }else{
+            let heroeEntity = NSEntityDescription.entity(forEntityName: "Heroe", in: store.managedObjectContext)
+            heroe = NSManagedObject(entity: heroeEntity!,insertInto: store.managedObjectContext)
+        }
+        //Tambien a los heroes antiguos adoptados por nombre
+        heroe.setValue(id, forKey: "idMarvel")
+        if modificado != nil{
+            heroe.setValue(modificado, forKey: "modificado")
+        }
         if nombre  != ""{
             heroe.setValue(nombre, forKey: "nombre")
         }
         if descripcion != ""{
             heroe.setValue(descripcion, forKey: "descripcion")
         }
-        if imagen != ""{
-            let url:NSURL = NSURL(string: imagen)!
-            do{
-                let data:NSData = try NSData(contentsOf: url as URL)
-
-                heroe.setValue(data, forKey: "imagen")
-            }catch{
-                
-            }
+        if let imagen = imagen{
+            heroe.setValue(imagen, forKey: "imagen")
         }
-        store.saveContext()
-        NSLog("Heroe creado")
     }
 }
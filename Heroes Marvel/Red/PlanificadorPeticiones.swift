@@ -0,0 +1,228 @@
+//
+//  PlanificadorPeticiones.swift
+//  Heroes Marvel
+//
+//  Created by Borja Gil Herrero on 19/10/2026.
+//  Copyright © 2026 Alsis GHE. All rights reserved.
+//
+
+import Foundation
+
+//Prioridad de una llamada a la API, de mayor a menor
+enum PrioridadPeticion: Int {
+    //Lo que el usuario esta esperando en pantalla
+    case visible = 0
+    //Datos que probablemente se vayan a ver pronto
+    case precarga
+    //Sincronizacion del catalogo en segundo plano
+    case sincronizacion
+}
+
+//Punto unico por el que pasan todas las llamadas a la API de Marvel, que tiene una cuota diaria.
+//Combina un token bucket que reparte lo que queda de cuota en la proxima hora con un registro
+//de llamadas gastadas y tokens que se guarda entre arranques. Cada prioridad deja una reserva
+//para las superiores: la sincronizacion se pausa (no falla) cuando queda poca cuota y las
+//llamadas visibles nunca esperan detras de ella.
+class PlanificadorPeticiones {
+
+    static let shared = PlanificadorPeticiones()
+
+    static let claveRegistro = "PlanificadorPeticiones.registro"
+
+    //Llamadas al dia que permite la cuenta de la API
+    var cuotaDiaria: Int = 3000
+    //Fraccion de la cuota que solo pueden gastar las prioridades superiores a cada una
+    var reservaVisible: Double = 0.10
+    var reservaPrecarga: Double = 0.05
+    //Tamaño de la rafaga y tokens que la sincronizacion deja siempre libres para lo visible
+    var capacidad: Double = 50
+    var tokensReservadosVisible: Double = 5
+    //Tiempo en el que se podria gastar lo que queda de cuota. El tope diario lo pone el registro;
+    //el ritmo solo suaviza las rafagas, asi que repartir en todo el dia dejaria un relleno del
+    //catalogo en una llamada cada medio minuto
+    var horizonteReparto: TimeInterval = 3600
+
+    private let cola = DispatchQueue(label: "PlanificadorPeticiones")
+    private var pendientes: [[() -> Void]] = [[], [], []]
+    private var tokens: Double = 50
+    private var ultimaReposicion = Date()
+    private var diaRegistro: String
+    private var usadasHoy: Int
+    private var revisionProgramada = false
+    private var pausaHasta: Date? = nil
+
+    private static let formatoDia: DateFormatter = {
+        let formato = DateFormatter()
+        formato.locale = Locale(identifier: "en_US_POSIX")
+        formato.timeZone = TimeZone(identifier: "UTC")
+        formato.dateFormat = "yyyy-MM-dd"
+        return formato
+    }()
+
+    private init() {
+        let registro = UserDefaults.standard.dictionary(forKey: PlanificadorPeticiones.claveRegistro)
+        diaRegistro = registro?["dia"] as? String ?? ""
+        usadasHoy = registro?["usadas"] as? Int ?? 0
+        //Los tokens siguen donde los dejo el ultimo arranque: abrir la app no regala otra rafaga
+        tokens = registro?["tokens"] as? Double ?? tokens
+        ultimaReposicion = registro?["reposicion"] as? Date ?? ultimaReposicion
+    }
+
+    // MARK: - Peticiones
+
+    //Ejecuta el bloque (en una cola global) cuando la cuota y el ritmo lo permiten
+    func solicitar(_ prioridad: PrioridadPeticion, bloque: @escaping () -> Void) {
+        cola.async {
+            self.pendientes[prioridad.rawValue].append(bloque)
+            self.despachar()
+        }
+    }
+
+    //Version bloqueante para los bucles que ya corren en segundo plano
+    func esperarTurno(_ prioridad: PrioridadPeticion) {
+        let semaforo = DispatchSemaphore(value: 0)
+        solicitar(prioridad) {
+            semaforo.signal()
+        }
+        semaforo.wait()
+    }
+
+    //Concede turno solo si puede salir ahora mismo, sin encolar. Sirve para llamadas opcionales
+    //como las peticiones duplicadas del transporte, que no deben esperar ni quitar sitio a otras
+    func intentarTurno(_ prioridad: PrioridadPeticion) -> Bool {
+        return cola.sync {
+            actualizarDia()
+            reponerTokens()
+            guard pendientes[0...prioridad.rawValue].allSatisfy({ $0.isEmpty }), permitida(prioridad.rawValue) else {
+                return false
+            }
+            tokens -= 1
+            usadasHoy += 1
+            guardarRegistro()
+            return true
+        }
+    }
+
+    //El servidor ha contestado 429: no sale nada hasta que pase el tiempo indicado
+    func pausar(durante segundos: TimeInterval) {
+        cola.async {
+            let hasta = Date().addingTimeInterval(segundos)
+            if self.pausaHasta == nil || self.pausaHasta! < hasta {
+                self.pausaHasta = hasta
+            }
+            self.tokens = 0
+            self.guardarRegistro()
+        }
+    }
+
+    //Llamadas que quedan hoy segun el registro
+    var restantesHoy: Int {
+        return cola.sync {
+            actualizarDia()
+            return max(0, cuotaDiaria - usadasHoy)
+        }
+    }
+
+    // MARK: - Planificacion
+
+    private func despachar() {
+        actualizarDia()
+        reponerTokens()
+
+        while let prioridad = siguientePrioridadPermitida() {
+            let bloque = pendientes[prioridad].removeFirst()
+            tokens -= 1
+            usadasHoy += 1
+            DispatchQueue.global(qos: prioridad == PrioridadPeticion.visible.rawValue ? .userInitiated : .utility).async(execute: bloque)
+        }
+        guardarRegistro()
+
+        if pendientes.contains(where: { !$0.isEmpty }) {
+            programarRevision()
+        }
+    }
+
+    //La prioridad mas alta con algo pendiente que pueda salir ahora mismo
+    private func siguientePrioridadPermitida() -> Int? {
+        for prioridad in 0..<pendientes.count where !pendientes[prioridad].isEmpty {
+            if permitida(prioridad) {
+                return prioridad
+            }
+            //Las inferiores tampoco pasan si esta no puede: no adelantan a las visibles
+            return nil
+        }
+        return nil
+    }
+
+    private func permitida(_ prioridad: Int) -> Bool {
+        if let hasta = pausaHasta {
+            if hasta > Date() {
+                return false
+            }
+            pausaHasta = nil
+        }
+        let restantes = Double(cuotaDiaria - usadasHoy)
+        let cuota = Double(cuotaDiaria)
+        switch prioridad {
+        case PrioridadPeticion.visible.rawValue:
+            return tokens >= 1 && restantes >= 1
+        case PrioridadPeticion.precarga.rawValue:
+            return tokens >= 1 + tokensReservadosVisible && restantes > cuota * reservaVisible
+        default:
+            return tokens >= 1 + tokensReservadosVisible && restantes > cuota * (reservaVisible + reservaPrecarga)
+        }
+    }
+
+    private func reponerTokens() {
+        let ahora = Date()
+        tokens = min(capacidad, tokens + max(0, ahora.timeIntervalSince(ultimaReposicion)) * ritmo())
+        ultimaReposicion = ahora
+    }
+
+    //Tokens por segundo: la cuota que queda hoy repartida en el horizonte, o en lo que falte de dia si es menos
+    private func ritmo() -> Double {
+        let restantes = Double(max(1, cuotaDiaria - usadasHoy))
+        return restantes / max(min(horizonteReparto, segundosHastaCambioDeDia()), 1)
+    }
+
+    private func programarRevision() {
+        guard !revisionProgramada else {
+            return
+        }
+        revisionProgramada = true
+        //Lo que falta para el siguiente token, o hasta el cambio de dia si la cuota esta agotada
+        var espera = max(0.05, (1 + tokensReservadosVisible - tokens) / ritmo())
+        if usadasHoy >= cuotaDiaria {
+            espera = segundosHastaCambioDeDia() + 1
+        }
+        if let hasta = pausaHasta {
+            espera = max(espera, hasta.timeIntervalSinceNow)
+        }
+        cola.asyncAfter(deadline: .now() + min(espera, 60)) {
+            self.revisionProgramada = false
+            self.despachar()
+        }
+    }
+
+    // MARK: - Registro de cuota
+
+    private func actualizarDia() {
+        let hoy = PlanificadorPeticiones.formatoDia.string(from: Date())
+        if hoy != diaRegistro {
+            diaRegistro = hoy
+            usadasHoy = 0
+        }
+    }
+
+    private func guardarRegistro() {
+        UserDefaults.standard.set(["dia": diaRegistro, "usadas": usadasHoy, "tokens": tokens, "reposicion": ultimaReposicion],
+                                  forKey: PlanificadorPeticiones.claveRegistro)
+    }
+
+    private func segundosHastaCambioDeDia() -> TimeInterval {
+        var calendario = Calendar(identifier: .gregorian)
+        calendario.timeZone = TimeZone(identifier: "UTC")!
+        let siguienteDia = calendario.startOfDay(for: Date()).addingTimeInterval(86400)
+        return siguienteDia.timeIntervalSinceNow
+    }
+}
@@ -0,0 +1,185 @@
+//
+//  TransporteResiliente.swift
+//  Heroes Marvel
+//
+//  Created by Borja Gil Herrero on 19/10/2026.
+//  Copyright © 2026 Alsis GHE. All rights reserved.
+//
+
+import Foundation
+
+//Errores del transporte una vez agotados los reintentos
+enum ErrorTransporte: Error {
+    //Fallo de conexion sin respuesta del servidor
+    case red(Error)
+    //429, se ha superado el limite de llamadas
+    case limiteExcedido
+    //5xx
+    case servidor(Int)
+    //Respuesta vacia o que no se puede decodificar
+    case respuestaInvalida
+}
+
+//Capa de transporte para las llamadas a la API:
+// - reintenta los fallos transitorios (red, 429 y 5xx) con espera exponencial y jitter,
+//   respetando Retry-After y pausando el planificador cuando el servidor contesta 429;
+// - si una peticion tarda mas que el p95 de las ultimas, lanza un duplicado (si el planificador
+//   tiene cuota libre en ese momento) y se queda con la primera respuesta, cancelando la otra.
+//Las llamadas son sincronas: se usan desde bucles que ya corren en segundo plano.
+class TransporteResiliente {
+
+    static let shared = TransporteResiliente()
+
+    var session: URLSession = URLSession.shared
+    var intentosMaximos = 5
+    var esperaBase: TimeInterval = 0.5
+    var esperaMaxima: TimeInterval = 30
+    //Muestras necesarias antes de empezar a duplicar peticiones lentas
+    var muestrasMinimasDuplicado = 20
+
+    private let cerrojo = NSLock()
+    private var latencias = [TimeInterval]()
+    private var posicionLatencia = 0
+    private let muestrasLatencia = 128
+
+    // MARK: - Envio
+
+    //Envia la peticion con reintentos. Devuelve la respuesta para los 2xx, el 304 y los 4xx que no
+    //tiene sentido repetir; lanza ErrorTransporte si el fallo persiste tras todos los intentos
+    func enviar(_ request: URLRequest, prioridad: PrioridadPeticion) throws -> (Data?, HTTPURLResponse) {
+        var ultimoError: ErrorTransporte = .respuestaInvalida
+        for intento in 0..<intentosMaximos {
+            if intento > 0 {
+                Thread.sleep(forTimeInterval: espera(intento: intento, minima: 0))
+            }
+            PlanificadorPeticiones.shared.esperarTurno(prioridad)
+
+            let (data, response, error) = enviarConDuplicado(request, prioridad: prioridad)
+            guard let http = response as? HTTPURLResponse else {
+                if let error = error, !esReintentable(error) {
+                    throw ErrorTransporte.red(error)
+                }
+                ultimoError = error.map { ErrorTransporte.red($0) } ?? .respuestaInvalida
+                continue
+            }
+
+            switch http.statusCode {
+            case 429:
+                ultimoError = .limiteExcedido
+                let pausa = espera(intento: intento + 1, minima: retryAfter(http) ?? 0)
+                PlanificadorPeticiones.shared.pausar(durante: pausa)
+            case 500, 502, 503, 504:
+                ultimoError = .servidor(http.statusCode)
+            default:
+                return (data, http)
+            }
+        }
+        throw ultimoError
+    }
+
+    //Espera antes de un reintento: jitter completo sobre una exponencial acotada
+    private func espera(intento: Int, minima: TimeInterval) -> TimeInterval {
+        let techo = min(esperaMaxima, esperaBase * pow(2, Double(intento)))
+        return max(minima, Double.random(in: 0...techo))
+    }
+
+    private func esReintentable(_ error: Error) -> Bool {
+        guard let error = error as? URLError else {
+            return false
+        }
+        switch error.code {
+        case .timedOut, .networkConnectionLost, .notConnectedToInternet, .cannotConnectToHost,
+             .cannotFindHost, .dnsLookupFailed, .resourceUnavailable, .cannotParseResponse, .badServerResponse:
+            return true
+        default:
+            return false
+        }
+    }
+
+    private func retryAfter(_ respuesta: HTTPURLResponse) -> TimeInterval? {
+        return MarvelRed.cabecera("Retry-After", de: respuesta).flatMap { TimeInterval($0) }
+    }
+
+    // MARK: - Peticiones duplicadas
+
+    //Lanza la peticion y, si supera el p95 de latencia, un duplicado. Gana la primera respuesta
+    //valida; la otra tarea se cancela
+    private func enviarConDuplicado(_ request: URLRequest, prioridad: PrioridadPeticion) -> (Data?, URLResponse?, Error?) {
+        let estado = NSLock()
+        let terminado = DispatchSemaphore(value: 0)
+        var resultado: (Data?, URLResponse?, Error?)? = nil
+        var tareas = [URLSessionDataTask]()
+        var enCurso = 0
+        let inicio = Date()
+
+        func lanzar() {
+            var tarea: URLSessionDataTask! = nil
+            tarea = session.dataTask(with: request) { data, response, error in
+                estado.lock()
+                enCurso -= 1
+                let valida = error == nil && response != nil
+                //Un fallo solo cuenta si no queda otra peticion que pueda contestar
+                if resultado == nil && (valida || enCurso == 0) {
+                    resultado = (data, response, error)
+                    if valida {
+                        self.registrarLatencia(Date().timeIntervalSince(inicio))
+                    }
+                    for otra in tareas where otra !== tarea {
+                        otra.cancel()
+                    }
+                    terminado.signal()
+                }
+                estado.unlock()
+            }
+            estado.lock()
+            tareas.append(tarea)
+            enCurso += 1
+            estado.unlock()
+            tarea.resume()
+        }
+
+        lanzar()
+        if let umbral = percentil95() {
+            if terminado.wait(timeout: .now() + umbral) == .timedOut {
+                estado.lock()
+                let pendiente = resultado == nil
+                estado.unlock()
+                if pendiente && PlanificadorPeticiones.shared.intentarTurno(prioridad) {
+                    lanzar()
+                }
+                terminado.wait()
+            }
+        } else {
+            terminado.wait()
+        }
+
+        estado.lock()
+        defer { estado.unlock() }
+        //Por si el duplicado salio justo cuando la primera ya habia terminado
+        for tarea in tareas {
+            tarea.cancel()
+        }
+        return resultado!
+    }
+
+    private func registrarLatencia(_ latencia: TimeInterval) {
+        cerrojo.lock()
+        if latencias.count < muestrasLatencia {
+            latencias.append(latencia)
+        } else {
+            latencias[posicionLatencia] = latencia
+            posicionLatencia = (posicionLatencia + 1) % muestrasLatencia
+        }
+        cerrojo.unlock()
+    }
+
+    private func percentil95() -> TimeInterval? {
+        cerrojo.lock()
+        defer { cerrojo.unlock() }
+        guard latencias.count >= muestrasMinimasDuplicado else {
+            return nil
+        }
+        let ordenadas = latencias.sorted()
+        return ordenadas[Int(Double(ordenadas.count - 1) * 0.95)]
+    }
+}
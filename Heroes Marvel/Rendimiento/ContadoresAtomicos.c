@@ -0,0 +1,57 @@
+//
+//  ContadoresAtomicos.c
+//  Heroes Marvel
+//
+//  Created by Borja Gil Herrero on 19/10/2026.
+//  Copyright © 2026 Alsis GHE. All rights reserved.
+//
+
+#include "ContadoresAtomicos.h"
+
+#include <stdatomic.h>
+#include <stdlib.h>
+
+struct contadores_atomicos {
+    int32_t numero;
+    _Atomic int64_t valores[];
+};
+
+contadores_atomicos_t *contadores_crear(int32_t numero) {
+    if (numero < 0) {
+        return NULL;
+    }
+    contadores_atomicos_t *contadores = malloc(sizeof(contadores_atomicos_t) + (size_t)numero * sizeof(_Atomic int64_t));
+    if (contadores == NULL) {
+        return NULL;
+    }
+    contadores->numero = numero;
+    for (int32_t indice = 0; indice < numero; indice++) {
+        atomic_init(&contadores->valores[indice], 0);
+    }
+    return contadores;
+}
+
+void contadores_destruir(contadores_atomicos_t *contadores) {
+    free(contadores);
+}
+
+void contadores_sumar(contadores_atomicos_t *contadores, int32_t indice, int64_t cantidad) {
+    atomic_fetch_add_explicit(&contadores->valores[indice], cantidad, memory_order_relaxed);
+}
+
+void contadores_maximo(contadores_atomicos_t *contadores, int32_t indice, int64_t valor) {
+    int64_t actual = atomic_load_explicit(&contadores->valores[indice], memory_order_relaxed);
+    //Si otro hilo lo cambia entre medias, actual recibe el valor nuevo y se vuelve a comparar
+    while (valor > actual && !atomic_compare_exchange_weak_explicit(&contadores->valores[indice], &actual, valor, memory_order_relaxed, memory_order_relaxed)) {
+    }
+}
+
+int64_t contadores_leer(const contadores_atomicos_t *contadores, int32_t indice) {
+    return atomic_load_explicit((_Atomic int64_t *)&contadores->valores[indice], memory_order_relaxed);
+}
+
+void contadores_reiniciar(contadores_atomicos_t *contadores) {
+    for (int32_t indice = 0; indice < contadores->numero; indice++) {
+        atomic_store_explicit(&contadores->valores[indice], 0, memory_order_relaxed);
+    }
+}
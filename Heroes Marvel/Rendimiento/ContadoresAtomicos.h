@@ -0,0 +1,34 @@
+//
+//  ContadoresAtomicos.h
+//  Heroes Marvel
+//
+//  Created by Borja Gil Herrero on 19/10/2026.
+//  Copyright © 2026 Alsis GHE. All rights reserved.
+//
+//  Bloque de contadores de 64 bits con atomicos de C11, para los caminos calientes que no deben
+//  esperar a un cerrojo (los histogramas de Latencias.swift). Swift 4.2 no tiene atomicos
+//  propios, asi que el bloque se reserva aqui y Swift solo ve un puntero opaco.
+//  Todas las operaciones son relaxed: cada contador es exacto por si solo, pero leer varios no
+//  da una foto consistente entre ellos.
+//
+
+#ifndef ContadoresAtomicos_h
+#define ContadoresAtomicos_h
+
+#include <stdint.h>
+
+typedef struct contadores_atomicos contadores_atomicos_t;
+
+//Reserva numero contadores a cero; NULL si no hay memoria
+contadores_atomicos_t *contadores_crear(int32_t numero);
+void contadores_destruir(contadores_atomicos_t *contadores);
+
+//Suma cantidad al contador indice
+void contadores_sumar(contadores_atomicos_t *contadores, int32_t indice, int64_t cantidad);
+//Sube el contador indice a valor si es mayor que el que tiene
+void contadores_maximo(contadores_atomicos_t *contadores, int32_t indice, int64_t valor);
+int64_t contadores_leer(const contadores_atomicos_t *contadores, int32_t indice);
+//Pone todos a cero
+void contadores_reiniciar(contadores_atomicos_t *contadores);
+
+#endif
@@ -0,0 +1,125 @@
+//
+//  GobernadorMemoria.swift
+//  Heroes Marvel
+//
+//  Created by Borja Gil Herrero on 19/10/2026.
+//  Copyright © 2026 Alsis GHE. All rights reserved.
+//
+
+import UIKit
+import Redbeard
+
+//Orden en que se vacian las caches cuando falta memoria: primero lo que mas ocupa y antes se
+//recupera (imagenes decodificadas), despues los bytes codificados y por ultimo las filas de Core Data
+enum NivelCache: Int {
+    case imagenesDecodificadas = 0
+    case bytesCodificados
+    case filasCoreData
+}
+
+//Reparte la presion de memoria entre las caches registradas. Con el aviso temprano del sistema
+//(DispatchSource de presion de memoria) vacia los dos primeros niveles; con el aviso critico o
+//el memory warning de UIKit, todos. Deja registrado cuanto se ha liberado de cada cache y
+//cuanto ha bajado la huella de memoria del proceso.
+final class GobernadorMemoria: NSObject, RBAppDelegateObserver {
+
+    static let shared = GobernadorMemoria()
+
+    //Una cache registrada: coste devuelve los bytes aproximados que ocupa ahora
+    private struct Registro {
+        let nombre: String
+        let nivel: NivelCache
+        let coste: () -> Int
+        let liberar: () -> Void
+    }
+
+    //Lo que se libero en una actuacion del gobernador
+    struct Informe {
+        let fecha: Date
+        let nivelMaximo: NivelCache
+        //Nombre de la cache -> bytes liberados
+        let liberado: [(String, Int)]
+        let huellaAntes: Int
+        let huellaDespues: Int
+    }
+
+    private let cerrojo = NSLock()
+    private var registros = [Registro]()
+    private var fuentePresion: DispatchSourceMemoryPressure?
+    private(set) var historial = [Informe]()
+    private let historialMaximo = 20
+
+    func registrar(_ nombre: String, nivel: NivelCache, coste: @escaping () -> Int, liberar: @escaping () -> Void) {
+        cerrojo.lock()
+        registros.append(Registro(nombre: nombre, nivel: nivel, coste: coste, liberar: liberar))
+        registros.sort { $0.nivel.rawValue < $1.nivel.rawValue }
+        cerrojo.unlock()
+    }
+
+    //Escucha los avisos de presion de memoria del sistema, que llegan antes que el memory warning
+    func iniciar() {
+        guard fuentePresion == nil else {
+            return
+        }
+        let fuente = DispatchSource.makeMemoryPressureSource(eventMask: [.warning, .critical], queue: .main)
+        fuente.setEventHandler { [weak self, weak fuente] in
+            guard let evento = fuente?.data else {
+                return
+            }
+            self?.liberar(hasta: evento.contains(.critical) ? .filasCoreData : .bytesCodificados)
+        }
+        fuente.resume()
+        fuentePresion = fuente
+    }
+
+    // MARK: - RBAppDelegateObserver
+
+    func applicationDidReceiveMemoryWarning() {
+        liberar(hasta: .filasCoreData)
+    }
+
+    // MARK: - Liberacion
+
+    //Vacia por orden todas las caches hasta el nivel indicado, incluido
+    @discardableResult
+    func liberar(hasta nivelMaximo: NivelCache) -> Informe {
+        cerrojo.lock()
+        let seleccion = registros.filter { $0.nivel.rawValue <= nivelMaximo.rawValue }
+        cerrojo.unlock()
+
+        let huellaAntes = GobernadorMemoria.huellaMemoria()
+        var liberado = [(String, Int)]()
+        for registro in seleccion {
+            let antes = registro.coste()
+            registro.liberar()
+            liberado.append((registro.nombre, max(0, antes - registro.coste())))
+        }
+        let informe = Informe(fecha: Date(), nivelMaximo: nivelMaximo, liberado: liberado,
+                              huellaAntes: huellaAntes, huellaDespues: GobernadorMemoria.huellaMemoria())
+
+        cerrojo.lock()
+        historial.append(informe)
+        if historial.count > historialMaximo {
+            historial.removeFirst()
+        }
+        cerrojo.unlock()
+
+        let detalle = liberado.map { "\($0.0) \($0.1 / 1024) KB" }.joined(separator: ", ")
+        NSLog("Memoria: liberado hasta \(nivelMaximo) (\(detalle)); huella \(informe.huellaAntes / 1_048_576) MB -> \(informe.huellaDespues / 1_048_576) MB")
+        Traza.shared.marca("memoria.liberar", categoria: "memoria")
+        Traza.shared.contador("memoria", valores: ["huellaMB": Double(informe.huellaDespues) / 1_048_576])
+        return informe
+    }
+
+    //Huella de memoria del proceso (phys_footprint), la que usa el sistema para decidir a quien cierra
+    class func huellaMemoria() -> Int {
+        var informacion = task_vm_info_data_t()
+        var cuenta = mach_msg_type_number_t(MemoryLayout<task_vm_info_data_t>.size / MemoryLayout<integer_t>.size)
+        let resultado = withUnsafeMutablePointer(to: &informacion) {
+            $0.withMemoryRebound(to: integer_t.self, capacity: Int(cuenta)) {
+                task_info(mach_task_self_, task_flavor_t(TASK_VM_INFO), $0, &cuenta)
+            }
+        }
+        return resultado == KERN_SUCCESS ? Int(informacion.phys_footprint) : 0
+    }
+}
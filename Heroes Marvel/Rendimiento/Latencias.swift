@@ -0,0 +1,205 @@
+//
+//  Latencias.swift
+//  Heroes Marvel
+//
+//  Created by Borja Gil Herrero on 19/10/2026.
+//  Copyright © 2026 Alsis GHE. All rights reserved.
+//
+
+import Foundation
+import Redbeard
+
+//Resumen de un histograma en un instante, para exportar o pintar
+struct InstantaneaLatencia {
+    let nombre: String
+    let muestras: Int
+    //Todo en milisegundos
+    let media: Double
+    let p50: Double
+    let p90: Double
+    let p99: Double
+    let maximo: Double
+
+    var json: [String: Any] {
+        return ["nombre": nombre, "muestras": muestras, "media_ms": media, "p50_ms": p50, "p90_ms": p90, "p99_ms": p99, "max_ms": maximo]
+    }
+}
+
+//Histograma de latencias al estilo HDR: cubos logaritmicos con 16 subdivisiones lineales por
+//potencia de dos sobre microsegundos, asi que cualquier percentil tiene un error relativo menor
+//del 6,25% desde 1 µs hasta varios dias. Los contadores se reservan al crearlo y son atomicos de
+//C11 (ContadoresAtomicos.c): registrar no espera a ningun cerrojo ni reserva memoria, asi que se
+//puede llamar desde cualquier cola.
+final class HistogramaLatencia {
+
+    //Valores por debajo de este limite tienen cubo propio; a partir de ahi 16 por potencia de dos
+    private static let subcubos = 16
+    private static let bitsSubcubo = 4
+    private static let exponenteMaximo = 40
+    static let numeroCubos = subcubos + (exponenteMaximo - bitsSubcubo + 1) * subcubos
+
+    let nombre: String
+
+    //Un contador por cubo y detras la suma y el maximo
+    private static let indiceSuma = Int32(numeroCubos)
+    private static let indiceMaximo = Int32(numeroCubos + 1)
+    private let contadores: OpaquePointer
+
+    fileprivate init(nombre: String) {
+        self.nombre = nombre
+        contadores = contadores_crear(Int32(HistogramaLatencia.numeroCubos + 2))
+    }
+
+    deinit {
+        contadores_destruir(contadores)
+    }
+
+    // MARK: - Registro
+
+    func registrar(_ segundos: TimeInterval) {
+        registrar(microsegundos: Int64(max(0, segundos) * 1_000_000))
+    }
+
+    //Mide un bloque sincrono. El bloque no escapa, asi que no reserva memoria
+    @discardableResult
+    func medir<T>(_ bloque: () throws -> T) rethrows -> T {
+        let inicio = DispatchTime.now().uptimeNanoseconds
+        defer { registrar(microsegundos: Int64((DispatchTime.now().uptimeNanoseconds - inicio) / 1000)) }
+        return try bloque()
+    }
+
+    //Mide una tarea asincrona con RBThreading: la tarea llama a terminado() cuando acaba. Reserva
+    //los bloques, no es para caminos calientes
+    func medirTarea(_ tarea: @escaping (_ terminado: @escaping () -> Void) -> Void) {
+        RBThreading.measureTask({ terminado in
+            tarea(terminado)
+        }, completion: { segundos in
+            self.registrar(segundos)
+        })
+    }
+
+    func registrar(microsegundos valor: Int64) {
+        contadores_sumar(contadores, Int32(HistogramaLatencia.cubo(valor)), 1)
+        contadores_sumar(contadores, HistogramaLatencia.indiceSuma, valor)
+        contadores_maximo(contadores, HistogramaLatencia.indiceMaximo, valor)
+    }
+
+    // MARK: - Cubos
+
+    private class func cubo(_ valor: Int64) -> Int {
+        guard valor >= Int64(subcubos) else {
+            return Int(max(0, valor))
+        }
+        let exponente = min(63 - valor.leadingZeroBitCount, exponenteMaximo)
+        let subcubo = Int(valor >> Int64(exponente - bitsSubcubo)) & (subcubos - 1)
+        return subcubos + (exponente - bitsSubcubo) * subcubos + min(subcubo, subcubos - 1)
+    }
+
+    //Mayor valor que cae en el cubo, en microsegundos
+    private class func limiteSuperior(_ cubo: Int) -> Int64 {
+        guard cubo >= subcubos else {
+            return Int64(cubo)
+        }
+        let exponente = (cubo - subcubos) / subcubos + bitsSubcubo
+        let subcubo = Int64((cubo - subcubos) % subcubos)
+        let ancho = Int64(1) << Int64(exponente - bitsSubcubo)
+        return (Int64(subcubos) + subcubo) * ancho + ancho - 1
+    }
+
+    // MARK: - Lectura
+
+    //Copia los contadores sin parar a los que registran. Un registro que llegue a mitad de la copia
+    //puede contar en unos contadores y no en otros; la desviacion se limita a las muestras que
+    //entran mientras se copia, que para exportar o pintar da igual
+    func instantanea() -> InstantaneaLatencia {
+        let copia = (0..<HistogramaLatencia.numeroCubos).map { contadores_leer(contadores, Int32($0)) }
+        let sumaActual = contadores_leer(contadores, HistogramaLatencia.indiceSuma)
+        let maximoActual = contadores_leer(contadores, HistogramaLatencia.indiceMaximo)
+        let muestras = copia.reduce(0, +)
+
+        func percentil(_ fraccion: Double) -> Double {
+            let objetivo = Int64((Double(muestras) * fraccion).rounded(.up))
+            var acumuladas: Int64 = 0
+            for (cubo, cuenta) in copia.enumerated() {
+                acumuladas += cuenta
+                if acumuladas >= objetivo {
+                    return Double(min(HistogramaLatencia.limiteSuperior(cubo), maximoActual)) / 1000
+                }
+            }
+            return Double(maximoActual) / 1000
+        }
+
+        return InstantaneaLatencia(nombre: nombre, muestras: Int(muestras),
+                                   media: muestras > 0 ? Double(sumaActual) / Double(muestras) / 1000 : 0,
+                                   p50: percentil(0.5), p90: percentil(0.9), p99: percentil(0.99),
+                                   maximo: Double(maximoActual) / 1000)
+    }
+
+    func reiniciar() {
+        contadores_reiniciar(contadores)
+    }
+}
+
+//Registro de histogramas por nombre. Cada punto que se mide pide su histograma una sola vez
+//(normalmente en un static let) y a partir de ahi registra sobre el sin pasar por el registro:
+//
+//    static let latenciaGuardado = RegistroLatencias.shared.histograma("pagina.guardado")
+//    ...
+//    latenciaGuardado.medir { try context.save() }
+final class RegistroLatencias {
+
+    static let shared = RegistroLatencias()
+
+    private let cerrojo = NSLock()
+    private var histogramas = [String: HistogramaLatencia]()
+
+    //Devuelve el histograma con ese nombre, creandolo la primera vez
+    func histograma(_ nombre: String) -> HistogramaLatencia {
+        cerrojo.lock()
+        defer { cerrojo.unlock() }
+        if let existente = histogramas[nombre] {
+            return existente
+        }
+        let nuevo = HistogramaLatencia(nombre: nombre)
+        histogramas[nombre] = nuevo
+        return nuevo
+    }
+
+    func instantaneas() -> [InstantaneaLatencia] {
+        cerrojo.lock()
+        let todos = Array(histogramas.values)
+        cerrojo.unlock()
+        return todos.map { $0.instantanea() }.sorted { $0.nombre < $1.nombre }
+    }
+
+    //Tabla de texto para el log
+    func resumen() -> String {
+        return instantaneas().filter { $0.muestras > 0 }.map {
+            "\($0.nombre): n=\($0.muestras) p50=\(RegistroLatencias.texto($0.p50)) p90=\(RegistroLatencias.texto($0.p90)) p99=\(RegistroLatencias.texto($0.p99)) max=\(RegistroLatencias.texto($0.maximo)) ms"
+        }.joined(separator: "\n")
+    }
+
+    //Exporta a Documents/Trazas junto a la traza, solo si la traza esta activa
+    @discardableResult
+    func exportarADocumentos(prefijo: String) -> URL? {
+        guard Traza.shared.activa else {
+            return nil
+        }
+        let documentos = FileManager.default.urls(for: .documentDirectory, in: .userDomainMask)[0]
+        let directorio = documentos.appendingPathComponent("Trazas", isDirectory: true)
+        let url = directorio.appendingPathComponent("\(prefijo)-\(Int(Date().timeIntervalSince1970)).json")
+        do {
+            let datos = try JSONSerialization.data(withJSONObject: ["latencias": instantaneas().map { $0.json }], options: [.prettyPrinted])
+            try FileManager.default.createDirectory(at: directorio, withIntermediateDirectories: true, attributes: nil)
+            try datos.write(to: url, options: .atomic)
+            return url
+        } catch {
+            NSLog("No se han podido exportar las latencias: \(error)")
+            return nil
+        }
+    }
+
+    private class func texto(_ valor: Double) -> String {
+        return String(format: "%.2f", valor)
+    }
+}
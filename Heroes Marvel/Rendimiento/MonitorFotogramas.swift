@@ -0,0 +1,199 @@
+//
+//  MonitorFotogramas.swift
+//  Heroes Marvel
+//
+//  Created by Borja Gil Herrero on 19/10/2026.
+//  Copyright © 2026 Alsis GHE. All rights reserved.
+//
+
+import UIKit
+
+//Trabajo del hilo principal al que se le puede echar la culpa de un tiron
+enum TrabajoPrincipal: Int {
+    case configuracionCelda = 0
+    case imagen
+    case cambiosFRC
+    case recargaLista
+
+    static let todos: [TrabajoPrincipal] = [.configuracionCelda, .imagen, .cambiosFRC, .recargaLista]
+}
+
+//Mide los frames perdidos mientras se hace scroll. El CADisplayLink se añade solo al modo
+//tracking del run loop, asi que solo hace tick mientras el usuario arrastra o la lista decelera
+//y fuera del scroll no cuesta nada. Cada tiron se atribuye a la pantalla cuyo scroll view se
+//esta moviendo y al trabajo del hilo principal que mas tiempo ha ocupado desde el frame anterior.
+//Al cerrar la sesion (al pasar a segundo plano) el porcentaje de frames perdidos va a la
+//telemetria y el informe con los peores culpables al log.
+//Todo se usa desde el hilo principal.
+final class MonitorFotogramas {
+
+    static let shared = MonitorFotogramas()
+
+    //Un frame que tarda mas de esto veces lo esperado cuenta como tiron
+    static let umbralTiron = 1.5
+    static let sinAtribuir = "otro"
+
+    private struct Pantalla {
+        weak var scrollView: UIScrollView?
+        let nombre: String
+    }
+
+    //Tirones acumulados por pantalla y trabajo
+    private struct Culpable {
+        var tirones = 0
+        var fotogramasPerdidos = 0
+        var tiempoPerdido: CFTimeInterval = 0
+    }
+
+    //Frames esperados y perdidos, por separado con y sin sincronizacion en marcha
+    private struct Recuento {
+        var esperados = 0
+        var perdidos = 0
+
+        var ratio: Double {
+            return esperados > 0 ? Double(perdidos) / Double(esperados) * 100 : 0
+        }
+    }
+
+    private var pantallas = [Pantalla]()
+    private var enlace: CADisplayLink?
+    private var observadorModo: CFRunLoopObserver?
+    private var ultimoTick: CFTimeInterval? = nil
+    private var trabajoFotograma = [CFTimeInterval](repeating: 0, count: TrabajoPrincipal.todos.count)
+    private var culpables = [String: Culpable]()
+    private var conSincronizacion = Recuento()
+    private var sinSincronizacion = Recuento()
+
+    //Lo pone la sincronizacion para separar los tirones que provoca
+    var sincronizando = false
+
+    // MARK: - Configuracion
+
+    //Cada pantalla con lista registra su scroll view (UITableView, RBLazyLayoutView...)
+    func observar(_ scrollView: UIScrollView, pantalla: String) {
+        pantallas = pantallas.filter { $0.scrollView != nil && $0.scrollView !== scrollView }
+        pantallas.append(Pantalla(scrollView: scrollView, nombre: pantalla))
+    }
+
+    func iniciar() {
+        guard enlace == nil else {
+            return
+        }
+        let enlace = CADisplayLink(target: self, selector: #selector(tick(_:)))
+        enlace.add(to: .main, forMode: .tracking)
+        self.enlace = enlace
+
+        //Cada vez que se entra en el modo tracking empieza un scroll nuevo: el hueco desde el
+        //ultimo tick del scroll anterior no es un tiron
+        let modo = CFRunLoopMode(RunLoop.Mode.tracking.rawValue as CFString)
+        let observador = CFRunLoopObserverCreateWithHandler(nil, CFRunLoopActivity.entry.rawValue, true, 0) { [unowned self] _, _ in
+            self.ultimoTick = nil
+        }
+        CFRunLoopAddObserver(CFRunLoopGetMain(), observador, modo)
+        observadorModo = observador
+    }
+
+    // MARK: - Trabajo del hilo principal
+
+    //Mide un trabajo del hilo principal para poder atribuirle los tirones. Sin reservas de memoria
+    @discardableResult
+    func medir<T>(_ trabajo: TrabajoPrincipal, _ bloque: () throws -> T) rethrows -> T {
+        let inicio = CACurrentMediaTime()
+        defer { trabajoFotograma[trabajo.rawValue] += CACurrentMediaTime() - inicio }
+        return try bloque()
+    }
+
+    // MARK: - Frames
+
+    @objc private func tick(_ enlace: CADisplayLink) {
+        defer {
+            ultimoTick = enlace.timestamp
+            for posicion in 0..<trabajoFotograma.count {
+                trabajoFotograma[posicion] = 0
+            }
+        }
+        guard let anterior = ultimoTick else {
+            return
+        }
+        let esperado = enlace.targetTimestamp - enlace.timestamp
+        guard esperado > 0 else {
+            return
+        }
+        let transcurrido = enlace.timestamp - anterior
+        let fotogramas = max(1, Int((transcurrido / esperado).rounded()))
+        let perdidos = transcurrido > esperado * MonitorFotogramas.umbralTiron ? fotogramas - 1 : 0
+
+        if sincronizando {
+            conSincronizacion.esperados += fotogramas
+            conSincronizacion.perdidos += perdidos
+        } else {
+            sinSincronizacion.esperados += fotogramas
+            sinSincronizacion.perdidos += perdidos
+        }
+        guard perdidos > 0 else {
+            return
+        }
+
+        let clave = "\(pantallaEnMovimiento())|\(culpableFotograma())"
+        var culpable = culpables[clave] ?? Culpable()
+        culpable.tirones += 1
+        culpable.fotogramasPerdidos += perdidos
+        culpable.tiempoPerdido += transcurrido - esperado
+        culpables[clave] = culpable
+        Traza.shared.marca("tiron", categoria: "lista")
+    }
+
+    private func pantallaEnMovimiento() -> String {
+        for pantalla in pantallas {
+            if let scrollView = pantalla.scrollView, scrollView.window != nil,
+                scrollView.isTracking || scrollView.isDragging || scrollView.isDecelerating {
+                return pantalla.nombre
+            }
+        }
+        return "desconocida"
+    }
+
+    private func culpableFotograma() -> String {
+        var mayor: TrabajoPrincipal? = nil
+        for trabajo in TrabajoPrincipal.todos where trabajoFotograma[trabajo.rawValue] > 0 {
+            if mayor == nil || trabajoFotograma[trabajo.rawValue] > trabajoFotograma[mayor!.rawValue] {
+                mayor = trabajo
+            }
+        }
+        return mayor.map { "\($0)" } ?? MonitorFotogramas.sinAtribuir
+    }
+
+    // MARK: - Sesion
+
+    //Porcentaje de frames perdidos durante el scroll en lo que va de sesion
+    var ratioTirones: Double {
+        var total = conSincronizacion
+        total.esperados += sinSincronizacion.esperados
+        total.perdidos += sinSincronizacion.perdidos
+        return total.ratio
+    }
+
+    //Los peores culpables por tiempo perdido
+    func informe(maximo: Int = 10) -> String {
+        var lineas = ["Scroll: \(String(format: "%.2f", ratioTirones))% de frames perdidos (con sincronizacion \(String(format: "%.2f", conSincronizacion.ratio))%, sin \(String(format: "%.2f", sinSincronizacion.ratio))%)"]
+        let peores = culpables.sorted { $0.value.tiempoPerdido > $1.value.tiempoPerdido }.prefix(maximo)
+        for (clave, culpable) in peores {
+            lineas.append("  \(clave): \(culpable.tirones) tirones, \(culpable.fotogramasPerdidos) frames, \(Int(culpable.tiempoPerdido * 1000)) ms")
+        }
+        return lineas.joined(separator: "\n")
+    }
+
+    //Manda el ratio de la sesion a la telemetria, escribe el informe y empieza de cero
+    func cerrarSesion() {
+        let esperados = conSincronizacion.esperados + sinSincronizacion.esperados
+        guard esperados > 0 else {
+            return
+        }
+        Telemetria.shared.registrar(.ratioTirones, valor: ratioTirones)
+        Traza.shared.contador("scroll", valores: ["ratioTirones": ratioTirones])
+        NSLog("%@", informe())
+        culpables.removeAll()
+        conSincronizacion = Recuento()
+        sinSincronizacion = Recuento()
+    }
+}
@@ -0,0 +1,153 @@
+//
+//  OrquestadorArranque.swift
+//  Heroes Marvel
+//
+//  Created by Borja Gil Herrero on 19/10/2026.
+//  Copyright © 2026 Alsis GHE. All rights reserved.
+//
+
+import UIKit
+
+//Momento del arranque en el que se ejecuta una tarea
+enum FaseArranque: Int {
+    //Dentro de didFinishLaunching: solo lo imprescindible para pintar el primer frame
+    case critica = 0
+    //Justo despues de que se haya pintado el primer frame
+    case trasPrimerFotograma
+    //Cuando el hilo principal se queda sin trabajo, una tarea cada vez
+    case ociosa
+}
+
+//Ordena el trabajo del arranque en fases para que el primer frame no espere a nada que no
+//necesite (Crashlytics, timers de telemetria, sincronizacion...). El primer frame se detecta con
+//el primer tick de un CADisplayLink y los huecos libres del hilo principal con un observador del
+//run loop antes de dormir. Cada tarea y cada hito queda en una linea de tiempo relativa al
+//inicio del proceso, que se escribe en el log y en la traza al terminar la fase ociosa.
+final class OrquestadorArranque {
+
+    static let shared = OrquestadorArranque()
+
+    //Objetivo de tiempo hasta el primer frame en el dispositivo mas antiguo soportado
+    static let objetivoPrimerFotograma: TimeInterval = 0.4
+
+    struct Entrada {
+        let nombre: String
+        let fase: FaseArranque
+        //Segundos desde el inicio del proceso
+        let inicio: TimeInterval
+        let duracion: TimeInterval
+    }
+
+    private var pendientes: [[(String, () -> Void)]] = [[], [], []]
+    private var faseActual: FaseArranque? = nil
+    private(set) var lineaTiempo = [Entrada]()
+    private var enlacePantalla: CADisplayLink?
+    private var observadorOcioso: CFRunLoopObserver?
+    private let inicioProceso = Telemetria.inicioProceso() ?? Date()
+
+    //Todas las llamadas se hacen desde el hilo principal
+    func registrar(_ nombre: String, fase: FaseArranque, bloque: @escaping () -> Void) {
+        dispatchPrecondition(condition: .onQueue(.main))
+        pendientes[fase.rawValue].append((nombre, bloque))
+        //Si la fase ya ha pasado, la tarea sale en la siguiente ocasion de esa fase o la actual
+        if let actual = faseActual, actual.rawValue > fase.rawValue || (actual == fase && fase != .ociosa) {
+            DispatchQueue.main.async {
+                self.ejecutarPendientes(fase)
+            }
+        } else if faseActual == .ociosa && fase == .ociosa {
+            instalarObservadorOcioso()
+        }
+    }
+
+    //Se llama al final de didFinishLaunching, con las tareas de las tres fases ya registradas
+    func arrancar() {
+        dispatchPrecondition(condition: .onQueue(.main))
+        hito("didFinishLaunching")
+        faseActual = .critica
+        ejecutarPendientes(.critica)
+
+        let enlace = CADisplayLink(target: self, selector: #selector(primerFotograma(_:)))
+        enlace.add(to: .main, forMode: .common)
+        enlacePantalla = enlace
+    }
+
+    @objc private func primerFotograma(_ enlace: CADisplayLink) {
+        enlace.invalidate()
+        enlacePantalla = nil
+        let tiempo = hito("primerFotograma")
+        Telemetria.shared.registrar(.arranquePrimerFotograma, valor: tiempo * 1000)
+        if tiempo > OrquestadorArranque.objetivoPrimerFotograma {
+            NSLog("Arranque: primer frame a los \(Int(tiempo * 1000)) ms, por encima del objetivo de \(Int(OrquestadorArranque.objetivoPrimerFotograma * 1000)) ms")
+        }
+
+        faseActual = .trasPrimerFotograma
+        ejecutarPendientes(.trasPrimerFotograma)
+        faseActual = .ociosa
+        instalarObservadorOcioso()
+    }
+
+    // MARK: - Fase ociosa
+
+    private func instalarObservadorOcioso() {
+        guard observadorOcioso == nil else {
+            return
+        }
+        let observador = CFRunLoopObserverCreateWithHandler(nil, CFRunLoopActivity.beforeWaiting.rawValue, true, 0) { [unowned self] _, _ in
+            self.ejecutarSiguienteOciosa()
+        }
+        CFRunLoopAddObserver(CFRunLoopGetMain(), observador, .commonModes)
+        observadorOcioso = observador
+    }
+
+    //Una tarea por hueco para no volver a bloquear el hilo principal durante el scroll inicial
+    private func ejecutarSiguienteOciosa() {
+        guard !pendientes[FaseArranque.ociosa.rawValue].isEmpty else {
+            if let observador = observadorOcioso {
+                CFRunLoopRemoveObserver(CFRunLoopGetMain(), observador, .commonModes)
+                observadorOcioso = nil
+                publicar()
+            }
+            return
+        }
+        let (nombre, bloque) = pendientes[FaseArranque.ociosa.rawValue].removeFirst()
+        ejecutar(nombre, fase: .ociosa, bloque: bloque)
+        //Despierta al run loop para que vuelva a pasar por beforeWaiting con la siguiente
+        CFRunLoopWakeUp(CFRunLoopGetMain())
+    }
+
+    // MARK: - Ejecucion
+
+    private func ejecutarPendientes(_ fase: FaseArranque) {
+        let tareas = pendientes[fase.rawValue]
+        pendientes[fase.rawValue].removeAll()
+        for (nombre, bloque) in tareas {
+            ejecutar(nombre, fase: fase, bloque: bloque)
+        }
+    }
+
+    private func ejecutar(_ nombre: String, fase: FaseArranque, bloque: () -> Void) {
+        let inicio = Date()
+        Traza.shared.intervalo("arranque.\(nombre)", categoria: "arranque") {
+            bloque()
+        }
+        lineaTiempo.append(Entrada(nombre: nombre, fase: fase, inicio: inicio.timeIntervalSince(inicioProceso),
+                                   duracion: Date().timeIntervalSince(inicio)))
+    }
+
+    //Marca un instante del arranque y devuelve los segundos desde el inicio del proceso
+    @discardableResult
+    func hito(_ nombre: String) -> TimeInterval {
+        let tiempo = Date().timeIntervalSince(inicioProceso)
+        lineaTiempo.append(Entrada(nombre: nombre, fase: faseActual ?? .critica, inicio: tiempo, duracion: 0))
+        Traza.shared.marca("arranque.\(nombre)", categoria: "arranque")
+        return tiempo
+    }
+
+    private func publicar() {
+        let lineas = lineaTiempo.map { entrada -> String in
+            let duracion = entrada.duracion > 0 ? " (\(Int(entrada.duracion * 1000)) ms)" : ""
+            return "  \(Int(entrada.inicio * 1000)) ms [\(entrada.fase)] \(entrada.nombre)\(duracion)"
+        }
+        NSLog("Arranque:\n\(lineas.joined(separator: "\n"))")
+    }
+}
@@ -0,0 +1,237 @@
+//
+//  Telemetria.swift
+//  Heroes Marvel
+//
+//  Created by Borja Gil Herrero on 19/10/2026.
+//  Copyright © 2026 Alsis GHE. All rights reserved.
+//
+
+import Foundation
+import Crashlytics
+
+//Metricas de rendimiento que se envian desde los dispositivos
+enum MetricaRendimiento: String {
+    //Desde que arranca el proceso hasta que se pinta la primera fila de la lista
+    case arranquePrimeraFila = "arranque_primera_fila_ms"
+    //Desde que arranca el proceso hasta el primer frame
+    case arranquePrimerFotograma = "arranque_primer_fotograma_ms"
+    case duracionSincronizacion = "sincronizacion_s"
+    case paginasPorSegundo = "sincronizacion_paginas_s"
+    //Porcentaje de frames perdidos durante el scroll
+    case ratioTirones = "scroll_tirones_pct"
+    case tamanoAlmacen = "almacen_mb"
+
+    static let todas: [MetricaRendimiento] = [.arranquePrimeraFila, .arranquePrimerFotograma, .duracionSincronizacion, .paginasPorSegundo, .ratioTirones, .tamanoAlmacen]
+
+    //Limites superiores de los cubos del histograma; hay un cubo mas para lo que los supera
+    var limites: [Double] {
+        switch self {
+        case .arranquePrimeraFila, .arranquePrimerFotograma:
+            return [250, 400, 600, 800, 1000, 1500, 2000, 3000, 5000, 8000]
+        case .duracionSincronizacion:
+            return [1, 2, 5, 10, 20, 30, 60, 120, 300, 600]
+        case .paginasPorSegundo:
+            return [0.5, 1, 2, 3, 5, 8, 12, 20, 30, 50]
+        case .ratioTirones:
+            return [0.5, 1, 2, 3, 5, 8, 12, 20, 30, 50]
+        case .tamanoAlmacen:
+            return [1, 2, 5, 10, 20, 50, 100, 200, 500, 1000]
+        }
+    }
+}
+
+//Telemetria de rendimiento sobre los eventos personalizados de Answers (Crashlytics). Las
+//medidas se agregan en el dispositivo en histogramas de cubos fijos y se envian por lotes: un
+//evento por metrica cada cierto tiempo y al pasar a segundo plano, nunca uno por medida.
+//Solo envia una fraccion de las sesiones (muestreo); en las demas registrar() solo mira un Bool.
+//Registrar es buscar el cubo y sumar bajo un os_unfair_lock, sin reservar memoria.
+final class Telemetria {
+
+    static let shared = Telemetria()
+    static let claveCompleta = "TelemetriaCompleta"
+
+    //Fraccion de sesiones que envian telemetria
+    static let tasaMuestreo = 0.10
+    static let intervaloEnvio: TimeInterval = 5 * 60
+
+    private struct Histograma {
+        let limites: [Double]
+        var cuentas: [Int]
+        var muestras = 0
+        var suma = 0.0
+        var maximo = 0.0
+
+        init(limites: [Double]) {
+            self.limites = limites
+            cuentas = [Int](repeating: 0, count: limites.count + 1)
+        }
+
+        mutating func registrar(_ valor: Double) {
+            var cubo = 0
+            while cubo < limites.count && valor > limites[cubo] {
+                cubo += 1
+            }
+            cuentas[cubo] += 1
+            muestras += 1
+            suma += valor
+            maximo = max(maximo, valor)
+        }
+
+        //Aproximado por el limite superior del cubo
+        func percentil(_ fraccion: Double) -> Double {
+            let objetivo = Int((Double(muestras) * fraccion).rounded(.up))
+            var acumuladas = 0
+            for (cubo, cuenta) in cuentas.enumerated() {
+                acumuladas += cuenta
+                if acumuladas >= objetivo {
+                    return cubo < limites.count ? limites[cubo] : maximo
+                }
+            }
+            return maximo
+        }
+    }
+
+    let activa: Bool
+
+    private let cerrojo: UnsafeMutablePointer<os_unfair_lock>
+    private var histogramas: [Histograma]
+    private var aciertosImagenes = 0
+    private var fallosImagenes = 0
+    private var primeraFilaRegistrada = false
+    private let cola = DispatchQueue(label: "Telemetria", qos: .utility)
+    private var temporizador: DispatchSourceTimer?
+
+    private init() {
+        activa = UserDefaults.standard.bool(forKey: Telemetria.claveCompleta) || Double.random(in: 0..<1) < Telemetria.tasaMuestreo
+        cerrojo = UnsafeMutablePointer<os_unfair_lock>.allocate(capacity: 1)
+        cerrojo.initialize(to: os_unfair_lock())
+        histogramas = MetricaRendimiento.todas.map { Histograma(limites: $0.limites) }
+    }
+
+    //Empieza los envios periodicos. Se llama una vez que Crashlytics esta inicializado
+    func iniciar() {
+        guard activa, temporizador == nil else {
+            return
+        }
+        let temporizador = DispatchSource.makeTimerSource(queue: cola)
+        temporizador.schedule(deadline: .now() + Telemetria.intervaloEnvio, repeating: Telemetria.intervaloEnvio, leeway: .seconds(30))
+        temporizador.setEventHandler { [weak self] in
+            self?.enviarAhora()
+        }
+        temporizador.resume()
+        self.temporizador = temporizador
+    }
+
+    // MARK: - Registro
+
+    func registrar(_ metrica: MetricaRendimiento, valor: Double) {
+        guard activa else {
+            return
+        }
+        let posicion = MetricaRendimiento.todas.firstIndex(of: metrica)!
+        os_unfair_lock_lock(cerrojo)
+        histogramas[posicion].registrar(valor)
+        os_unfair_lock_unlock(cerrojo)
+    }
+
+    func registrarImagen(acierto: Bool) {
+        guard activa else {
+            return
+        }
+        os_unfair_lock_lock(cerrojo)
+        if acierto {
+            aciertosImagenes += 1
+        } else {
+            fallosImagenes += 1
+        }
+        os_unfair_lock_unlock(cerrojo)
+    }
+
+    //Solo cuenta la primera vez en la sesion
+    func registrarPrimeraFila() {
+        guard activa, !primeraFilaRegistrada else {
+            return
+        }
+        primeraFilaRegistrada = true
+        if let inicio = Telemetria.inicioProceso() {
+            registrar(.arranquePrimeraFila, valor: Date().timeIntervalSince(inicio) * 1000)
+        }
+    }
+
+    // MARK: - Envio
+
+    //Envia lo acumulado (por ejemplo al pasar a segundo plano) sin bloquear al que llama
+    func enviar() {
+        guard activa else {
+            return
+        }
+        cola.async {
+            self.enviarAhora()
+        }
+    }
+
+    private func enviarAhora() {
+        registrar(.tamanoAlmacen, valor: Telemetria.tamanoAlmacen())
+
+        os_unfair_lock_lock(cerrojo)
+        let copia = histogramas
+        let aciertos = aciertosImagenes
+        let fallos = fallosImagenes
+        histogramas = MetricaRendimiento.todas.map { Histograma(limites: $0.limites) }
+        aciertosImagenes = 0
+        fallosImagenes = 0
+        os_unfair_lock_unlock(cerrojo)
+
+        //Answers admite hasta 20 atributos por evento: resumen + un atributo por cubo
+        for (metrica, histograma) in zip(MetricaRendimiento.todas, copia) where histograma.muestras > 0 {
+            var atributos: [String: Any] = [
+                "muestras": histograma.muestras,
+                "media": histograma.suma / Double(histograma.muestras),
+                "p50": histograma.percentil(0.5),
+                "p90": histograma.percentil(0.9),
+                "max": histograma.maximo,
+            ]
+            for (cubo, cuenta) in histograma.cuentas.enumerated() {
+                let nombre = cubo < histograma.limites.count ? "le_\(Telemetria.texto(histograma.limites[cubo]))" : "mas"
+                atributos[nombre] = cuenta
+            }
+            Answers.logCustomEvent(withName: "Rendimiento \(metrica.rawValue)", customAttributes: atributos)
+        }
+        if aciertos + fallos > 0 {
+            Answers.logCustomEvent(withName: "Rendimiento cache_imagenes", customAttributes: [
+                "aciertos": aciertos,
+                "fallos": fallos,
+                "tasa_aciertos_pct": Double(aciertos) * 100 / Double(aciertos + fallos),
+            ])
+        }
+    }
+
+    private class func texto(_ limite: Double) -> String {
+        return limite == limite.rounded() ? String(Int(limite)) : String(limite).replacingOccurrences(of: ".", with: "_")
+    }
+
+    // MARK: - Datos del sistema
+
+    //Momento en que arranco el proceso, antes incluso de main
+    class func inicioProceso() -> Date? {
+        var informacion = kinfo_proc()
+        var tamano = MemoryLayout<kinfo_proc>.stride
+        var consulta: [Int32] = [CTL_KERN, KERN_PROC, KERN_PROC_PID, getpid()]
+        guard sysctl(&consulta, UInt32(consulta.count), &informacion, &tamano, nil, 0) == 0 else {
+            return nil
+        }
+        let inicio = informacion.kp_proc.p_starttime
+        return Date(timeIntervalSince1970: Double(inicio.tv_sec) + Double(inicio.tv_usec) / 1_000_000)
+    }
+
+    //Tamaño en MB del almacen de Core Data con su WAL
+    class func tamanoAlmacen() -> Double {
+        let documentos = FileManager.default.urls(for: .documentDirectory, in: .userDomainMask)[0]
+        var bytes = 0
+        for sufijo in ["", "-wal", "-shm"] {
+            let ruta = documentos.appendingPathComponent("Heroes_Marvel.sqlite" + sufijo).path
+            bytes += ((try? FileManager.default.attributesOfItem(atPath: ruta))?[.size] as? Int) ?? 0
+        }
+        return Double(bytes) / 1_048_576
+    }
+}
@@ -0,0 +1,204 @@
+//
+//  Traza.swift
+//  Heroes Marvel
+//
+//  Created by Borja Gil Herrero on 19/10/2026.
+//  Copyright © 2026 Alsis GHE. All rights reserved.
+//
+
+import Foundation
+
+//Trazas de tiempos por intervalos con nombre, anidados por hilo, y contadores. Se exportan en
+//formato Chrome Trace Event (chrome://tracing o ui.perfetto.dev) para ver en que se va el tiempo
+//de una sincronizacion completa o del pintado de la lista.
+//Desactivada no guarda nada: intervalo() solo ejecuta el bloque. Se activa con el argumento de
+//arranque "-TrazaActiva YES".
+final class Traza {
+
+    static let shared = Traza()
+    static let claveActiva = "TrazaActiva"
+    private static let claveHilo = "Traza.hilo"
+
+    //Tope de eventos en memoria; al llegar se descartan los nuevos para no crecer sin limite
+    static let eventosMaximos = 200_000
+
+    //Marca de un intervalo abierto con iniciar() que se cierra con terminar()
+    struct Intervalo {
+        fileprivate let nombre: String
+        fileprivate let categoria: String
+        fileprivate let inicio: UInt64
+        fileprivate let hilo: Int
+        fileprivate let argumentos: [String: Double]?
+    }
+
+    private struct Evento {
+        let fase: Character
+        let nombre: String
+        let categoria: String
+        let inicio: UInt64
+        let duracion: UInt64
+        let hilo: Int
+        let argumentos: [String: Double]?
+    }
+
+    var activa: Bool
+
+    private let cerrojo = NSLock()
+    private var eventos = [Evento]()
+    private var nombresHilos = [Int: String]()
+    private var siguienteHilo = 1
+    private let origen = DispatchTime.now().uptimeNanoseconds
+
+    private init() {
+        activa = UserDefaults.standard.bool(forKey: Traza.claveActiva)
+    }
+
+    // MARK: - Registro
+
+    //Mide el bloque como un intervalo. Los intervalos que se abren dentro quedan anidados en este
+    @discardableResult
+    func intervalo<T>(_ nombre: String, categoria: String = "app", argumentos: [String: Double]? = nil, _ bloque: () throws -> T) rethrows -> T {
+        guard activa else {
+            return try bloque()
+        }
+        let marca = iniciar(nombre, categoria: categoria, argumentos: argumentos)
+        defer { terminar(marca) }
+        return try bloque()
+    }
+
+    //Para intervalos que no caben en un bloque, por ejemplo los que terminan en un callback.
+    //Deben terminar en el mismo hilo para anidarse bien; si no, se ven como una pista aparte
+    func iniciar(_ nombre: String, categoria: String = "app", argumentos: [String: Double]? = nil) -> Intervalo {
+        return Intervalo(nombre: nombre, categoria: categoria, inicio: ahora(), hilo: activa ? hiloActual() : 0, argumentos: argumentos)
+    }
+
+    func terminar(_ intervalo: Intervalo, argumentos: [String: Double]? = nil) {
+        guard activa else {
+            return
+        }
+        let fin = ahora()
+        var todos = intervalo.argumentos
+        if let argumentos = argumentos {
+            todos = (todos ?? [:]).merging(argumentos) { $1 }
+        }
+        registrar(Evento(fase: "X", nombre: intervalo.nombre, categoria: intervalo.categoria, inicio: intervalo.inicio,
+                      duracion: fin >= intervalo.inicio ? fin - intervalo.inicio : 0, hilo: intervalo.hilo, argumentos: todos))
+    }
+
+    //Valores de un contador en este instante, cada clave es una serie de la grafica
+    func contador(_ nombre: String, valores: [String: Double]) {
+        guard activa else {
+            return
+        }
+        registrar(Evento(fase: "C", nombre: nombre, categoria: "contador", inicio: ahora(), duracion: 0, hilo: hiloActual(), argumentos: valores))
+    }
+
+    //Evento puntual, sin duracion
+    func marca(_ nombre: String, categoria: String = "app") {
+        guard activa else {
+            return
+        }
+        registrar(Evento(fase: "i", nombre: nombre, categoria: categoria, inicio: ahora(), duracion: 0, hilo: hiloActual(), argumentos: nil))
+    }
+
+    func vaciar() {
+        cerrojo.lock()
+        eventos.removeAll()
+        cerrojo.unlock()
+    }
+
+    private func registrar(_ evento: Evento) {
+        cerrojo.lock()
+        if eventos.count < Traza.eventosMaximos {
+            eventos.append(evento)
+        }
+        cerrojo.unlock()
+    }
+
+    private func ahora() -> UInt64 {
+        return DispatchTime.now().uptimeNanoseconds - origen
+    }
+
+    //Identificador corto y estable de cada hilo; el del sistema no es portable ni legible
+    private func hiloActual() -> Int {
+        let diccionario = Thread.current.threadDictionary
+        if let hilo = diccionario[Traza.claveHilo] as? Int {
+            return hilo
+        }
+        cerrojo.lock()
+        let hilo = Thread.isMainThread ? 0 : siguienteHilo
+        if !Thread.isMainThread {
+            siguienteHilo += 1
+        }
+        nombresHilos[hilo] = nombreHiloActual()
+        cerrojo.unlock()
+        diccionario[Traza.claveHilo] = hilo
+        return hilo
+    }
+
+    private func nombreHiloActual() -> String {
+        if Thread.isMainThread {
+            return "main"
+        }
+        if let nombre = Thread.current.name, !nombre.isEmpty {
+            return nombre
+        }
+        #if os(Linux)
+        return "hilo"
+        #else
+        //Los hilos de GCD no tienen nombre pero la cola en la que empiezan a trabajar si
+        return String(cString: __dispatch_queue_get_label(nil))
+        #endif
+    }
+
+    // MARK: - Exportacion
+
+    //Escribe la traza en formato Chrome Trace Event. Los tiempos van en microsegundos
+    func exportar(a url: URL) throws {
+        cerrojo.lock()
+        let copia = eventos
+        let hilos = nombresHilos
+        cerrojo.unlock()
+
+        let pid = Int(ProcessInfo.processInfo.processIdentifier)
+        var lista = [[String: Any]]()
+        lista.reserveCapacity(copia.count + hilos.count)
+        for (hilo, nombre) in hilos {
+            lista.append(["ph": "M", "name": "thread_name", "pid": pid, "tid": hilo, "args": ["name": nombre]])
+        }
+        for evento in copia {
+            var json: [String: Any] = ["ph": String(evento.fase), "name": evento.nombre, "cat": evento.categoria,
+                                       "ts": Double(evento.inicio) / 1000, "pid": pid, "tid": evento.hilo]
+            if evento.fase == "X" {
+                json["dur"] = Double(evento.duracion) / 1000
+            } else if evento.fase == "i" {
+                json["s"] = "t"
+            }
+            if let argumentos = evento.argumentos {
+                json["args"] = argumentos
+            }
+            lista.append(json)
+        }
+        let datos = try JSONSerialization.data(withJSONObject: ["traceEvents": lista, "displayTimeUnit": "ms"], options: [])
+        try datos.write(to: url, options: .atomic)
+    }
+
+    //Exporta a Documents/Trazas con la fecha en el nombre, para recogerla desde iTunes o Xcode
+    @discardableResult
+    func exportarADocumentos(prefijo: String) -> URL? {
+        guard activa else {
+            return nil
+        }
+        let documentos = FileManager.default.urls(for: .documentDirectory, in: .userDomainMask)[0]
+        let directorio = documentos.appendingPathComponent("Trazas", isDirectory: true)
+        let url = directorio.appendingPathComponent("\(prefijo)-\(Int(Date().timeIntervalSince1970)).json")
+        do {
+            try FileManager.default.createDirectory(at: directorio, withIntermediateDirectories: true, attributes: nil)
+            try exportar(a: url)
+            return url
+        } catch {
+            NSLog("No se ha podido exportar la traza: \(error)")
+            return nil
+        }
+    }
+}
@@ -0,0 +1,162 @@
+//
+//  CacheImagenes.swift
+//  Heroes Marvel
+//
+//  Created by Borja Gil Herrero on 19/10/2026.
+//  Copyright © 2026 Alsis GHE. All rights reserved.
+//
+
+import UIKit
+import CoreData
+import Redbeard
+
+//Cache de miniaturas ya decodificadas para las filas de la lista. La imagen se lee del almacen
+//y se decodifica fuera del hilo principal, la fila solo recibe el UIImage listo para pintar.
+//Por debajo guarda tambien los bytes codificados, que ocupan mucho menos: si hay que soltar las
+//imagenes decodificadas por falta de memoria se vuelven a decodificar sin pasar por Core Data.
+class CacheImagenes: NSObject, NSCacheDelegate {
+
+    static let shared = CacheImagenes()
+    //Lado mayor en puntos de la imagen que se guarda, de sobra para la celda de la lista
+    static let ladoMaximo: CGFloat = 88
+    static let grupoBytes = "miniaturas"
+    static let latenciaDecodificacion = RegistroLatencias.shared.histograma("imagen.decodificacion")
+    //Desde que se pide al almacen hasta que la fila recibe la imagen decodificada
+    static let latenciaCarga = RegistroLatencias.shared.histograma("imagen.carga")
+
+    //Por idMarvel: un NSNumber pequeño no reserva memoria, la fila no crea nada para buscar su imagen
+    private let imagenes = NSCache<NSNumber, UIImage>()
+    private let bytes = RBDataMemoryCache(maximumCacheSize: 8 * 1024 * 1024)
+    private let colaDecodificacion = DispatchQueue(label: "CacheImagenes.decodificacion", qos: .userInitiated)
+
+    //NSCache no dice cuanto ocupa: llevamos la cuenta con el coste de cada imagen
+    private let cerrojo = NSLock()
+    private var bytesDecodificados = 0
+
+    private override init() {
+        super.init()
+        imagenes.countLimit = 200
+        imagenes.delegate = self
+
+        let gobernador = GobernadorMemoria.shared
+        gobernador.registrar("imagenes", nivel: .imagenesDecodificadas, coste: { [unowned self] in
+            self.cerrojo.lock()
+            defer { self.cerrojo.unlock() }
+            return self.bytesDecodificados
+        }, liberar: { [unowned self] in
+            self.imagenes.removeAllObjects()
+        })
+        gobernador.registrar("miniaturas", nivel: .bytesCodificados, coste: { [unowned self] in
+            Int(self.bytes.cacheSizeInBytes)
+        }, liberar: { [unowned self] in
+            self.bytes.removeAllItems(withGroup: CacheImagenes.grupoBytes)
+        })
+    }
+
+    func imagen(para idMarvel: Int32) -> UIImage? {
+        let imagen = imagenes.object(forKey: NSNumber(value: idMarvel))
+        Telemetria.shared.registrarImagen(acierto: imagen != nil)
+        return imagen
+    }
+
+    //Carga la miniatura del heroe (o la imagen completa si no tiene) y la entrega en el hilo principal
+    func cargarImagen(para idMarvel: Int32, context: NSManagedObjectContext, completion: @escaping (UIImage?) -> Void) {
+        if let imagen = imagenes.object(forKey: NSNumber(value: idMarvel)) {
+            completion(imagen)
+            return
+        }
+        let clave = String(idMarvel)
+        if let datos = bytes.fetchDataItem(withKey: clave) {
+            decodificarYGuardar(datos, idMarvel: idMarvel, completion: completion)
+            return
+        }
+        CacheImagenes.latenciaCarga.medirTarea { terminado in
+            self.leerImagen(para: idMarvel, context: context) { imagen in
+                terminado()
+                completion(imagen)
+            }
+        }
+    }
+
+    private func leerImagen(para idMarvel: Int32, context: NSManagedObjectContext, completion: @escaping (UIImage?) -> Void) {
+        let clave = String(idMarvel)
+        context.perform {
+            let lectura = Traza.shared.iniciar("imagen.lectura", categoria: "imagen")
+            let fetchRequest: NSFetchRequest<Heroe> = Heroe.fetchRequest()
+            fetchRequest.predicate = NSPredicate(format: "idMarvel == %d", idMarvel)
+            fetchRequest.fetchLimit = 1
+            let heroe = (try? context.fetch(fetchRequest))?.first
+            let datos = (heroe?.miniatura ?? heroe?.imagen) as Data?
+            if let heroe = heroe {
+                //No dejamos la imagen completa retenida en el contexto
+                context.refresh(heroe, mergeChanges: true)
+            }
+            Traza.shared.terminar(lectura, argumentos: ["bytes": Double(datos?.count ?? 0)])
+            //Solo las miniaturas: la imagen completa no cabe en una cache de este tamaño
+            if let datos = datos, heroe?.miniatura != nil {
+                self.bytes.storeDataItem(datos, key: clave, group: CacheImagenes.grupoBytes, expiryInterval: 24 * 60 * 60)
+            }
+            self.decodificarYGuardar(datos, idMarvel: idMarvel, completion: completion)
+        }
+    }
+
+    private func decodificarYGuardar(_ datos: Data?, idMarvel: Int32, completion: @escaping (UIImage?) -> Void) {
+        colaDecodificacion.async {
+            let imagen = Traza.shared.intervalo("imagen.decodificacion", categoria: "imagen") {
+                CacheImagenes.latenciaDecodificacion.medir {
+                    datos.flatMap { self.decodificar($0) }
+                }
+            }
+            if let imagen = imagen {
+                let coste = CacheImagenes.coste(de: imagen)
+                self.cerrojo.lock()
+                self.bytesDecodificados += coste
+                self.cerrojo.unlock()
+                self.imagenes.setObject(imagen, forKey: NSNumber(value: idMarvel), cost: coste)
+            }
+            DispatchQueue.main.async {
+                MonitorFotogramas.shared.medir(.imagen) {
+                    completion(imagen)
+                }
+            }
+        }
+    }
+
+    //Bytes del bitmap ya decodificado
+    private class func coste(de imagen: UIImage) -> Int {
+        guard let cgImage = imagen.cgImage else {
+            return 0
+        }
+        return cgImage.bytesPerRow * cgImage.height
+    }
+
+    // MARK: - NSCacheDelegate
+
+    func cache(_ cache: NSCache<AnyObject, AnyObject>, willEvictObject obj: Any) {
+        guard let imagen = obj as? UIImage else {
+            return
+        }
+        cerrojo.lock()
+        bytesDecodificados = max(0, bytesDecodificados - CacheImagenes.coste(de: imagen))
+        cerrojo.unlock()
+    }
+
+    //Fuerza la decodificacion aqui en lugar de en el primer pintado dentro del hilo principal,
+    //reduciendo la imagen al tamaño de la fila para no guardar imagenes completas en memoria
+    func decodificar(_ datos: Data) -> UIImage? {
+        guard let imagen = UIImage(data: datos), imagen.size.width > 0, imagen.size.height > 0 else {
+            return nil
+        }
+        let escala = min(1, CacheImagenes.ladoMaximo / max(imagen.size.width, imagen.size.height))
+        let tamano = CGSize(width: imagen.size.width * escala, height: imagen.size.height * escala)
+        UIGraphicsBeginImageContextWithOptions(tamano, true, 0)
+        defer { UIGraphicsEndImageContext() }
+        imagen.draw(in: CGRect(origin: .zero, size: tamano))
+        return UIGraphicsGetImageFromCurrentImageContext() ?? imagen
+    }
+
+    func vaciar() {
+        imagenes.removeAllObjects()
+        bytes.removeAllItems(withGroup: CacheImagenes.grupoBytes)
+    }
+}
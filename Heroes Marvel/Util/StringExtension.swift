@@ -14,16 +14,11 @@ extension String{
     func md5() -> String! {
         let str = self.cString(using: String.Encoding.utf8)
         let strLen = CUnsignedInt(self.lengthOfBytes(using: String.Encoding.utf8))
-        let digestLen = Int(CC_MD5_DIGEST_LENGTH)
-        let result = UnsafeMutablePointer<CUnsignedChar>.allocate(capacity: digestLen)
+        //Buffer del resumen gestionado por Swift, sin allocate que haya que liberar a mano
+        var result = [CUnsignedChar](repeating: 0, count: Int(CC_MD5_DIGEST_LENGTH))
         
-        CC_MD5(str!, strLen, result)
+        CC_MD5(str!, strLen, &result)
         
-        let hash = NSMutableString()
-        for i in 0..<digestLen {
-            hash.appendFormat("%02x", result[i])
-        }
-        
-        return String(format: hash as String)
+        return result.map { String(format: "%02x", $0) }.joined()
     }
 }
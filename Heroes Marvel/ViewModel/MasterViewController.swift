@@ -13,6 +13,11 @@ class MasterViewController: UITableViewController, NSFetchedResultsControllerDel
 
     var detailViewController: DetailViewController? = nil
     var managedObjectContext: NSManagedObjectContext? = nil
+    //Indice proyectado en memoria con nombres y orden de la lista. Mientras exista, la tabla se
+    //pinta desde aqui y el NSFetchedResultsController no llega a crearse. Solo se toca en el hilo principal
+    var indice: IndiceNombres? = nil
+
+    static let latenciaCelda = RegistroLatencias.shared.histograma("celda.configuracion")
 
     override func viewDidLoad() {
         super.viewDidLoad()
@@ -25,10 +30,65 @@ class MasterViewController: UITableViewController, NSFetchedResultsControllerDel
             detailViewController = (controllers[controllers.count-1] as! UINavigationController).topViewController as? DetailViewController
         }
         
+        MonitorFotogramas.shared.observar(tableView, pantalla: "lista")
+
+        //Hasta que se abra el almacen la lista sale del indice de nombres o, si no hay, vacia
+        if indice == nil && managedObjectContext == nil{
+            let cargando = UIActivityIndicatorView(style: .gray)
+            cargando.startAnimating()
+            tableView.backgroundView = cargando
+        }
+        abrirIndice()
+    }
+
+    //Proyecta el indice guardado fuera del hilo principal, sin retrasar el primer fotograma
+    func abrirIndice(){
+        DispatchQueue.global(qos: .userInitiated).async {
+            let guardado = MasterViewController.indiceConFilas()
+            DispatchQueue.main.async {
+                //Si la sincronizacion ya ha regenerado el indice nos quedamos con ese
+                if self.indice == nil, let guardado = guardado{
+                    self.usarIndice(guardado)
+                }
+            }
+        }
+    }
+
+    //El AppDelegate abre el almacen en segundo plano y nos entrega el contexto al terminar
+    func almacenAbierto(_ context: NSManagedObjectContext){
+        managedObjectContext = context
+        if isViewLoaded{
+            tableView.backgroundView = nil
+            //Las filas pintadas desde el indice ya pueden cargar su miniatura
+            tableView.reloadData()
+        }
+        if AppDelegate.alojandoPruebas{
+            return
+        }
+        OrquestadorArranque.shared.registrar("sincronizacion", fase: .ociosa){
+            self.iniciarSincronizacion()
+        }
+    }
+
+    func iniciarSincronizacion(){
+        //indice solo se toca en el hilo principal
+        let hayIndice = indice != nil
         DispatchQueue.global().async {
-            
-            UserDefaults.standard.setValue(true, forKey: "carga")
-            self.cargarHeroes()
+            if !hayIndice{
+                self.actualizarIndice()
+            }
+            DispatchQueue.main.async {
+                MonitorFotogramas.shared.sincronizando = true
+            }
+            Traza.shared.intervalo("sincronizacion", categoria: "sincronizacion"){
+                self.cargarHeroes()
+                self.actualizarIndice()
+            }
+            DispatchQueue.main.async {
+                MonitorFotogramas.shared.sincronizando = false
+            }
+            Traza.shared.exportarADocumentos(prefijo: "sincronizacion")
+            NSLog("Latencias tras la sincronizacion:\n\(RegistroLatencias.shared.resumen())")
         }
     }
 
@@ -38,27 +98,95 @@ class MasterViewController: UITableViewController, NSFetchedResultsControllerDel
 
     }
     
+    //Sincronizacion incremental: solo se piden los personajes modificados despues del mas reciente
+    //que ya tenemos, que en el primer arranque es la fecha de la instantanea del catalogo semilla
     func cargarHeroes(){
-        if !UserDefaults.standard.bool(forKey: "carga"){
-            let limit = 25
-            var offset = 0
-            var continuar:Bool =  true
-            while continuar && offset < 100000{
-                print("entro")
-           
-                continuar = MarvelRed.llamadaPersonajes(limit: String(limit), offset: String(offset))
-
+        let desde = CatalogoSemilla.fechaUltimaModificacion(en: CoreDataStack.store.managedObjectContext)
+        let limit = 25
+        var offset = 0
+        let inicio = Date()
+        var paginas = 0
+        defer {
+            let duracion = Date().timeIntervalSince(inicio)
+            Telemetria.shared.registrar(.duracionSincronizacion, valor: duracion)
+            if duracion > 0 && paginas > 0{
+                Telemetria.shared.registrar(.paginasPorSegundo, valor: Double(paginas) / duracion)
+            }
+        }
+        while offset < 100000{
+            switch MarvelRed.llamadaPersonajes(limit: String(limit), offset: String(offset), modificadoDesde: desde, prioridad: .sincronizacion){
+            case .personajes:
+                paginas += 1
                 offset = offset + limit
+            case .fin:
+                return
+            case .fallo(let error):
+                //Lo guardado hasta aqui se queda; el siguiente arranque sigue desde el ultimo modificado
+                NSLog("Sincronizacion interrumpida en el offset \(offset): \(error)")
+                return
+            }
+        }
+    }
+
+    //Regenera el indice de nombres y pasa a pintar la lista desde el. Un indice sin filas (primer
+    //arranque sin catalogo semilla) no sirve: la lista sigue en el NSFetchedResultsController y
+    //las filas van apareciendo segun se guarda cada pagina
+    func actualizarIndice(){
+        Traza.shared.intervalo("indice.regeneracion", categoria: "sincronizacion"){
+            IndiceNombres.regenerar(context: CoreDataStack.store.managedObjectContext)
+        }
+        let nuevoIndice = MasterViewController.indiceConFilas()
+        DispatchQueue.main.async {
+            self.usarIndice(nuevoIndice)
+        }
+    }
+
+    //Pinta la lista desde el indice indicado o, con nil, desde el NSFetchedResultsController
+    func usarIndice(_ nuevoIndice: IndiceNombres?){
+        indice = nuevoIndice
+        if nuevoIndice != nil{
+            _fetchedResultsController?.delegate = nil
+            _fetchedResultsController = nil
+            tableView.backgroundView = nil
+        }
+        MonitorFotogramas.shared.medir(.recargaLista){
+            tableView.reloadData()
+        }
+    }
+
+    class func indiceConFilas() -> IndiceNombres?{
+        guard let indice = IndiceNombres(), indice.numeroSecciones > 0 else{
+            return nil
+        }
+        return indice
+    }
+
+    func heroe(at indexPath: IndexPath) -> Heroe? {
+        if let indice = indice{
+            guard let context = managedObjectContext else {
+                return nil
             }
-            UserDefaults.standard.setValue(true, forKey: "carga")
+            //Los heroes anteriores a idMarvel se buscan por nombre hasta que la sincronizacion les da su id
+            let idMarvel = indice.idMarvel(en: indexPath)
+            let fetchRequest: NSFetchRequest<Heroe> = Heroe.fetchRequest()
+            fetchRequest.predicate = idMarvel != 0
+                ? NSPredicate(format: "idMarvel == %d", idMarvel)
+                : NSPredicate(format: "idMarvel == 0 AND nombre == %@", indice.nombre(en: indexPath))
+            fetchRequest.fetchLimit = 1
+            var heroe: Heroe? = nil
+            context.performAndWait {
+                heroe = (try? context.fetch(fetchRequest))?.first
+            }
+            return heroe
         }
+        return fetchedResultsController.object(at: indexPath)
     }
     // MARK: - Segues
 
     override func prepare(for segue: UIStoryboardSegue, sender: Any?) {
         if segue.identifier == "detalleHeroe" {
             if let indexPath = tableView.indexPathForSelectedRow {
-            let object = fetchedResultsController.object(at: indexPath)
+            let object = heroe(at: indexPath)
                 let controller = (segue.destination as! UINavigationController).topViewController as! DetailViewController
                 controller.detailItem = object
             }
@@ -68,18 +196,53 @@ class MasterViewController: UITableViewController, NSFetchedResultsControllerDel
     // MARK: - Table View
 
     override func numberOfSections(in tableView: UITableView) -> Int {
+        if let indice = indice{
+            return indice.numeroSecciones
+        }
+        if managedObjectContext == nil{
+            return 0
+        }
         return fetchedResultsController.sections?.count ?? 0
     }
 
     override func tableView(_ tableView: UITableView, numberOfRowsInSection section: Int) -> Int {
+        if let indice = indice{
+            return indice.numeroFilas(enSeccion: section)
+        }
         let sectionInfo = fetchedResultsController.sections![section]
         return sectionInfo.numberOfObjects
     }
 
+    override func tableView(_ tableView: UITableView, titleForHeaderInSection section: Int) -> String? {
+        return indice?.titulo(deSeccion: section)
+    }
+
+    override func sectionIndexTitles(for tableView: UITableView) -> [String]? {
+        guard let indice = indice else {
+            return nil
+        }
+        return (0..<indice.numeroSecciones).map { indice.titulo(deSeccion: $0) }
+    }
+
+    override func tableView(_ tableView: UITableView, sectionForSectionIndexTitle title: String, at index: Int) -> Int {
+        return index
+    }
+
     override func tableView(_ tableView: UITableView, cellForRowAt indexPath: IndexPath) -> HeroeTableViewCell {
         let cell = tableView.dequeueReusableCell(withIdentifier: "HeroeCell", for: indexPath) as! HeroeTableViewCell
-        let heroe = fetchedResultsController.object(at: indexPath)
-        configureCell(cell, withHeroe: heroe)
+        Telemetria.shared.registrarPrimeraFila()
+        Traza.shared.intervalo("celda.configuracion", categoria: "lista"){
+            MasterViewController.latenciaCelda.medir{
+                MonitorFotogramas.shared.medir(.configuracionCelda){
+                    if let indice = indice{
+                        configureCell(cell, withIndice: indice, at: indexPath)
+                    }else{
+                        let heroe = fetchedResultsController.object(at: indexPath)
+                        configureCell(cell, withHeroe: heroe)
+                    }
+                }
+            }
+        }
         return cell
     }
 
@@ -90,8 +253,10 @@ class MasterViewController: UITableViewController, NSFetchedResultsControllerDel
 
     override func tableView(_ tableView: UITableView, commit editingStyle: UITableViewCell.EditingStyle, forRowAt indexPath: IndexPath) {
         if editingStyle == .delete {
-            let context = fetchedResultsController.managedObjectContext
-            context.delete(fetchedResultsController.object(at: indexPath))
+            guard let context = managedObjectContext, let heroe = heroe(at: indexPath) else {
+                return
+            }
+            context.delete(heroe)
                 
             do {
                 try context.save()
@@ -100,6 +265,32 @@ class MasterViewController: UITableViewController, NSFetchedResultsControllerDel
                 let nserror = error as NSError
                 fatalError("Unresolved error \(nserror), \(nserror.userInfo)")
             }
+            if indice != nil{
+                DispatchQueue.global().async {
+                    self.actualizarIndice()
+                }
+            }
+        }
+    }
+
+    //Configura la fila solo con el indice: el nombre sale del fichero proyectado y la miniatura
+    //de la cache de imagenes, sin hacer fault del Heroe en el hilo principal
+    func configureCell(_ cell: HeroeTableViewCell, withIndice indice: IndiceNombres, at indexPath: IndexPath) {
+        cell.nombreLabel.text = indice.nombre(en: indexPath)
+        cell.fotoHeroeImageView?.image = nil
+        let idMarvel = indice.idMarvel(en: indexPath)
+        guard let context = managedObjectContext, idMarvel != 0 else {
+            return
+        }
+        if let imagen = CacheImagenes.shared.imagen(para: idMarvel){
+            cell.fotoHeroeImageView?.image = imagen
+            return
+        }
+        CacheImagenes.shared.cargarImagen(para: idMarvel, context: context) { imagen in
+            //La celda puede haberse reutilizado para otra fila mientras tanto
+            if let celdaVisible = self.tableView.cellForRow(at: indexPath) as? HeroeTableViewCell, celdaVisible === cell{
+                cell.fotoHeroeImageView?.image = imagen
+            }
         }
     }
 
@@ -149,9 +340,13 @@ class MasterViewController: UITableViewController, NSFetchedResultsControllerDel
     }    
     var _fetchedResultsController: NSFetchedResultsController<Heroe>? = nil
 
+    //Estos callbacks solo llegan mientras la lista se pinta desde el NSFetchedResultsController,
+    //al pasar al indice se le quita el delegate
     func controllerWillChangeContent(_ controller: NSFetchedResultsController<NSFetchRequestResult>) {
         DispatchQueue.main.async {
-            self.tableView.beginUpdates()
+            MonitorFotogramas.shared.medir(.cambiosFRC){
+                self.tableView.beginUpdates()
+            }
         }
     }
 
@@ -191,7 +386,9 @@ class MasterViewController: UITableViewController, NSFetchedResultsControllerDel
 
     func controllerDidChangeContent(_ controller: NSFetchedResultsController<NSFetchRequestResult>) {
         DispatchQueue.main.async {
-            self.tableView.endUpdates()
+            MonitorFotogramas.shared.medir(.cambiosFRC){
+                self.tableView.endUpdates()
+            }
         }
     }
 
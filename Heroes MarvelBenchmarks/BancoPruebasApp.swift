@@ -0,0 +1,202 @@
+//
+//  BancoPruebasApp.swift
+//  Heroes MarvelBenchmarks
+//
+//  Created by Borja Gil Herrero on 19/10/2026.
+//  Copyright © 2026 Alsis GHE. All rights reserved.
+//
+
+import XCTest
+import CoreData
+import UIKit
+@testable import Heroes_Marvel
+
+//Micro-benchmarks de lo que solo se puede medir en iOS: ingesta en Core Data con distintos
+//perfiles de almacen, latencia del fetch del NSFetchedResultsController y del indice de nombres
+//segun el tamaño del catalogo, y decodificacion y reduccion de miniaturas.
+//Van en su propio bundle de pruebas, alojado en la app, para no alargar las pruebas unitarias.
+//El resultado se guarda en Documents/BancoPruebas con el mismo formato que marvel-microbench y se
+//compara con MarvelSync/Benchmarks/baseline-app.json; la prueba falla si algo empeora mas que la
+//tolerancia (variable de entorno TOLERANCIA, 0.10 por defecto). Los benchmarks que la linea base
+//tiene sin medir solo se registran.
+final class BancoPruebasApp: XCTestCase {
+
+    static let tamanosCatalogo = [1_000, 10_000, 50_000]
+
+    //Como se configura el almacen en cada medida de ingesta
+    enum PerfilAlmacen: String {
+        case sqliteWAL = "sqlite-wal"
+        case sqliteDelete = "sqlite-delete"
+        case memoria = "memoria"
+    }
+
+    private let banco = BancoPruebas(suite: "heroes-marvel-app")
+    private let modelo = CoreDataStack.store.managedObjectModel
+    private let directorio = FileManager.default.temporaryDirectory.appendingPathComponent("BancoPruebas", isDirectory: true)
+
+    override func setUp() {
+        super.setUp()
+        try? FileManager.default.removeItem(at: directorio)
+        try? FileManager.default.createDirectory(at: directorio, withIntermediateDirectories: true, attributes: nil)
+    }
+
+    override func tearDown() {
+        try? FileManager.default.removeItem(at: directorio)
+        super.tearDown()
+    }
+
+    //Ejecuta todo el banco (tarda un par de minutos)
+    func testBancoPruebas() throws {
+        medirIngesta()
+        medirFetch()
+        medirMiniaturas()
+
+        let informe = banco.informe(plataforma: "\(UIDevice.current.model) iOS \(UIDevice.current.systemVersion)")
+        let baseline = try Bundle(for: BancoPruebasApp.self).url(forResource: "baseline-app", withExtension: "json").map { try BancoPruebas.cargar($0) }
+        NSLog("Banco de pruebas:\n\(BancoPruebas.tabla(informe, baseline: baseline))")
+
+        let documentos = FileManager.default.urls(for: .documentDirectory, in: .userDomainMask)[0]
+        let url = documentos.appendingPathComponent("BancoPruebas/resultados-\(Int(Date().timeIntervalSince1970)).json")
+        try FileManager.default.createDirectory(at: url.deletingLastPathComponent(), withIntermediateDirectories: true, attributes: nil)
+        try BancoPruebas.json(informe).write(to: url, options: .atomic)
+        let adjunto = XCTAttachment(contentsOfFile: url)
+        adjunto.lifetime = .keepAlways
+        add(adjunto)
+
+        guard let referencia = baseline else {
+            return XCTFail("Falta baseline-app.json en el bundle de benchmarks")
+        }
+        let tolerancia = Double(ProcessInfo.processInfo.environment["TOLERANCIA"] ?? "") ?? 0.10
+        let regresiones = BancoPruebas.regresiones(informe, baseline: referencia, tolerancia: tolerancia)
+        XCTAssert(regresiones.isEmpty, "Regresiones respecto a la linea base (>\(Int(tolerancia * 100))%): \(regresiones.joined(separator: ", "))")
+    }
+
+    // MARK: - Ingesta
+
+    //Inserta una pagina de 1000 heroes y guarda, en un almacen nuevo en cada iteracion
+    private func medirIngesta() {
+        let registros = BancoPruebasApp.registros(1000)
+        for perfil in [PerfilAlmacen.sqliteWAL, .sqliteDelete, .memoria] {
+            var context: NSManagedObjectContext! = nil
+            banco.medir("ingesta-coredata/\(perfil.rawValue)/1000", unidad: "filas", elementos: registros.count, preparar: {
+                context = self.contextoNuevo(perfil: perfil, nombre: "ingesta-\(perfil.rawValue)")
+            }) {
+                context.performAndWait {
+                    self.insertar(registros, en: context)
+                    try! context.save()
+                    context.reset()
+                }
+            }
+        }
+    }
+
+    // MARK: - Fetch
+
+    //Primer pintado de la lista: fetch completo ordenado por nombre y acceso a la primera fila y
+    //a una del medio, con el NSFetchedResultsController y con el indice proyectado en memoria
+    private func medirFetch() {
+        for tamano in BancoPruebasApp.tamanosCatalogo {
+            let context = contextoNuevo(perfil: .sqliteWAL, nombre: "catalogo-\(tamano)")
+            context.performAndWait {
+                for inicio in stride(from: 0, to: tamano, by: 1000) {
+                    self.insertar(BancoPruebasApp.registros(min(1000, tamano - inicio), desde: inicio), en: context)
+                    try! context.save()
+                    context.reset()
+                }
+            }
+
+            banco.medir("frc-fetch/\(tamano)", unidad: "fetch") {
+                let lectura = NSManagedObjectContext(concurrencyType: .privateQueueConcurrencyType)
+                lectura.persistentStoreCoordinator = context.persistentStoreCoordinator
+                lectura.performAndWait {
+                    let fetchRequest: NSFetchRequest<Heroe> = Heroe.fetchRequest()
+                    fetchRequest.fetchBatchSize = 20
+                    fetchRequest.sortDescriptors = [NSSortDescriptor(key: "nombre", ascending: true)]
+                    let frc = NSFetchedResultsController(fetchRequest: fetchRequest, managedObjectContext: lectura, sectionNameKeyPath: nil, cacheName: nil)
+                    try! frc.performFetch()
+                    consumir(frc.object(at: IndexPath(row: 0, section: 0)).nombre)
+                    consumir(frc.object(at: IndexPath(row: tamano / 2, section: 0)).nombre)
+                }
+            }
+
+            let urlIndice = directorio.appendingPathComponent("indice-\(tamano).bin")
+            IndiceNombres.regenerar(context: context, url: urlIndice)
+            banco.medir("indice-nombres/\(tamano)", unidad: "apertura") {
+                guard let indice = IndiceNombres(url: urlIndice), indice.numeroSecciones > 0 else {
+                    return
+                }
+                consumir(indice.nombre(en: IndexPath(row: 0, section: 0)))
+                let seccion = indice.numeroSecciones / 2
+                consumir(indice.nombre(en: IndexPath(row: indice.numeroFilas(enSeccion: seccion) / 2, section: seccion)))
+            }
+        }
+    }
+
+    // MARK: - Miniaturas
+
+    private func medirMiniaturas() {
+        //Tamaños de la imagen completa y de la variante standard_small que guarda el catalogo semilla
+        for (ancho, alto) in [(300, 300), (65, 45)] {
+            let datos = BancoPruebasApp.jpeg(ancho: ancho, alto: alto)
+            banco.medir("miniatura/\(ancho)x\(alto)", unidad: "imagenes", elementos: 10) {
+                for _ in 0..<10 {
+                    consumir(CacheImagenes.shared.decodificar(datos))
+                }
+            }
+        }
+    }
+
+    // MARK: - Datos
+
+    private func contextoNuevo(perfil: PerfilAlmacen, nombre: String) -> NSManagedObjectContext {
+        let coordinator = NSPersistentStoreCoordinator(managedObjectModel: modelo)
+        let url = directorio.appendingPathComponent(nombre + ".sqlite")
+        for sufijo in ["", "-wal", "-shm"] {
+            try? FileManager.default.removeItem(at: URL(fileURLWithPath: url.path + sufijo))
+        }
+        switch perfil {
+        case .sqliteWAL:
+            _ = try! coordinator.addPersistentStore(ofType: NSSQLiteStoreType, configurationName: nil, at: url, options: nil)
+        case .sqliteDelete:
+            let opciones = [NSSQLitePragmasOption: ["journal_mode": "DELETE"]]
+            _ = try! coordinator.addPersistentStore(ofType: NSSQLiteStoreType, configurationName: nil, at: url, options: opciones)
+        case .memoria:
+            _ = try! coordinator.addPersistentStore(ofType: NSInMemoryStoreType, configurationName: nil, at: nil, options: nil)
+        }
+        let context = NSManagedObjectContext(concurrencyType: .privateQueueConcurrencyType)
+        context.persistentStoreCoordinator = coordinator
+        return context
+    }
+
+    private func insertar(_ registros: [RegistroHeroe], en context: NSManagedObjectContext) {
+        for registro in registros {
+            let heroe = NSEntityDescription.insertNewObject(forEntityName: "Heroe", into: context)
+            heroe.setValue(registro.id, forKey: "idMarvel")
+            heroe.setValue(registro.nombre, forKey: "nombre")
+            heroe.setValue(registro.descripcion, forKey: "descripcion")
+            heroe.setValue(registro.modificado, forKey: "modificado")
+        }
+    }
+
+    //Heroes sinteticos con nombres variados para que el orden y las secciones se parezcan a los reales
+    private class func registros(_ numero: Int, desde inicio: Int = 0) -> [RegistroHeroe] {
+        let prefijos = ["Iron", "Spider", "Black", "Ángel", "Doctor", "Captain", "3-D", "Ms.", "Zero", "Night"]
+        return (inicio..<(inicio + numero)).map { posicion in
+            RegistroHeroe(id: Int32(posicion), nombre: "\(prefijos[(posicion * 7) % prefijos.count]) \(posicion)",
+                          descripcion: posicion % 2 == 0 ? "" : "Personaje de prueba numero \(posicion)",
+                          urlImagen: nil, modificado: Date(timeIntervalSince1970: 1_400_000_000 + Double(posicion)))
+        }
+    }
+
+    private class func jpeg(ancho: Int, alto: Int) -> Data {
+        let tamano = CGSize(width: ancho, height: alto)
+        UIGraphicsBeginImageContextWithOptions(tamano, true, 1)
+        defer { UIGraphicsEndImageContext() }
+        for fila in 0..<alto {
+            UIColor(hue: CGFloat(fila) / CGFloat(alto), saturation: 0.8, brightness: 0.9, alpha: 1).setFill()
+            UIRectFill(CGRect(x: 0, y: fila, width: ancho, height: 1))
+        }
+        let imagen = UIGraphicsGetImageFromCurrentImageContext()!
+        return imagen.jpegData(compressionQuality: 0.8)!
+    }
+}
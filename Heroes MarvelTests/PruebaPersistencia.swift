@@ -0,0 +1,59 @@
+//
+//  PruebaPersistencia.swift
+//  Heroes MarvelTests
+//
+//  Created by Borja Gil Herrero on 19/10/2026.
+//  Copyright © 2026 Alsis GHE. All rights reserved.
+//
+
+import XCTest
+import Redbeard
+@testable import Heroes_Marvel
+
+//Fila de las pruebas, en su propia tabla. El nombre es unico para poder provocar un fallo en un lote
+@objc(FilaPruebaPersistencia)
+final class FilaPrueba: RBORMObject, IndicesORM {
+
+    @objc dynamic var nombre = ""
+    @objc dynamic var valor = 0
+
+    static var indicesSQLite: [IndiceSQLite] {
+        return [IndiceSQLite(["nombre"], unico: true)]
+    }
+}
+
+//Base de las pruebas de Persistencia: cada prueba tiene su directorio temporal y bases de datos
+//nuevas, con el SQLite del simulador o del dispositivo
+class PruebaPersistencia: XCTestCase {
+
+    let directorio = FileManager.default.temporaryDirectory.appendingPathComponent("PruebasPersistencia", isDirectory: true)
+    let tabla = SentenciasORM.identificador(FilaPrueba.tableName())
+
+    override func setUp() {
+        super.setUp()
+        try? FileManager.default.removeItem(at: directorio)
+        try? FileManager.default.createDirectory(at: directorio, withIntermediateDirectories: true, attributes: nil)
+    }
+
+    override func tearDown() {
+        try? FileManager.default.removeItem(at: directorio)
+        super.tearDown()
+    }
+
+    func baseDatos(_ nombre: String) -> String {
+        let ruta = directorio.appendingPathComponent(nombre + ".sqlite").path
+        for sufijo in ["", "-wal", "-shm", "-journal"] {
+            try? FileManager.default.removeItem(atPath: ruta + sufijo)
+        }
+        return ruta
+    }
+
+    func crearTabla(en conexion: ConexionSQLite) throws {
+        try conexion.ejecutarScript("CREATE TABLE \(tabla) (\"pk\" INTEGER PRIMARY KEY AUTOINCREMENT, \"nombre\" TEXT NOT NULL, \"valor\" INTEGER NOT NULL)")
+    }
+
+    func contar(en conexion: ConexionSQLite) throws -> Int {
+        let total = try conexion.consultar("SELECT count(*) FROM \(tabla)").scalarValue as? NSNumber
+        return total?.intValue ?? -1
+    }
+}
@@ -0,0 +1,36 @@
+//
+//  PruebasCacheSentencias.swift
+//  Heroes MarvelTests
+//
+//  Created by Borja Gil Herrero on 19/10/2026.
+//  Copyright © 2026 Alsis GHE. All rights reserved.
+//
+
+import XCTest
+@testable import Heroes_Marvel
+
+final class PruebasCacheSentencias: PruebaPersistencia {
+
+    //Con sitio para dos: repetir acierta, la tercera expulsa a la menos usada y volver a ella compila
+    func testAciertosYExpulsiones() throws {
+        let conexion = try ConexionSQLite(ruta: baseDatos("cache"), capacidadCache: 2)
+        for sql in ["SELECT 1", "SELECT 1", "SELECT 2", "SELECT 3", "SELECT 1"] {
+            _ = try conexion.consultar(sql)
+        }
+        let estadisticas = conexion.estadisticasSentencias
+        XCTAssertEqual(estadisticas.aciertos, 1)
+        XCTAssertEqual(estadisticas.fallos, 4)
+        XCTAssertEqual(estadisticas.expulsiones, 2)
+    }
+
+    //Una sentencia guardada se reinicia al devolverla: la siguiente ejecucion no arrastra parametros
+    func testReutilizaConParametrosNuevos() throws {
+        let conexion = try ConexionSQLite(ruta: baseDatos("parametros"))
+        try crearTabla(en: conexion)
+        for valor in 0..<3 {
+            try conexion.ejecutar("INSERT INTO \(tabla) (nombre, valor) VALUES (?, ?)", valores: ["fila \(valor)", NSNumber(value: valor)])
+        }
+        XCTAssertEqual(try contar(en: conexion), 3)
+        XCTAssertGreaterThanOrEqual(conexion.estadisticasSentencias.aciertos, 2)
+    }
+}
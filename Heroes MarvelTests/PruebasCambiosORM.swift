@@ -0,0 +1,99 @@
+//
+//  PruebasCambiosORM.swift
+//  Heroes MarvelTests
+//
+//  Created by Borja Gil Herrero on 19/10/2026.
+//  Copyright © 2026 Alsis GHE. All rights reserved.
+//
+
+import XCTest
+import Redbeard
+@testable import Heroes_Marvel
+
+//Guarda los avisos que recibe y cumple la expectativa del siguiente
+private final class ObservadorPrueba: ObservadorCambiosORM {
+
+    var avisos = [CambiosORM]()
+    var siguiente: XCTestExpectation?
+
+    func confirmados(_ cambios: CambiosORM) {
+        avisos.append(cambios)
+        siguiente?.fulfill()
+        siguiente = nil
+    }
+}
+
+final class PruebasCambiosORM: PruebaPersistencia {
+
+    private var conexion: ConexionSQLite!
+    private var observador: ObservadorPrueba!
+    private let cola = DispatchQueue(label: "PruebasCambiosORM")
+
+    override func setUp() {
+        super.setUp()
+        conexion = try! ConexionSQLite(ruta: baseDatos("cambios"), identificador: "pruebas-cambios")
+        try! crearTabla(en: conexion)
+        observador = ObservadorPrueba()
+    }
+
+    override func tearDown() {
+        CentroCambiosORM.shared.eliminar(observador)
+        super.tearDown()
+    }
+
+    private func esperarAviso(_ bloque: () throws -> Void) rethrows -> CambiosORM? {
+        let aviso = expectation(description: "aviso de cambios")
+        cola.sync { observador.siguiente = aviso }
+        try bloque()
+        wait(for: [aviso], timeout: 5)
+        return cola.sync { observador.avisos.last }
+    }
+
+    //Varias filas en una transaccion llegan en un solo aviso, agrupadas por tabla
+    func testUnAvisoPorTransaccion() throws {
+        CentroCambiosORM.shared.registrar(observador, cola: cola)
+        let cambios = try esperarAviso {
+            try conexion.enTransaccion { () throws -> Void in
+                for posicion in 0..<3 {
+                    try self.conexion.ejecutar("INSERT INTO \(self.tabla) (nombre, valor) VALUES (?, ?)", valores: ["fila \(posicion)", NSNumber(value: posicion)])
+                }
+                try self.conexion.ejecutar("UPDATE \(self.tabla) SET valor = 10 WHERE nombre = 'fila 0'")
+            }
+        }
+        XCTAssertEqual(cambios?.identificador, "pruebas-cambios")
+        XCTAssertEqual(cambios?.tablas.count, 1)
+        XCTAssertEqual(cambios?.tablas.first?.insertados.count, 3)
+        XCTAssertEqual(cambios?.tablas.first?.actualizados, [])
+        XCTAssertEqual(cola.sync { observador.avisos.count }, 1)
+    }
+
+    //Sin observadores vaciar una tabla va tal cual; con alguno se borra fila a fila para avisar
+    func testBorradoPorFilasSoloConObservadores() throws {
+        let vaciar = "DELETE FROM \(tabla);"
+        XCTAssertEqual(SentenciasORM.conBorradoPorFilas(vaciar), vaciar)
+
+        CentroCambiosORM.shared.registrar(observador, cola: cola)
+        XCTAssertEqual(SentenciasORM.conBorradoPorFilas(vaciar), "DELETE FROM \(tabla) WHERE 1")
+        XCTAssertEqual(SentenciasORM.conBorradoPorFilas("DELETE FROM \(tabla) WHERE valor = 1"), "DELETE FROM \(tabla) WHERE valor = 1")
+
+        CentroCambiosORM.shared.eliminar(observador)
+        XCTAssertEqual(SentenciasORM.conBorradoPorFilas(vaciar), vaciar)
+    }
+
+    //Vaciar la tabla con el ORM avisa de cada fila borrada
+    func testVaciarTablaAvisaDeLosBorrados() throws {
+        let filas = (0..<5).map { posicion -> FilaPrueba in
+            let fila = FilaPrueba()
+            fila.nombre = "fila \(posicion)"
+            return fila
+        }
+        try FilaPrueba.guardar(filas, en: conexion)
+
+        CentroCambiosORM.shared.registrar(observador, cola: cola)
+        let cambios = try esperarAviso {
+            _ = try RBORMQuery.deleteQuery(withObjectType: FilaPrueba.self, withDatabaseIdentifier: conexion.identificador).ejecutar(en: conexion)
+        }
+        XCTAssertEqual(cambios?.cambios(de: FilaPrueba.self)?.borrados, filas.map { Int64($0.pk) }.sorted())
+        XCTAssertEqual(try contar(en: conexion), 0)
+    }
+}
@@ -0,0 +1,78 @@
+//
+//  PruebasCursor.swift
+//  Heroes MarvelTests
+//
+//  Created by Borja Gil Herrero on 19/10/2026.
+//  Copyright © 2026 Alsis GHE. All rights reserved.
+//
+
+import XCTest
+import Redbeard
+@testable import Heroes_Marvel
+
+final class PruebasCursor: PruebaPersistencia {
+
+    private var conexion: ConexionSQLite!
+
+    override func setUp() {
+        super.setUp()
+        conexion = try! ConexionSQLite(ruta: baseDatos("cursor"), identificador: "pruebas-cursor")
+        try! crearTabla(en: conexion)
+        try! conexion.enTransaccion { () throws -> Void in
+            for posicion in 0..<50 {
+                try self.conexion.ejecutar("INSERT INTO \(self.tabla) (nombre, valor) VALUES (?, ?)", valores: ["fila \(posicion)", NSNumber(value: posicion)])
+            }
+        }
+    }
+
+    func testRecorreTodasEnOrden() throws {
+        var valores = [Int64]()
+        var nombres = [String]()
+        let filas = try conexion.recorrer("SELECT nombre, valor FROM \(tabla) ORDER BY valor") { fila in
+            nombres.append(fila.cadena(0) ?? "")
+            valores.append(fila.int64(1))
+            return true
+        }
+        XCTAssertEqual(filas, 50)
+        XCTAssertEqual(valores, (0..<50).map { Int64($0) })
+        XCTAssertEqual(nombres.last, "fila 49")
+    }
+
+    //Parar a mitad devuelve la sentencia a la cache: la conexion se puede volver a usar enseguida
+    func testParaYLiberaLaSentencia() throws {
+        let filas = try conexion.recorrer("SELECT valor FROM \(tabla) ORDER BY valor") { fila in
+            fila.int64(0) < 4
+        }
+        XCTAssertEqual(filas, 5)
+        try conexion.ejecutar("INSERT INTO \(tabla) (nombre, valor) VALUES ('despues', 50)")
+        XCTAssertEqual(try contar(en: conexion), 51)
+        XCTAssertEqual(try conexion.recorrer("SELECT valor FROM \(tabla)") { _ in true }, 51)
+    }
+
+    //Los textos y blobs se leen prestados de SQLite; cadena() y datos() copian y NULL es nil
+    func testTiposDeColumna() throws {
+        let bytes: [UInt8] = [0, 1, 2, 250]
+        try conexion.recorrer("SELECT 'héroe', X'000102FA', NULL, 2.5") { fila in
+            XCTAssertEqual(fila.numeroColumnas, 4)
+            XCTAssertEqual(Array(fila.texto(0)), Array("héroe".utf8))
+            XCTAssertEqual(Array(fila.blob(1)), bytes)
+            XCTAssertEqual(fila.datos(1), Data(bytes))
+            XCTAssertTrue(fila.esNulo(2))
+            XCTAssertNil(fila.cadena(2))
+            XCTAssertEqual(fila.texto(2).count, 0)
+            XCTAssertEqual(fila.double(3), 2.5)
+            return true
+        }
+    }
+
+    func testRecorreObjetosDeUnaConsulta() throws {
+        let consulta = RBORMQuery.selectQuery(withObjectType: FilaPrueba.self, withDatabaseIdentifier: conexion.identificador).where("valor >= 40")
+        var nombres = [String]()
+        let filas = try consulta.recorrer(en: conexion) { objeto in
+            nombres.append((objeto as? FilaPrueba)?.nombre ?? "")
+            return true
+        }
+        XCTAssertEqual(filas, 10)
+        XCTAssertEqual(Set(nombres), Set((40..<50).map { "fila \($0)" }))
+    }
+}
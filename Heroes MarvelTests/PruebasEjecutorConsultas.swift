@@ -0,0 +1,80 @@
+//
+//  PruebasEjecutorConsultas.swift
+//  Heroes MarvelTests
+//
+//  Created by Borja Gil Herrero on 19/10/2026.
+//  Copyright © 2026 Alsis GHE. All rights reserved.
+//
+
+import XCTest
+import Redbeard
+@testable import Heroes_Marvel
+
+final class PruebasEjecutorConsultas: PruebaPersistencia {
+
+    private var conexion: ConexionSQLite!
+    private var ejecutor: EjecutorConsultas!
+    private let cola = DispatchQueue(label: "PruebasEjecutorConsultas")
+
+    override func setUp() {
+        super.setUp()
+        conexion = try! ConexionSQLite(ruta: baseDatos("ejecutor"), identificador: "pruebas-ejecutor")
+        try! crearTabla(en: conexion)
+        try! conexion.ejecutar("INSERT INTO \(tabla) (nombre, valor) VALUES ('ejecutor', 1)")
+        ejecutor = EjecutorConsultas(conexion: conexion)
+    }
+
+    private func consulta() -> RBORMQuery {
+        return RBORMQuery.selectQuery(withObjectType: FilaPrueba.self, withDatabaseIdentifier: conexion.identificador)
+    }
+
+    //Cuenta hasta cien millones: tarda varios segundos si no se corta
+    private func consultaLenta() -> RBORMQuery {
+        return consulta().where("valor < (WITH RECURSIVE c(x) AS (SELECT 1 UNION ALL SELECT x + 1 FROM c WHERE x < 100000000) SELECT count(*) FROM c)")
+    }
+
+    private func filas(_ resultado: ResultadoConsulta) -> Int {
+        if case .filas(let objetos) = resultado {
+            return objetos.count
+        }
+        return -1
+    }
+
+    //Cancelar corta la consulta en marcha, no llama a su completion y la siguiente va bien
+    func testCancelarCortaLaConsultaEnMarcha() {
+        let tarea = ejecutor.ejecutar(consultaLenta(), cola: cola) { _ in
+            XCTFail("se ha llamado al completion de una tarea cancelada")
+        }
+        Thread.sleep(forTimeInterval: 0.05)
+        let inicio = Date()
+        tarea.cancel()
+
+        //Con una conexion las consultas van de una en una: esta empieza cuando la cortada ha terminado
+        let siguiente = expectation(description: "consulta siguiente")
+        ejecutor.ejecutar(consulta(), cola: cola) { resultado in
+            XCTAssertEqual(self.filas(resultado), 1)
+            siguiente.fulfill()
+        }
+        wait(for: [siguiente], timeout: 10)
+        XCTAssertLessThan(Date().timeIntervalSince(inicio), 2, "la consulta cancelada no se ha cortado")
+        cola.sync {}
+    }
+
+    //Dos peticiones de la misma consulta comparten ejecucion; cancelar una no corta la otra.
+    //La consulta lenta ocupa la conexion para que las dos esperen en cola a la vez
+    func testConsultasIgualesSeUnen() {
+        let lenta = ejecutor.ejecutar(consultaLenta(), cola: cola) { _ in }
+        let primera = ejecutor.ejecutar(consulta(), cola: cola) { _ in
+            XCTFail("se ha llamado al completion de una tarea cancelada")
+        }
+        let segunda = expectation(description: "segunda peticion")
+        ejecutor.ejecutar(consulta(), cola: cola) { resultado in
+            XCTAssertEqual(self.filas(resultado), 1)
+            segunda.fulfill()
+        }
+        primera.cancel()
+        lenta.cancel()
+        wait(for: [segunda], timeout: 10)
+        cola.sync {}
+    }
+}
@@ -0,0 +1,75 @@
+//
+//  PruebasGuardadoLote.swift
+//  Heroes MarvelTests
+//
+//  Created by Borja Gil Herrero on 19/10/2026.
+//  Copyright © 2026 Alsis GHE. All rights reserved.
+//
+
+import XCTest
+@testable import Heroes_Marvel
+
+final class PruebasGuardadoLote: PruebaPersistencia {
+
+    private var conexion: ConexionSQLite!
+
+    override func setUp() {
+        super.setUp()
+        conexion = try! ConexionSQLite(ruta: baseDatos("lote"))
+        try! crearTabla(en: conexion)
+    }
+
+    private func filas(_ numero: Int, repetida: Int? = nil) -> [FilaPrueba] {
+        return (0..<numero).map { posicion in
+            let fila = FilaPrueba()
+            fila.nombre = posicion == repetida ? "repetido" : "fila \(posicion)"
+            fila.valor = posicion
+            return fila
+        }
+    }
+
+    //Mas filas que las de dos sentencias y una repetida en el primer grupo, que se repite fila a fila
+    func testFilaQueFallaNoTiraElLote() throws {
+        let existente = FilaPrueba()
+        existente.nombre = "repetido"
+        existente.valor = 1
+        try existente.guardar(en: conexion)
+        XCTAssertTrue(existente.hasPrimaryKey)
+
+        let numero = RBORMObject.filasPorSentenciaMaximas * 2 + 10
+        let repetida = 42
+        let lote = filas(numero, repetida: repetida)
+        existente.valor = 2
+        let resultado = try FilaPrueba.guardar(lote + [existente], en: conexion)
+
+        XCTAssertFalse(resultado.guardado(repetida))
+        XCTAssertFalse(lote[repetida].hasPrimaryKey)
+        XCTAssertEqual(resultado.guardados, numero)
+        XCTAssertEqual(try contar(en: conexion), numero)
+
+        let valor = try conexion.consultar("SELECT valor FROM \(tabla) WHERE pk = ?", valores: [NSNumber(value: existente.pk)]).scalarValue as? NSNumber
+        XCTAssertEqual(valor?.intValue, 2, "el objeto que ya existia no se ha actualizado")
+    }
+
+    //Cada objeto recibe el rowid de su fila, tambien en los grupos de varias filas por sentencia
+    func testCadaObjetoRecibeSuPk() throws {
+        let lote = filas(RBORMObject.filasPorSentenciaMaximas + 5)
+        try FilaPrueba.guardar(lote, en: conexion)
+        for fila in lote {
+            let nombre = try conexion.consultar("SELECT nombre FROM \(tabla) WHERE pk = ?", valores: [NSNumber(value: fila.pk)]).scalarValue as? String
+            XCTAssertEqual(nombre, fila.nombre)
+        }
+    }
+
+    //AUTOINCREMENT: la clave de la ultima fila, borrada, no se vuelve a dar
+    func testNoReutilizaPkBorradas() throws {
+        let lote = filas(10)
+        try FilaPrueba.guardar(lote, en: conexion)
+        let ultima = lote.map { $0.pk }.max() ?? 0
+        try conexion.ejecutar("DELETE FROM \(tabla) WHERE pk = ?", valores: [NSNumber(value: ultima)])
+        let nueva = FilaPrueba()
+        nueva.nombre = "nueva"
+        try FilaPrueba.guardar([nueva], en: conexion)
+        XCTAssertGreaterThan(nueva.pk, ultima)
+    }
+}
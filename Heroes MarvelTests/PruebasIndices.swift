@@ -0,0 +1,68 @@
+//
+//  PruebasIndices.swift
+//  Heroes MarvelTests
+//
+//  Created by Borja Gil Herrero on 19/10/2026.
+//  Copyright © 2026 Alsis GHE. All rights reserved.
+//
+
+import XCTest
+@testable import Heroes_Marvel
+
+final class PruebasIndices: PruebaPersistencia {
+
+    private var conexion: ConexionSQLite!
+    private let nombreTabla = FilaPrueba.tableName()
+
+    override func setUp() {
+        super.setUp()
+        conexion = try! ConexionSQLite(ruta: baseDatos("indices"))
+    }
+
+    //Nombre y texto de los indices de la tabla que hay en sqlite_master
+    private func indices() throws -> [String: String] {
+        let filas = try conexion.consultar("SELECT name, sql FROM sqlite_master WHERE type = 'index' AND tbl_name = ? AND sql IS NOT NULL", valores: [nombreTabla])
+        var indices = [String: String]()
+        for fila in 0..<filas.rowCount {
+            indices[filas.value(at: 0, forRow: fila) as? String ?? ""] = filas.value(at: 1, forRow: fila) as? String
+        }
+        return indices
+    }
+
+    //Sin tabla no hace nada y lo vuelve a intentar: en cuanto existe crea los declarados
+    func testCreaLosDeclaradosCuandoExisteLaTabla() throws {
+        conexion.asegurarIndices(FilaPrueba.self)
+        XCTAssertFalse(try conexion.sincronizarIndices(FilaPrueba.indicesSQLite, tabla: nombreTabla))
+
+        try crearTabla(en: conexion)
+        conexion.asegurarIndices(FilaPrueba.self)
+        let declarado = FilaPrueba.indicesSQLite[0]
+        XCTAssertEqual(try indices(), [declarado.nombre(en: nombreTabla): declarado.creacion(en: nombreTabla)])
+    }
+
+    //Buscar por la columna indexada no recorre la tabla; por una sin indice si
+    func testElPlanUsaElIndice() throws {
+        try crearTabla(en: conexion)
+        conexion.asegurarIndices(FilaPrueba.self)
+        XCTAssertEqual(try conexion.recorridosCompletos("SELECT * FROM \(tabla) WHERE nombre = ?", valores: ["fila"]), [])
+        XCTAssertFalse(try conexion.recorridosCompletos("SELECT * FROM \(tabla) WHERE valor = ?", valores: [NSNumber(value: 1)]).isEmpty)
+    }
+
+    //Un indice que cambia se rehace, uno que ya no se declara se borra y los que no empiezan por
+    //orm_ no se tocan
+    func testSincronizaCambiosDeDeclaracion() throws {
+        try crearTabla(en: conexion)
+        try conexion.ejecutarScript("CREATE INDEX propio_valor ON \(tabla) (valor)")
+        let original = [IndiceSQLite(["nombre"], unico: true), IndiceSQLite(["valor"], nombre: "valores")]
+        XCTAssertTrue(try conexion.sincronizarIndices(original, tabla: nombreTabla))
+        XCTAssertEqual(try indices().count, 3)
+
+        let cambiado = [IndiceSQLite(["nombre"], unico: true, donde: "valor > 0")]
+        try conexion.sincronizarIndices(cambiado, tabla: nombreTabla)
+        let despues = try indices()
+        XCTAssertEqual(despues[cambiado[0].nombre(en: nombreTabla)], cambiado[0].creacion(en: nombreTabla))
+        XCTAssertNil(despues[original[1].nombre(en: nombreTabla)])
+        XCTAssertNotNil(despues["propio_valor"])
+        XCTAssertEqual(despues.count, 2)
+    }
+}
@@ -0,0 +1,70 @@
+//
+//  PruebasPoolConexiones.swift
+//  Heroes MarvelTests
+//
+//  Created by Borja Gil Herrero on 19/10/2026.
+//  Copyright © 2026 Alsis GHE. All rights reserved.
+//
+
+import XCTest
+import Redbeard
+@testable import Heroes_Marvel
+
+final class PruebasPoolConexiones: PruebaPersistencia {
+
+    private var pool: PoolConexiones!
+
+    override func setUp() {
+        super.setUp()
+        var configuracion = ConfiguracionPool()
+        configuracion.lectores = 2
+        pool = try! PoolConexiones(ruta: baseDatos("pool"), identificador: "pruebas-pool", configuracion: configuracion)
+        try! crearTabla(en: pool.escritor)
+    }
+
+    override func tearDown() {
+        RBORMCenter.shared().separarPool(identificador: pool.identificador)
+        pool = nil
+        super.tearDown()
+    }
+
+    //Un lector sigue viendo la base de datos como al empezar aunque el escritor confirme entre medias
+    func testLectorConInstantanea() throws {
+        let (antes, durante) = try pool.leer { lector -> (Int, Int) in
+            let antes = try self.contar(en: lector)
+            try self.pool.escribir { escritor in
+                try escritor.ejecutar("INSERT INTO \(self.tabla) (nombre, valor) VALUES ('pool', 1)")
+            }
+            return (antes, try self.contar(en: lector))
+        }
+        XCTAssertEqual(antes, 0)
+        XCTAssertEqual(durante, 0, "el lector ha visto la escritura dentro de su transaccion")
+        XCTAssertEqual(try pool.leer { try self.contar(en: $0) }, 1)
+    }
+
+    //Los lectores son de solo lectura: escribir en uno falla
+    func testLectoresDeSoloLectura() {
+        XCTAssertThrowsError(try pool.leer { lector in
+            try lector.ejecutar("INSERT INTO \(self.tabla) (nombre, valor) VALUES ('lector', 1)")
+        })
+    }
+
+    //Con el pool adjunto, ejecutar() lleva las consultas de su identificador al pool
+    func testConsultasDelIdentificadorVanAlPool() throws {
+        let fila = FilaPrueba()
+        fila.nombre = "adjunto"
+        fila.valor = 7
+        try fila.guardar(en: pool)
+
+        RBORMCenter.shared().adjuntarPool(pool)
+        XCTAssertTrue(RBORMCenter.shared().pool(identificador: "pruebas-pool") === pool)
+        let objetos = try RBORMQuery.selectQuery(withObjectType: FilaPrueba.self, withDatabaseIdentifier: "pruebas-pool").where("valor = 7").ejecutar()
+        XCTAssertEqual(objetos.compactMap { ($0 as? FilaPrueba)?.nombre }, ["adjunto"])
+
+        _ = try RBORMQuery.deleteQuery(withObjectType: FilaPrueba.self, withDatabaseIdentifier: "pruebas-pool").ejecutar()
+        XCTAssertEqual(try pool.leer { try self.contar(en: $0) }, 0)
+
+        XCTAssertTrue(RBORMCenter.shared().separarPool(identificador: "pruebas-pool") === pool)
+        XCTAssertNil(RBORMCenter.shared().pool(identificador: "pruebas-pool"))
+    }
+}
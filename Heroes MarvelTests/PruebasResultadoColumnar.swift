@@ -0,0 +1,67 @@
+//
+//  PruebasResultadoColumnar.swift
+//  Heroes MarvelTests
+//
+//  Created by Borja Gil Herrero on 19/10/2026.
+//  Copyright © 2026 Alsis GHE. All rights reserved.
+//
+
+import XCTest
+@testable import Heroes_Marvel
+
+final class PruebasResultadoColumnar: PruebaPersistencia {
+
+    private var conexion: ConexionSQLite!
+
+    override func setUp() {
+        super.setUp()
+        conexion = try! ConexionSQLite(ruta: baseDatos("columnar"))
+        try! conexion.ejecutarScript("CREATE TABLE celdas (nombre TEXT, descripcion TEXT, imagen BLOB, valor INTEGER, nota REAL)")
+    }
+
+    //Varias columnas de texto y blob en la misma fila, con nulos y textos vacios entre medias:
+    //cada celda tiene que devolver sus bytes y no los de otra columna
+    func testVariasColumnasDeTextoYBlob() throws {
+        let filas: [[Any]] = [
+            ["Iron Man", "Tony Stark", Data([1, 2, 3]), NSNumber(value: 1), NSNumber(value: 0.5)],
+            ["Ángel", NSNull(), Data([7, 7]), NSNumber(value: 2), NSNull()],
+            ["", "Peter Parker, vecino amigable", Data([255]), NSNull(), NSNumber(value: 2.25)],
+            [NSNull(), "Natasha", NSNull(), NSNumber(value: 4), NSNumber(value: 3)],
+        ]
+        for fila in filas {
+            try conexion.ejecutar("INSERT INTO celdas VALUES (?, ?, ?, ?, ?)", valores: fila)
+        }
+
+        let resultado = try conexion.consultarColumnas("SELECT nombre, descripcion, imagen, valor, nota FROM celdas ORDER BY rowid")
+        XCTAssertEqual(resultado.numeroFilas, filas.count)
+        XCTAssertEqual((0..<filas.count).map { resultado.cadena(0, fila: $0) }, ["Iron Man", "Ángel", "", nil])
+        XCTAssertEqual((0..<filas.count).map { resultado.cadena(1, fila: $0) }, ["Tony Stark", nil, "Peter Parker, vecino amigable", "Natasha"])
+        XCTAssertEqual(resultado.valor(2, fila: 0) as? Data, Data([1, 2, 3]))
+        XCTAssertEqual(resultado.valor(2, fila: 1) as? Data, Data([7, 7]))
+        XCTAssertEqual(resultado.valor(2, fila: 2) as? Data, Data([255]))
+        XCTAssertTrue(resultado.valor(2, fila: 3) is NSNull)
+        XCTAssertEqual(resultado.enteros(3), [1, 2, 0, 4])
+        XCTAssertTrue(resultado.esNulo(3, fila: 2))
+        XCTAssertEqual(resultado.suma(4), 5.75)
+
+        //Las mismas celdas que da consultar(), por los accesos de RBSQLiteResultSet
+        let referencia = try conexion.consultar("SELECT nombre, descripcion, imagen, valor, nota FROM celdas ORDER BY rowid")
+        for fila in 0..<filas.count {
+            XCTAssertEqual(resultado.values(atRow: fila).map { "\($0)" }, referencia.values(atRow: fila).map { "\($0)" })
+        }
+    }
+
+    //Una columna que empieza con nulos y cambia de tipo a mitad (SQLite lo permite)
+    func testPrimeraCeldaNulaYTiposMezclados() throws {
+        try conexion.ejecutar("INSERT INTO celdas (nombre, valor) VALUES (NULL, NULL)")
+        try conexion.ejecutar("INSERT INTO celdas (nombre, valor) VALUES ('Thor', 7)")
+        try conexion.ejecutar("INSERT INTO celdas (nombre, valor) VALUES (42, 'ocho')")
+        try conexion.ejecutar("INSERT INTO celdas (nombre, valor) VALUES ('Loki', 9)")
+
+        let resultado = try conexion.consultarColumnas("SELECT nombre, valor FROM celdas ORDER BY rowid")
+        XCTAssertEqual((0..<4).map { resultado.cadena(0, fila: $0) }, [nil, "Thor", "42", "Loki"])
+        XCTAssertEqual(resultado.int64(1, fila: 1), 7)
+        XCTAssertEqual(resultado.valor(1, fila: 2) as? String, "ocho")
+        XCTAssertEqual(resultado.filasOrdenadas(por: 1, ascendente: false).last, 0)
+    }
+}
@@ -0,0 +1,79 @@
+//
+//  PruebasVFSComprimido.swift
+//  Heroes MarvelTests
+//
+//  Created by Borja Gil Herrero on 19/10/2026.
+//  Copyright © 2026 Alsis GHE. All rights reserved.
+//
+
+import XCTest
+@testable import Heroes_Marvel
+
+final class PruebasVFSComprimido: PruebaPersistencia {
+
+    private let texto = String(repeating: "Personaje de prueba comprimible. ", count: 40)
+    private let numero = 500
+
+    override func setUp() {
+        super.setUp()
+        VFSComprimido.shared.registrar()
+    }
+
+    private func insertar(en conexion: ConexionSQLite) throws {
+        try conexion.enTransaccion { () throws -> Void in
+            for posicion in 0..<numero {
+                try conexion.ejecutar("INSERT INTO \(tabla) (nombre, valor) VALUES (?, ?)", valores: ["\(posicion) \(texto)", NSNumber(value: posicion)])
+            }
+        }
+    }
+
+    //Paginas de 1 KB, varias por bloque, y sin xSync: el mapa solo se guarda al soltar el cerrojo
+    //y al cerrar. Al volver a abrir tiene que estar todo
+    func testCerrarYVolverAAbrir() throws {
+        let ruta = baseDatos("comprimido")
+        var escritura: ConexionSQLite? = try ConexionSQLite(ruta: ruta, vfs: VFSComprimido.nombre)
+        if let conexion = escritura {
+            try conexion.ejecutarScript("PRAGMA page_size = 1024; PRAGMA synchronous = OFF")
+            try crearTabla(en: conexion)
+            try insertar(en: conexion)
+            //Despues del primer mapa guardado: cambian bloques que ese mapa conoce
+            try conexion.ejecutar("UPDATE \(tabla) SET valor = valor + 1 WHERE valor % 3 = 0")
+            try conexion.ejecutar("DELETE FROM \(tabla) WHERE valor % 7 = 0")
+        }
+        escritura = nil
+
+        let esperados = (0..<numero).map { $0 % 3 == 0 ? $0 + 1 : $0 }.filter { $0 % 7 != 0 }
+        let conexion = try ConexionSQLite(ruta: ruta, vfs: VFSComprimido.nombre)
+        XCTAssertEqual(try conexion.consultar("PRAGMA integrity_check").scalarValue as? String, "ok")
+        XCTAssertEqual(try contar(en: conexion), esperados.count)
+        let suma = try conexion.consultar("SELECT sum(valor) FROM \(tabla)").scalarValue as? NSNumber
+        XCTAssertEqual(suma?.intValue, esperados.reduce(0, +))
+
+        let paginas = try conexion.consultar("PRAGMA page_count").scalarValue as? NSNumber
+        let tamano = try FileManager.default.attributesOfItem(atPath: ruta)[.size] as? NSNumber
+        XCTAssertLessThan(tamano?.int64Value ?? .max, (paginas?.int64Value ?? 0) * 1024, "el fichero no ocupa menos que sus paginas")
+    }
+
+    //Otra conexion ve lo que confirma la primera aunque tenga el mapa de bloques cargado
+    func testDosConexionesVenLosMismosDatos() throws {
+        let ruta = baseDatos("compartido")
+        let escritora = try ConexionSQLite(ruta: ruta, vfs: VFSComprimido.nombre)
+        try crearTabla(en: escritora)
+        let lectora = try ConexionSQLite(ruta: ruta, vfs: VFSComprimido.nombre)
+        XCTAssertEqual(try contar(en: lectora), 0)
+        try insertar(en: escritora)
+        XCTAssertEqual(try contar(en: lectora), numero)
+        XCTAssertEqual(try lectora.consultar("PRAGMA integrity_check").scalarValue as? String, "ok")
+    }
+
+    //El texto repetido se comprime: las estadisticas lo reflejan
+    func testEstadisticasDeCompresion() throws {
+        let conexion = try ConexionSQLite(ruta: baseDatos("estadisticas"), vfs: VFSComprimido.nombre)
+        let antes = VFSComprimido.shared.estadisticas()
+        try crearTabla(en: conexion)
+        try insertar(en: conexion)
+        let despues = VFSComprimido.shared.estadisticas()
+        XCTAssertGreaterThan(despues.bloquesEscritos, antes.bloquesEscritos)
+        XCTAssertLessThan(despues.bytesComprimidos - antes.bytesComprimidos, despues.bytesSinComprimir - antes.bytesSinComprimir)
+    }
+}
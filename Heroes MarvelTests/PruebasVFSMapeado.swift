@@ -0,0 +1,86 @@
+//
+//  PruebasVFSMapeado.swift
+//  Heroes MarvelTests
+//
+//  Created by Borja Gil Herrero on 19/10/2026.
+//  Copyright © 2026 Alsis GHE. All rights reserved.
+//
+
+import XCTest
+@testable import Heroes_Marvel
+
+final class PruebasVFSMapeado: PruebaPersistencia {
+
+    private var ruta = ""
+    private let numero = 2000
+
+    override func setUp() {
+        super.setUp()
+        VFSMapeado.shared.registrar()
+        ruta = baseDatos("mapeado")
+        let conexion = try! ConexionSQLite(ruta: ruta, vfs: VFSMapeado.nombre)
+        try! crearTabla(en: conexion)
+        let texto = String(repeating: "Personaje de prueba. ", count: 10)
+        try! conexion.enTransaccion { () throws -> Void in
+            for posicion in 0..<self.numero {
+                try conexion.ejecutar("INSERT INTO \(self.tabla) (nombre, valor) VALUES (?, ?)", valores: ["\(posicion) \(texto)", NSNumber(value: posicion)])
+            }
+        }
+    }
+
+    //Recorre la tabla en una conexion nueva, sin paginas en cache, despues de los PRAGMA
+    private func recorrer(pragmas: String? = nil) throws -> ContadoresVFS {
+        let conexion = try ConexionSQLite(ruta: ruta, vfs: VFSMapeado.nombre)
+        if let pragmas = pragmas {
+            try conexion.ejecutarScript(pragmas)
+        }
+        let (suma, contadores) = try VFSMapeado.shared.medir {
+            try conexion.consultar("SELECT sum(length(nombre) + valor) FROM \(tabla)").scalarValue as? NSNumber
+        }
+        XCTAssertNotNil(suma)
+        return contadores
+    }
+
+    //Sin PRAGMA mmap_size el VFS real sigue mapeando y todas las lecturas caen dentro del mapa,
+    //sin que SQLite use xFetch
+    func testLecturasDesdeElMapa() throws {
+        let contadores = try recorrer()
+        XCTAssertGreaterThan(contadores.lecturas, 0)
+        XCTAssertEqual(contadores.desdeMapa, contadores.lecturas)
+        XCTAssertEqual(contadores.desdeDisco, 0)
+        XCTAssertEqual(contadores.sinCopia, 0)
+    }
+
+    //PRAGMA mmap_size = 0 quita el mapa: todo va al fichero y se cuenta asi
+    func testRespetaMmapSizeCero() throws {
+        let contadores = try recorrer(pragmas: "PRAGMA mmap_size = 0")
+        XCTAssertGreaterThan(contadores.lecturas, 0)
+        XCTAssertEqual(contadores.desdeMapa, 0)
+        XCTAssertEqual(contadores.desdeDisco, contadores.lecturas)
+        XCTAssertEqual(contadores.anticipaciones, 0)
+    }
+
+    //Con PRAGMA mmap_size SQLite pide las paginas sin copia y apenas usa xRead
+    func testPaginasSinCopiaConMmapSize() throws {
+        let contadores = try recorrer(pragmas: "PRAGMA mmap_size = 268435456")
+        XCTAssertGreaterThan(contadores.sinCopia, 0)
+        XCTAssertEqual(contadores.desdeDisco, 0)
+    }
+
+    //Lo que escribe otra conexion hace crecer el fichero: la siguiente lectura rehace el mapa
+    func testRehaceElMapaCuandoCreceElFichero() throws {
+        let lectora = try ConexionSQLite(ruta: ruta, vfs: VFSMapeado.nombre)
+        XCTAssertEqual(try contar(en: lectora), numero)
+        let escritora = try ConexionSQLite(ruta: ruta, vfs: VFSMapeado.nombre)
+        let texto = String(repeating: "Crece. ", count: 100)
+        try escritora.enTransaccion { () throws -> Void in
+            for posicion in 0..<500 {
+                try escritora.ejecutar("INSERT INTO \(self.tabla) (nombre, valor) VALUES (?, ?)", valores: ["nueva \(posicion) \(texto)", NSNumber(value: posicion)])
+            }
+        }
+        let (total, contadores) = try VFSMapeado.shared.medir { try contar(en: lectora) }
+        XCTAssertEqual(total, numero + 500)
+        XCTAssertGreaterThan(contadores.remapeos, 0)
+        XCTAssertEqual(contadores.desdeDisco, 0)
+    }
+}
@@ -0,0 +1,33 @@
+// swift-tools-version:4.2
+//
+//  Package.swift
+//  MarvelSync
+//
+//  Partes de la sincronizacion que no dependen de UIKit ni de Core Data: firma de peticiones,
+//  tipos de la API, paginacion, decodificacion y plan de ingesta. La app compila estos mismos
+//  ficheros; el paquete permite ejecutarlos en Linux o macOS sin simulador.
+//
+
+import PackageDescription
+
+let package = Package(
+    name: "MarvelSync",
+    products: [
+        .library(name: "MarvelSync", targets: ["MarvelSync"]),
+        .executable(name: "hero-sync-bench", targets: ["hero-sync-bench"]),
+        .executable(name: "marvel-stub", targets: ["marvel-stub"]),
+        .executable(name: "marvel-microbench", targets: ["marvel-microbench"]),
+        .executable(name: "marvel-allocbench", targets: ["marvel-allocbench"]),
+    ],
+    targets: [
+        .target(name: "MarvelSync", dependencies: []),
+        //Argumentos y errores de los ejecutables
+        .target(name: "LineaComandos", dependencies: []),
+        .target(name: "hero-sync-bench", dependencies: ["MarvelSync", "LineaComandos"]),
+        .target(name: "marvel-stub", dependencies: ["MarvelSync", "LineaComandos"]),
+        .target(name: "marvel-microbench", dependencies: ["MarvelSync", "LineaComandos"]),
+        //Sustituye malloc en el proceso que lo enlaza: solo para marvel-allocbench
+        .target(name: "ContadorAsignaciones", dependencies: []),
+        .target(name: "marvel-allocbench", dependencies: ["MarvelSync", "LineaComandos", "ContadorAsignaciones"]),
+    ]
+)
@@ -0,0 +1,216 @@
+//
+//  ContadorAsignaciones.c
+//  MarvelSync
+//
+//  Created by Borja Gil Herrero on 19/10/2026.
+//  Copyright © 2026 Alsis GHE. All rights reserved.
+//
+
+#include "ContadorAsignaciones.h"
+
+#include <errno.h>
+#include <pthread.h>
+#include <stddef.h>
+
+//Nada de lo que se llama desde los ganchos puede reservar memoria: ni TLS (que en macOS se
+//reserva de forma perezosa), ni printf. Por eso el hilo que cuenta se guarda en una global y
+//los contadores son globales sin atomicos: solo los toca ese hilo
+static volatile int contando = 0;
+static pthread_t hiloContando;
+static contador_asignaciones_t contador;
+static int64_t vivos = 0;
+
+static inline int contando_aqui(void) {
+    return contando && pthread_equal(pthread_self(), hiloContando);
+}
+
+static inline void anotar_asignacion(size_t bytes) {
+    contador.asignaciones++;
+    contador.bytes += bytes;
+    vivos++;
+    if (vivos > contador.picoVivos) {
+        contador.picoVivos = vivos;
+    }
+}
+
+static inline void anotar_liberacion(void) {
+    contador.liberaciones++;
+    vivos--;
+}
+
+// MARK: - Retenciones de Swift
+
+//Puntero del runtime por el que pasa swift_retain (lo usa Instruments). Debil: si el runtime no
+//lo exporta queda a NULL y las retenciones no se cuentan
+extern void *(*_swift_retain)(void *) __attribute__((weak));
+static void *(*retenerOriginal)(void *) = NULL;
+
+static void *retener(void *objeto) {
+    if (contando_aqui()) {
+        contador.retenciones++;
+    }
+    return retenerOriginal(objeto);
+}
+
+static void instalar_retenciones(void) {
+    if (&_swift_retain != NULL && retenerOriginal == NULL) {
+        retenerOriginal = _swift_retain;
+        _swift_retain = retener;
+    }
+}
+
+int contador_retenciones_disponible(void) {
+    return &_swift_retain != NULL;
+}
+
+// MARK: - Reservas
+
+#if defined(__GLIBC__)
+
+//Las funciones de glibc que hay detras de malloc. Al definir malloc en el ejecutable, el
+//enlazador dinamico resuelve a estas versiones las llamadas de todo el proceso
+extern void *__libc_malloc(size_t);
+extern void *__libc_calloc(size_t, size_t);
+extern void *__libc_realloc(void *, size_t);
+extern void *__libc_memalign(size_t, size_t);
+extern void __libc_free(void *);
+
+static void instalar_reservas(void) {
+}
+
+int contador_disponible(void) {
+    return 1;
+}
+
+void *malloc(size_t bytes) {
+    void *puntero = __libc_malloc(bytes);
+    if (puntero != NULL && contando_aqui()) {
+        anotar_asignacion(bytes);
+    }
+    return puntero;
+}
+
+void *calloc(size_t numero, size_t bytes) {
+    void *puntero = __libc_calloc(numero, bytes);
+    if (puntero != NULL && contando_aqui()) {
+        anotar_asignacion(numero * bytes);
+    }
+    return puntero;
+}
+
+void *realloc(void *anterior, size_t bytes) {
+    void *puntero = __libc_realloc(anterior, bytes);
+    if (contando_aqui()) {
+        //Si no se mueve no hay reserva nueva; si se mueve o es un malloc/free disfrazado, si
+        if (anterior != NULL && (puntero != anterior || bytes == 0)) {
+            anotar_liberacion();
+        }
+        if (puntero != NULL && puntero != anterior) {
+            anotar_asignacion(bytes);
+        }
+    }
+    return puntero;
+}
+
+void *memalign(size_t alineacion, size_t bytes) {
+    void *puntero = __libc_memalign(alineacion, bytes);
+    if (puntero != NULL && contando_aqui()) {
+        anotar_asignacion(bytes);
+    }
+    return puntero;
+}
+
+void *aligned_alloc(size_t alineacion, size_t bytes) {
+    return memalign(alineacion, bytes);
+}
+
+int posix_memalign(void **resultado, size_t alineacion, size_t bytes) {
+    if (alineacion % sizeof(void *) != 0 || (alineacion & (alineacion - 1)) != 0) {
+        return EINVAL;
+    }
+    void *puntero = memalign(alineacion, bytes);
+    if (puntero == NULL) {
+        return ENOMEM;
+    }
+    *resultado = puntero;
+    return 0;
+}
+
+void free(void *puntero) {
+    if (puntero != NULL && contando_aqui()) {
+        anotar_liberacion();
+    }
+    __libc_free(puntero);
+}
+
+#elif defined(__APPLE__)
+
+//Gancho de libmalloc que usa MallocStackLogging: recibe cada reserva y liberacion de todas las
+//zonas. Los tipos son los de stack_logging.h
+typedef void (malloc_logger_t)(uint32_t tipo, uintptr_t arg1, uintptr_t arg2, uintptr_t arg3, uintptr_t resultado, uint32_t marcosOmitidos);
+extern malloc_logger_t *malloc_logger;
+
+#define TIPO_ASIGNACION 2
+#define TIPO_LIBERACION 4
+#define TIPO_VM 16
+
+static void registrar(uint32_t tipo, uintptr_t arg1, uintptr_t arg2, uintptr_t arg3, uintptr_t resultado, uint32_t marcosOmitidos) {
+    if (!contando_aqui() || (tipo & TIPO_VM)) {
+        return;
+    }
+    if ((tipo & TIPO_ASIGNACION) && (tipo & TIPO_LIBERACION)) {
+        //realloc: arg2 es el puntero anterior y arg3 el tamaño nuevo
+        if (arg2 != 0 && resultado != arg2) {
+            anotar_liberacion();
+        }
+        if (resultado != 0 && resultado != arg2) {
+            anotar_asignacion(arg3);
+        }
+    } else if (tipo & TIPO_ASIGNACION) {
+        if (resultado != 0) {
+            anotar_asignacion(arg2);
+        }
+    } else if (tipo & TIPO_LIBERACION) {
+        if (arg2 != 0) {
+            anotar_liberacion();
+        }
+    }
+}
+
+static void instalar_reservas(void) {
+    if (malloc_logger == NULL) {
+        malloc_logger = registrar;
+    }
+}
+
+int contador_disponible(void) {
+    return 1;
+}
+
+#else
+
+static void instalar_reservas(void) {
+}
+
+int contador_disponible(void) {
+    return 0;
+}
+
+#endif
+
+// MARK: - Contador
+
+void contador_iniciar(void) {
+    instalar_reservas();
+    instalar_retenciones();
+    contando = 0;
+    contador = (contador_asignaciones_t){0, 0, 0, 0, 0};
+    vivos = 0;
+    hiloContando = pthread_self();
+    contando = 1;
+}
+
+contador_asignaciones_t contador_terminar(void) {
+    contando = 0;
+    return contador;
+}
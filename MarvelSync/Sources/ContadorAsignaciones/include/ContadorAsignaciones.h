@@ -0,0 +1,42 @@
+//
+//  ContadorAsignaciones.h
+//  MarvelSync
+//
+//  Created by Borja Gil Herrero on 19/10/2026.
+//  Copyright © 2026 Alsis GHE. All rights reserved.
+//
+//  Cuenta las reservas de memoria y las retenciones de Swift que hace el hilo actual entre
+//  contador_iniciar() y contador_terminar(). En Linux (glibc) sustituye malloc y compañia por
+//  versiones que cuentan y llaman a las de glibc; en macOS se engancha a malloc_logger. Las
+//  retenciones se cuentan con el gancho _swift_retain del runtime de Swift si existe.
+//  Solo debe enlazarse en herramientas de medida, nunca en la app.
+//
+
+#ifndef ContadorAsignaciones_h
+#define ContadorAsignaciones_h
+
+#include <stdint.h>
+
+typedef struct {
+    //Reservas (malloc, calloc, realloc que mueve, memalign...) y liberaciones
+    uint64_t asignaciones;
+    uint64_t liberaciones;
+    //Bytes pedidos en las reservas
+    uint64_t bytes;
+    //Maximo de reservas vivas a la vez desde contador_iniciar()
+    int64_t picoVivos;
+    //Llamadas a swift_retain
+    uint64_t retenciones;
+} contador_asignaciones_t;
+
+//1 si en esta plataforma se pueden contar las reservas
+int contador_disponible(void);
+//1 si el runtime de Swift expone el gancho de retenciones
+int contador_retenciones_disponible(void);
+
+//Pone el contador a cero y empieza a contar en el hilo que llama
+void contador_iniciar(void);
+//Deja de contar y devuelve lo contado
+contador_asignaciones_t contador_terminar(void);
+
+#endif
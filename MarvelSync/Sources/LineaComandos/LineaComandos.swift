@@ -0,0 +1,40 @@
+//
+//  LineaComandos.swift
+//  LineaComandos
+//
+//  Created by Borja Gil Herrero on 19/10/2026.
+//  Copyright © 2026 Alsis GHE. All rights reserved.
+//
+//  Lectura de argumentos y salida con error comunes a los ejecutables del paquete.
+//
+
+#if os(Linux)
+import Glibc
+#else
+import Darwin
+#endif
+import Foundation
+
+//Valor que sigue a la opcion indicada, por ejemplo argumento("--puerto") con "--puerto 8080"
+public func argumento(_ nombre: String) -> String? {
+    return argumentos(nombre, cantidad: 1)?.first
+}
+
+//Los valores que siguen a la opcion; nil si no esta o le faltan valores
+public func argumentos(_ nombre: String, cantidad: Int) -> [String]? {
+    let argumentos = CommandLine.arguments
+    guard let posicion = argumentos.firstIndex(of: nombre), posicion + cantidad < argumentos.count else {
+        return nil
+    }
+    return Array(argumentos[(posicion + 1)...(posicion + cantidad)])
+}
+
+//Opcion sin valor, como --json
+public func opcion(_ nombre: String) -> Bool {
+    return CommandLine.arguments.contains(nombre)
+}
+
+public func salirConError(_ mensaje: String) -> Never {
+    FileHandle.standardError.write((mensaje + "\n").data(using: .utf8)!)
+    exit(1)
+}
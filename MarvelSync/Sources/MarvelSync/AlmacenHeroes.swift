@@ -0,0 +1,71 @@
+//
+//  AlmacenHeroes.swift
+//  MarvelSync
+//
+//  Created by Borja Gil Herrero on 19/10/2026.
+//  Copyright © 2026 Alsis GHE. All rights reserved.
+//
+
+import Foundation
+
+//Donde acaba la sincronizacion. La app guarda en Core Data; el banco de pruebas y las
+//herramientas de linea de comandos pueden usar el almacen en memoria o uno propio
+public protocol AlmacenHeroes: AnyObject {
+    //Fechas de modificacion guardadas de los ids indicados que ya existen
+    func modificaciones(ids: [Int32]) -> [Int32: Date]
+    //Aplica las altas y cambios de una pagina
+    func aplicar(_ plan: PlanIngesta) throws
+    //Fecha del personaje modificado mas recientemente, para sincronizar solo lo nuevo
+    func ultimaModificacion() -> Date?
+}
+
+//Almacen en memoria, sin persistencia
+public final class AlmacenMemoria: AlmacenHeroes {
+
+    private let cerrojo = NSLock()
+    private var heroes = [Int32: RegistroHeroe]()
+
+    public init() {
+    }
+
+    public var numeroHeroes: Int {
+        cerrojo.lock()
+        defer { cerrojo.unlock() }
+        return heroes.count
+    }
+
+    public func heroe(id: Int32) -> RegistroHeroe? {
+        cerrojo.lock()
+        defer { cerrojo.unlock() }
+        return heroes[id]
+    }
+
+    public func modificaciones(ids: [Int32]) -> [Int32: Date] {
+        cerrojo.lock()
+        defer { cerrojo.unlock() }
+        var resultado = [Int32: Date]()
+        for id in ids {
+            if let heroe = heroes[id] {
+                resultado[id] = heroe.modificado ?? Date.distantPast
+            }
+        }
+        return resultado
+    }
+
+    public func aplicar(_ plan: PlanIngesta) throws {
+        cerrojo.lock()
+        defer { cerrojo.unlock() }
+        for registro in plan.altas {
+            heroes[registro.id] = registro
+        }
+        for registro in plan.cambios {
+            heroes[registro.id] = registro
+        }
+    }
+
+    public func ultimaModificacion() -> Date? {
+        cerrojo.lock()
+        defer { cerrojo.unlock() }
+        return heroes.values.compactMap { $0.modificado }.max()
+    }
+}
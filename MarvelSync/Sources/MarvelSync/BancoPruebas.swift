@@ -0,0 +1,153 @@
+//
+//  BancoPruebas.swift
+//  MarvelSync
+//
+//  Created by Borja Gil Herrero on 19/10/2026.
+//  Copyright © 2026 Alsis GHE. All rights reserved.
+//
+
+import Foundation
+
+//Resultado de un micro-benchmark. Los tiempos son por iteracion, en nanosegundos
+public struct ResultadoBanco: Codable {
+    public var nombre: String
+    //Que se cuenta en cada iteracion: filas, firmas, imagenes...
+    public var unidad: String
+    public var elementosPorIteracion: Int
+    public var iteraciones: Int
+    public var medianaNs: Double
+    public var p90Ns: Double
+    public var minimoNs: Double
+
+    //Elementos por segundo a partir de la mediana
+    public var porSegundo: Double {
+        return medianaNs > 0 ? Double(elementosPorIteracion) * 1e9 / medianaNs : 0
+    }
+}
+
+//Fichero de resultados, el mismo formato para los resultados y para la linea base
+public struct InformeBanco: Codable {
+    public var suite: String
+    public var fecha: String
+    public var plataforma: String
+    public var resultados: [ResultadoBanco]
+}
+
+//Arnes minimo de micro-benchmarks: calienta, repite el bloque hasta cubrir un tiempo minimo y
+//se queda con mediana, p90 y minimo. Lo usan marvel-microbench y el banco de pruebas de la app,
+//asi los dos producen el mismo JSON y se comparan con la misma linea base
+public final class BancoPruebas {
+
+    public let suite: String
+    public var tiempoMinimo: TimeInterval = 1
+    public var iteracionesMinimas = 5
+    public var calentamiento = 2
+    //Si no es nil solo se ejecutan los benchmarks cuyo nombre contiene este texto
+    public var filtro: String?
+    public private(set) var resultados = [ResultadoBanco]()
+
+    public init(suite: String) {
+        self.suite = suite
+    }
+
+    //Mide el bloque. preparar se ejecuta antes de cada iteracion y no cuenta en el tiempo
+    public func medir(_ nombre: String, unidad: String, elementos: Int = 1, preparar: () throws -> Void = {}, _ bloque: () throws -> Void) rethrows {
+        if let filtro = filtro, !nombre.contains(filtro) {
+            return
+        }
+        for _ in 0..<calentamiento {
+            try preparar()
+            try bloque()
+        }
+        var muestras = [Double]()
+        let limite = DispatchTime.now().uptimeNanoseconds + UInt64(tiempoMinimo * 1e9)
+        repeat {
+            try preparar()
+            let inicio = DispatchTime.now().uptimeNanoseconds
+            try bloque()
+            muestras.append(Double(DispatchTime.now().uptimeNanoseconds - inicio))
+        } while muestras.count < iteracionesMinimas || DispatchTime.now().uptimeNanoseconds < limite
+
+        muestras.sort()
+        resultados.append(ResultadoBanco(nombre: nombre, unidad: unidad, elementosPorIteracion: elementos, iteraciones: muestras.count,
+                                         medianaNs: muestras[muestras.count / 2], p90Ns: muestras[min(muestras.count - 1, muestras.count * 9 / 10)],
+                                         minimoNs: muestras[0]))
+    }
+
+    public func informe(plataforma: String) -> InformeBanco {
+        let formato = DateFormatter()
+        formato.locale = Locale(identifier: "en_US_POSIX")
+        formato.dateFormat = "yyyy-MM-dd'T'HH:mm:ssZ"
+        return InformeBanco(suite: suite, fecha: formato.string(from: Date()), plataforma: plataforma, resultados: resultados)
+    }
+
+    // MARK: - Salida
+
+    public static func json(_ informe: InformeBanco) throws -> Data {
+        let encoder = JSONEncoder()
+        encoder.outputFormatting = .prettyPrinted
+        return try encoder.encode(informe)
+    }
+
+    public static func cargar(_ url: URL) throws -> InformeBanco {
+        return try JSONDecoder().decode(InformeBanco.self, from: Data(contentsOf: url))
+    }
+
+    //Tabla legible; con linea base añade la variacion de la mediana de cada benchmark
+    public static func tabla(_ informe: InformeBanco, baseline: InformeBanco? = nil) -> String {
+        var referencia = [String: ResultadoBanco]()
+        for resultado in baseline?.resultados ?? [] {
+            referencia[resultado.nombre] = resultado
+        }
+        var lineas = [String]()
+        for resultado in informe.resultados {
+            let nombre = resultado.nombre.padding(toLength: 36, withPad: " ", startingAt: 0)
+            //Sin %@: con String no funciona en Linux
+            var linea = nombre + String(format: "%14.0f ", resultado.porSegundo) + "\(resultado.unidad)/s"
+            linea += String(format: "   mediana %10.3f ms   p90 %10.3f ms", resultado.medianaNs / 1e6, resultado.p90Ns / 1e6)
+            if let anterior = referencia[resultado.nombre] {
+                linea += anterior.medianaNs > 0 ? String(format: "   %+6.1f%%", variacion(resultado, respectoA: anterior) * 100) : "   sin medir"
+            }
+            lineas.append(linea)
+        }
+        return lineas.joined(separator: "\n")
+    }
+
+    //Benchmarks cuya mediana ha empeorado mas que la tolerancia (0.1 = 10%) respecto a la linea base
+    public static func regresiones(_ informe: InformeBanco, baseline: InformeBanco, tolerancia: Double) -> [String] {
+        var referencia = [String: ResultadoBanco]()
+        for resultado in baseline.resultados {
+            referencia[resultado.nombre] = resultado
+        }
+        return informe.resultados.compactMap { resultado in
+            guard let anterior = referencia[resultado.nombre] else {
+                return nil
+            }
+            return variacion(resultado, respectoA: anterior) > tolerancia ? resultado.nombre : nil
+        }
+    }
+
+    //Benchmarks de la linea base que aun no tienen medida (mediana 0): no se comparan
+    public static func sinMedir(_ baseline: InformeBanco) -> [String] {
+        return baseline.resultados.filter { $0.medianaNs <= 0 }.map { $0.nombre }
+    }
+
+    //Positivo si ahora tarda mas
+    private static func variacion(_ resultado: ResultadoBanco, respectoA anterior: ResultadoBanco) -> Double {
+        guard anterior.medianaNs > 0 else {
+            return 0
+        }
+        let actual = resultado.medianaNs / Double(max(1, resultado.elementosPorIteracion))
+        let base = anterior.medianaNs / Double(max(1, anterior.elementosPorIteracion))
+        return actual / base - 1
+    }
+}
+
+//Evita que el optimizador elimine un calculo cuyo resultado no se usa
+@inline(never)
+public func consumir<T>(_ valor: T) {
+    sumideroBanco = sumideroBanco &+ 1
+    withExtendedLifetime(valor) {}
+}
+
+private var sumideroBanco = 0
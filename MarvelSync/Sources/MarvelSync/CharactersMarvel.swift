@@ -0,0 +1,112 @@
+//
+//  CharactersMarvel.swift
+//  MarvelSync
+//
+//  Created by Borja Gil Herrero on 03/12/2018.
+//  Copyright © 2018 Alsis GHE. All rights reserved.
+//
+
+import Foundation
+
+public class RespuestaAPI: NSObject, Codable{
+    public var code: Int = 0
+    public var status: String = ""
+    public var copyright: String = ""
+    public var attributionText: String = ""
+    public var attributionHTML: String = ""
+    public var etag: String = ""
+    public var data: DataAPI = DataAPI()
+}
+public class DataAPI: NSObject, Codable{
+    public var offset: Int = 0
+    public var limit: Int = 0
+    public var total: Int = 0
+    public var count: Int = 0
+    public var results: [CharacterAPI]	 = [CharacterAPI]()
+}
+
+public class CharacterAPI: NSObject, Codable {
+    enum CodingKeys: String, CodingKey {
+        case id
+        case name
+        case descriptionString = "description"
+        case modified
+        case thumbnail
+        case resourceURI
+        case comics
+        case series
+        case stories
+        case events
+        case urls
+    }
+    public var id: Int32 = 0
+    public var name: String = ""
+    public var descriptionString: String = ""
+    public var modified: String = ""
+    public var thumbnail: ImagenCharacterAPI = ImagenCharacterAPI()
+    public var resourceURI: String = ""
+    public var comics: ComicsAPI = ComicsAPI()
+    public var series: SeriesAPI = SeriesAPI()
+    public var stories: StoriesAPI = StoriesAPI()
+    public var events: EventsAPI = EventsAPI()
+    public var urls: [UrlAPI] = [UrlAPI]()
+}
+
+public class ImagenCharacterAPI:NSObject, Codable{
+    enum CodingKeys: String, CodingKey {
+        case path
+        case extensionString = "extension"
+    }
+    public var path: String = ""
+    public var extensionString: String = ""
+}
+
+public class ComicsAPI: NSObject, Codable{
+    public var available: Int = 0
+    public var collectionURI: String = ""
+    public var items: [ComicAPI] = [ComicAPI]()
+    public var returned : Int = 0
+}
+public class SeriesAPI: NSObject, Codable{
+    public var available: Int = 0
+    public var collectionURI: String = ""
+    public var items: [SerieAPI] = [SerieAPI]()
+    public var returned: Int = 0
+}
+public class StoriesAPI: NSObject, Codable{
+    public var available: Int = 0
+    public var collectionURI: String = ""
+    public var items: [StorieAPI] = [StorieAPI]()
+    public var returned: Int = 0
+}
+public class EventsAPI: NSObject, Codable{
+    public var available: Int = 0
+    public var collectionURI: String = ""
+    public var items: [EventAPI] = [EventAPI]()
+    public var returned: Int = 0
+}
+
+public class ComicAPI: NSObject, Codable{
+    public var resourceURI: String = ""
+    public var name: String = ""
+}
+
+public class SerieAPI: NSObject, Codable{
+    public var resourceURI: String = ""
+    public var name: String = ""
+}
+
+public class StorieAPI: NSObject, Codable{
+    public var resourceURI: String = ""
+    public var name: String = ""
+    public var type: String = ""
+}
+public class EventAPI: NSObject, Codable{
+    public var resourceURI: String = ""
+    public var name: String = ""
+}
+public class UrlAPI: NSObject, Codable{
+    public var type: String = ""
+    public var url: String = ""
+}
+
@@ -0,0 +1,44 @@
+//
+//  DecodificadorPagina.swift
+//  MarvelSync
+//
+//  Created by Borja Gil Herrero on 19/10/2026.
+//  Copyright © 2026 Alsis GHE. All rights reserved.
+//
+
+import Foundation
+
+//Motivos por los que una pagina no se puede usar. Una pagina vacia no es un error: es el final
+public enum ErrorPagina: Error {
+    //Respuesta sin cuerpo
+    case sinDatos
+    //El cuerpo no es un RespuestaAPI valido (por ejemplo, truncado)
+    case formato(Error)
+    //La API ha devuelto un codigo distinto de 200 dentro del sobre
+    case codigo(Int)
+}
+
+//Decodifica el cuerpo de una pagina de personajes directamente desde Data
+public final class DecodificadorPagina {
+
+    private let decoder = JSONDecoder()
+
+    public init() {
+    }
+
+    public func decodificar(_ datos: Data?) throws -> DataAPI {
+        guard let datos = datos, !datos.isEmpty else {
+            throw ErrorPagina.sinDatos
+        }
+        let respuesta: RespuestaAPI
+        do {
+            respuesta = try decoder.decode(RespuestaAPI.self, from: datos)
+        } catch {
+            throw ErrorPagina.formato(error)
+        }
+        guard respuesta.code == 200 else {
+            throw ErrorPagina.codigo(respuesta.code)
+        }
+        return respuesta.data
+    }
+}
@@ -0,0 +1,143 @@
+//
+//  FirmaMarvel.swift
+//  MarvelSync
+//
+//  Created by Borja Gil Herrero on 19/10/2026.
+//  Copyright © 2026 Alsis GHE. All rights reserved.
+//
+
+import Foundation
+
+//Parametros de autenticacion de la API de Marvel: ts, apikey y hash = md5(ts + privada + publica).
+//El md5 va implementado aqui para no depender de CommonCrypto y poder compilar en Linux.
+public struct FirmaMarvel {
+
+    public let clavePublica: String
+    public let clavePrivada: String
+
+    public init(clavePublica: String, clavePrivada: String) {
+        self.clavePublica = clavePublica
+        self.clavePrivada = clavePrivada
+    }
+
+    //Marca de tiempo que acompaña a cada peticion
+    public static func marcaTiempo() -> String {
+        return Date().timeIntervalSince1970.description
+    }
+
+    public func hash(ts: String) -> String {
+        return MD5.hex(ts + clavePrivada + clavePublica)
+    }
+
+    //ts, apikey y hash en el orden en que los pone la app
+    public func parametros(ts: String = FirmaMarvel.marcaTiempo()) -> [(String, String)] {
+        return [("ts", ts), ("apikey", clavePublica), ("hash", hash(ts: ts))]
+    }
+}
+
+//MD5 (RFC 1321) sobre bytes. Solo se usa para la firma, no como proteccion criptografica
+public enum MD5 {
+
+    private static let desplazamientos: [UInt32] = [
+        7, 12, 17, 22, 7, 12, 17, 22, 7, 12, 17, 22, 7, 12, 17, 22,
+        5, 9, 14, 20, 5, 9, 14, 20, 5, 9, 14, 20, 5, 9, 14, 20,
+        4, 11, 16, 23, 4, 11, 16, 23, 4, 11, 16, 23, 4, 11, 16, 23,
+        6, 10, 15, 21, 6, 10, 15, 21, 6, 10, 15, 21, 6, 10, 15, 21,
+    ]
+
+    //floor(abs(sin(i + 1)) * 2^32)
+    private static let constantes: [UInt32] = [
+        0xd76aa478, 0xe8c7b756, 0x242070db, 0xc1bdceee,
+        0xf57c0faf, 0x4787c62a, 0xa8304613, 0xfd469501,
+        0x698098d8, 0x8b44f7af, 0xffff5bb1, 0x895cd7be,
+        0x6b901122, 0xfd987193, 0xa679438e, 0x49b40821,
+        0xf61e2562, 0xc040b340, 0x265e5a51, 0xe9b6c7aa,
+        0xd62f105d, 0x02441453, 0xd8a1e681, 0xe7d3fbc8,
+        0x21e1cde6, 0xc33707d6, 0xf4d50d87, 0x455a14ed,
+        0xa9e3e905, 0xfcefa3f8, 0x676f02d9, 0x8d2a4c8a,
+        0xfffa3942, 0x8771f681, 0x6d9d6122, 0xfde5380c,
+        0xa4beea44, 0x4bdecfa9, 0xf6bb4b60, 0xbebfbc70,
+        0x289b7ec6, 0xeaa127fa, 0xd4ef3085, 0x04881d05,
+        0xd9d4d039, 0xe6db99e5, 0x1fa27cf8, 0xc4ac5665,
+        0xf4292244, 0x432aff97, 0xab9423a7, 0xfc93a039,
+        0x655b59c3, 0x8f0ccc92, 0xffeff47d, 0x85845dd1,
+        0x6fa87e4f, 0xfe2ce6e0, 0xa3014314, 0x4e0811a1,
+        0xf7537e82, 0xbd3af235, 0x2ad7d2bb, 0xeb86d391,
+    ]
+
+    //Resumen en hexadecimal en minusculas, como el de CC_MD5 que usaba la app
+    public static func hex(_ texto: String) -> String {
+        let digitos = Array("0123456789abcdef".utf8)
+        var salida = [UInt8]()
+        salida.reserveCapacity(32)
+        for byte in resumen(Array(texto.utf8)) {
+            salida.append(digitos[Int(byte >> 4)])
+            salida.append(digitos[Int(byte & 0x0f)])
+        }
+        return String(decoding: salida, as: UTF8.self)
+    }
+
+    public static func resumen(_ mensaje: [UInt8]) -> [UInt8] {
+        //Relleno: un 1, ceros hasta 56 mod 64 y la longitud en bits en little endian
+        var bytes = mensaje
+        let bits = UInt64(mensaje.count) &* 8
+        bytes.append(0x80)
+        while bytes.count % 64 != 56 {
+            bytes.append(0)
+        }
+        for desplazamiento in stride(from: 0, to: 64, by: 8) {
+            bytes.append(UInt8(truncatingIfNeeded: bits >> UInt64(desplazamiento)))
+        }
+
+        var a0: UInt32 = 0x67452301
+        var b0: UInt32 = 0xefcdab89
+        var c0: UInt32 = 0x98badcfe
+        var d0: UInt32 = 0x10325476
+        var bloque = [UInt32](repeating: 0, count: 16)
+
+        for inicio in stride(from: 0, to: bytes.count, by: 64) {
+            for i in 0..<16 {
+                let j = inicio + i * 4
+                bloque[i] = UInt32(bytes[j]) | UInt32(bytes[j + 1]) << 8 | UInt32(bytes[j + 2]) << 16 | UInt32(bytes[j + 3]) << 24
+            }
+
+            var a = a0, b = b0, c = c0, d = d0
+            for i in 0..<64 {
+                var f: UInt32
+                let g: Int
+                switch i {
+                case 0..<16:
+                    f = (b & c) | (~b & d)
+                    g = i
+                case 16..<32:
+                    f = (d & b) | (~d & c)
+                    g = (5 &* i &+ 1) % 16
+                case 32..<48:
+                    f = b ^ c ^ d
+                    g = (3 &* i &+ 5) % 16
+                default:
+                    f = c ^ (b | ~d)
+                    g = (7 &* i) % 16
+                }
+                f = f &+ a &+ constantes[i] &+ bloque[g]
+                a = d
+                d = c
+                c = b
+                b = b &+ ((f << desplazamientos[i]) | (f >> (32 - desplazamientos[i])))
+            }
+            a0 = a0 &+ a
+            b0 = b0 &+ b
+            c0 = c0 &+ c
+            d0 = d0 &+ d
+        }
+
+        var salida = [UInt8]()
+        salida.reserveCapacity(16)
+        for palabra in [a0, b0, c0, d0] {
+            for desplazamiento in stride(from: UInt32(0), to: 32, by: 8) {
+                salida.append(UInt8(truncatingIfNeeded: palabra >> desplazamiento))
+            }
+        }
+        return salida
+    }
+}
@@ -0,0 +1,118 @@
+//
+//  MotorSincronizacion.swift
+//  MarvelSync
+//
+//  Created by Borja Gil Herrero on 19/10/2026.
+//  Copyright © 2026 Alsis GHE. All rights reserved.
+//
+
+import Foundation
+#if canImport(FoundationNetworking)
+import FoundationNetworking
+#endif
+
+//Transporte sincrono de una peticion HTTP. La app tiene el suyo con reintentos y cuota
+public protocol TransporteHTTP {
+    func enviar(_ peticion: URLRequest) throws -> (Data?, HTTPURLResponse)
+}
+
+//Transporte minimo sobre URLSession, sin reintentos
+public final class TransporteURLSession: TransporteHTTP {
+
+    public enum ErrorURLSession: Error {
+        case sinRespuesta(Error?)
+    }
+
+    private let session: URLSession
+
+    public init(session: URLSession = URLSession(configuration: .ephemeral)) {
+        self.session = session
+    }
+
+    public func enviar(_ peticion: URLRequest) throws -> (Data?, HTTPURLResponse) {
+        let terminado = DispatchSemaphore(value: 0)
+        var resultado: (Data?, URLResponse?, Error?) = (nil, nil, nil)
+        session.dataTask(with: peticion) { data, response, error in
+            resultado = (data, response, error)
+            terminado.signal()
+        }.resume()
+        terminado.wait()
+        guard let http = resultado.1 as? HTTPURLResponse else {
+            throw ErrorURLSession.sinRespuesta(resultado.2)
+        }
+        return (resultado.0, http)
+    }
+}
+
+//Cifras de una sincronizacion
+public struct EstadisticasSincronizacion {
+    public var paginas = 0
+    //Personajes recibidos, y de ellos los que se han guardado por ser nuevos o haber cambiado
+    public var filas = 0
+    public var filasGuardadas = 0
+    public var bytes = 0
+    public var duracion: TimeInterval = 0
+
+    public init() {
+    }
+
+    public var paginasPorSegundo: Double {
+        return duracion > 0 ? Double(paginas) / duracion : 0
+    }
+
+    public var filasPorSegundo: Double {
+        return duracion > 0 ? Double(filas) / duracion : 0
+    }
+}
+
+//Sincronizacion completa sin interfaz: pagina a pagina descarga, decodifica, planifica y guarda
+//en el almacen. Es el mismo recorrido que hace la app, sin UIKit ni Core Data
+public final class MotorSincronizacion {
+
+    public enum ErrorSincronizacion: Error {
+        //Respuesta HTTP distinta de 200 en la pagina que empieza en offset
+        case http(Int, offset: Int)
+    }
+
+    public var paginador: PaginadorPersonajes
+    public let transporte: TransporteHTTP
+    public let almacen: AlmacenHeroes
+    private let decodificador = DecodificadorPagina()
+
+    public init(paginador: PaginadorPersonajes, transporte: TransporteHTTP, almacen: AlmacenHeroes) {
+        self.paginador = paginador
+        self.transporte = transporte
+        self.almacen = almacen
+    }
+
+    //Recorre todas las paginas desde el offset indicado. Si incremental es true solo pide lo
+    //modificado despues de lo mas reciente que ya tiene el almacen
+    public func sincronizar(desdeOffset offsetInicial: Int = 0, incremental: Bool = false) throws -> EstadisticasSincronizacion {
+        if incremental {
+            paginador.modificadoDesde = almacen.ultimaModificacion()
+        }
+        var estadisticas = EstadisticasSincronizacion()
+        let inicio = Date()
+
+        var offset: Int? = offsetInicial
+        while let actual = offset {
+            var peticion = URLRequest(url: paginador.url(offset: actual))
+            peticion.cachePolicy = .reloadIgnoringLocalCacheData
+            let (datos, respuesta) = try transporte.enviar(peticion)
+            guard respuesta.statusCode == 200 else {
+                throw ErrorSincronizacion.http(respuesta.statusCode, offset: actual)
+            }
+            let pagina = try decodificador.decodificar(datos)
+            let plan = PlanIngesta(personajes: pagina.results, existentes: almacen.modificaciones(ids: pagina.results.map { $0.id }))
+            try almacen.aplicar(plan)
+
+            estadisticas.paginas += 1
+            estadisticas.filas += pagina.results.count
+            estadisticas.filasGuardadas += plan.total
+            estadisticas.bytes += datos?.count ?? 0
+            offset = paginador.siguienteOffset(tras: pagina)
+        }
+        estadisticas.duracion = Date().timeIntervalSince(inicio)
+        return estadisticas
+    }
+}
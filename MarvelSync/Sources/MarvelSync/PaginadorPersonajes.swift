@@ -0,0 +1,81 @@
+//
+//  PaginadorPersonajes.swift
+//  MarvelSync
+//
+//  Created by Borja Gil Herrero on 19/10/2026.
+//  Copyright © 2026 Alsis GHE. All rights reserved.
+//
+
+import Foundation
+
+//Recorre el listado de personajes por paginas: construye la url firmada de cada una y decide
+//cual es la siguiente a partir de la respuesta. Ordena por fecha de modificacion para que una
+//sincronizacion interrumpida pueda seguir desde el ultimo personaje guardado.
+public struct PaginadorPersonajes {
+
+    public static let urlProduccion = URL(string: "https://gateway.marvel.com")!
+    public static let rutaPersonajes = "/v1/public/characters"
+
+    //Formato de fecha de la API de Marvel, por ejemplo 2014-04-29T14:18:17-0400
+    public static let formatoFecha: DateFormatter = {
+        let formato = DateFormatter()
+        formato.locale = Locale(identifier: "en_US_POSIX")
+        formato.dateFormat = "yyyy-MM-dd'T'HH:mm:ssZ"
+        return formato
+    }()
+
+    //Caracteres que no hay que escapar en el valor de un parametro (el "+" de la zona horaria si)
+    public static let caracteresParametro: CharacterSet = CharacterSet.urlQueryAllowed.subtracting(CharacterSet(charactersIn: "+&="))
+
+    public var urlBase: URL
+    public var limite: Int
+    public var modificadoDesde: Date?
+    public var firma: FirmaMarvel
+
+    public init(firma: FirmaMarvel, urlBase: URL = PaginadorPersonajes.urlProduccion, limite: Int = 25, modificadoDesde: Date? = nil) {
+        self.firma = firma
+        self.urlBase = urlBase
+        self.limite = limite
+        self.modificadoDesde = modificadoDesde
+    }
+
+    //Url firmada de la pagina que empieza en offset
+    public func url(offset: Int, ts: String = FirmaMarvel.marcaTiempo()) -> URL {
+        var parametros: [String: String] = ["orderBy": "modified"]
+        if let desde = modificadoDesde {
+            parametros["modifiedSince"] = PaginadorPersonajes.formatoFecha.string(from: desde)
+        }
+        return PaginadorPersonajes.url(urlBase.absoluteString + PaginadorPersonajes.rutaPersonajes, firma: firma, ts: ts,
+                                       limit: String(limite), offset: String(offset), parametros: parametros)
+    }
+
+    //Url firmada de cualquier listado de la API: autenticacion, limit y offset y el resto de
+    //parametros ordenados por nombre
+    public static func url(_ endpoint: String, firma: FirmaMarvel, ts: String = FirmaMarvel.marcaTiempo(),
+                           limit: String, offset: String, parametros: [String: String] = [:]) -> URL {
+        var urlFinal = endpoint
+        var separador = "?"
+        for (clave, valor) in firma.parametros(ts: ts) + [("limit", limit), ("offset", offset)] {
+            urlFinal += separador + clave + "=" + valor
+            separador = "&"
+        }
+        for (clave, valor) in parametros.sorted(by: { $0.key < $1.key }) {
+            urlFinal += separador + clave + "=" + (valor.addingPercentEncoding(withAllowedCharacters: caracteresParametro) ?? valor)
+            separador = "&"
+        }
+        return URL(string: urlFinal)!
+    }
+
+    //Offset de la siguiente pagina o nil si esta era la ultima. Se mira tambien el total para no
+    //gastar una llamada mas en pedir una pagina vacia
+    public func siguienteOffset(tras pagina: DataAPI) -> Int? {
+        if pagina.results.isEmpty {
+            return nil
+        }
+        let siguiente = pagina.offset + pagina.results.count
+        if pagina.total > 0 && siguiente >= pagina.total {
+            return nil
+        }
+        return siguiente
+    }
+}
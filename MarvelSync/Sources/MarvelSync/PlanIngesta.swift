@@ -0,0 +1,76 @@
+//
+//  PlanIngesta.swift
+//  MarvelSync
+//
+//  Created by Borja Gil Herrero on 19/10/2026.
+//  Copyright © 2026 Alsis GHE. All rights reserved.
+//
+
+import Foundation
+
+//Lo que se guarda de cada personaje, independiente del almacen
+public struct RegistroHeroe {
+    public var id: Int32
+    public var nombre: String
+    public var descripcion: String
+    //Url de la imagen completa, nil si el personaje no tiene
+    public var urlImagen: String?
+    public var modificado: Date?
+
+    public init(id: Int32, nombre: String, descripcion: String, urlImagen: String?, modificado: Date?) {
+        self.id = id
+        self.nombre = nombre
+        self.descripcion = descripcion
+        self.urlImagen = urlImagen
+        self.modificado = modificado
+    }
+
+    public init(personaje: CharacterAPI) {
+        let imagen = personaje.thumbnail
+        self.init(id: personaje.id, nombre: personaje.name, descripcion: personaje.descriptionString,
+                  urlImagen: imagen.path.isEmpty ? nil : imagen.path + "." + imagen.extensionString,
+                  modificado: PaginadorPersonajes.formatoFecha.date(from: personaje.modified))
+    }
+}
+
+//Reparte una pagina en altas y cambios a partir de las fechas de modificacion que ya tiene el
+//almacen. Los personajes que no han cambiado desde la ultima vez se descartan, asi no se vuelven
+//a descargar sus imagenes ni a guardar; si un id se repite en la pagina gana la ultima aparicion.
+public struct PlanIngesta {
+
+    public var altas = [RegistroHeroe]()
+    public var cambios = [RegistroHeroe]()
+    public var sinCambios = 0
+
+    public var total: Int {
+        return altas.count + cambios.count
+    }
+
+    //existentes: id -> fecha de modificacion guardada (distantPast si no se conoce)
+    public init(personajes: [CharacterAPI], existentes: [Int32: Date]) {
+        var vistos = [Int32: Int]()
+        var registros = [RegistroHeroe]()
+        registros.reserveCapacity(personajes.count)
+        for personaje in personajes {
+            let registro = RegistroHeroe(personaje: personaje)
+            if let posicion = vistos[registro.id] {
+                registros[posicion] = registro
+            } else {
+                vistos[registro.id] = registros.count
+                registros.append(registro)
+            }
+        }
+
+        for registro in registros {
+            guard let guardado = existentes[registro.id] else {
+                altas.append(registro)
+                continue
+            }
+            if let modificado = registro.modificado, modificado <= guardado {
+                sinCambios += 1
+            } else {
+                cambios.append(registro)
+            }
+        }
+    }
+}
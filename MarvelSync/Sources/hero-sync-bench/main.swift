@@ -0,0 +1,83 @@
+//
+//  main.swift
+//  hero-sync-bench
+//
+//  Created by Borja Gil Herrero on 19/10/2026.
+//  Copyright © 2026 Alsis GHE. All rights reserved.
+//
+//  Sincronizacion completa del catalogo contra un servidor (normalmente el stub local) sobre un
+//  almacen en memoria. Muestra paginas/s, filas/s, bytes descargados y el pico de memoria.
+//
+//  Uso: hero-sync-bench [--url http://127.0.0.1:8080] [--limite 100] [--repeticiones 1]
+//                       [--apikey clave] [--privkey clave] [--json]
+//
+
+#if os(Linux)
+import Glibc
+#else
+import Darwin
+#endif
+import Foundation
+import MarvelSync
+import LineaComandos
+
+//Pico de memoria residente en bytes. ru_maxrss va en KB en Linux y en bytes en macOS
+func picoMemoria() -> Int {
+    var uso = rusage()
+    getrusage(RUSAGE_SELF, &uso)
+    #if os(Linux)
+    return Int(uso.ru_maxrss) * 1024
+    #else
+    return Int(uso.ru_maxrss)
+    #endif
+}
+
+func texto(_ bytes: Int) -> String {
+    return String(format: "%.1f MB", Double(bytes) / 1_048_576)
+}
+
+guard let urlBase = URL(string: argumento("--url") ?? "http://127.0.0.1:8080") else {
+    salirConError("Url no valida")
+}
+let limite = Int(argumento("--limite") ?? "") ?? 100
+let repeticiones = max(1, Int(argumento("--repeticiones") ?? "") ?? 1)
+let firma = FirmaMarvel(clavePublica: argumento("--apikey") ?? "bench", clavePrivada: argumento("--privkey") ?? "bench")
+let json = opcion("--json")
+
+var resultados = [[String: Any]]()
+for repeticion in 1...repeticiones {
+    //Cada repeticion empieza con el almacen vacio: es una sincronizacion completa
+    let almacen = AlmacenMemoria()
+    let motor = MotorSincronizacion(paginador: PaginadorPersonajes(firma: firma, urlBase: urlBase, limite: limite),
+                                    transporte: TransporteURLSession(), almacen: almacen)
+    do {
+        let estadisticas = try motor.sincronizar()
+        let resultado: [String: Any] = [
+            "repeticion": repeticion,
+            "paginas": estadisticas.paginas,
+            "filas": estadisticas.filas,
+            "heroes": almacen.numeroHeroes,
+            "bytes": estadisticas.bytes,
+            "segundos": estadisticas.duracion,
+            "paginasPorSegundo": estadisticas.paginasPorSegundo,
+            "filasPorSegundo": estadisticas.filasPorSegundo,
+            "picoMemoria": picoMemoria(),
+        ]
+        resultados.append(resultado)
+        if !json {
+            //%@ con String no funciona en Linux, las cadenas van interpoladas
+            let cifras = String(format: "%d paginas, %d filas en %.2f s  |  %.1f paginas/s  %.0f filas/s",
+                                estadisticas.paginas, estadisticas.filas, estadisticas.duracion,
+                                estadisticas.paginasPorSegundo, estadisticas.filasPorSegundo)
+            print("#\(repeticion)  \(cifras)  |  \(texto(estadisticas.bytes)) descargados  |  pico \(texto(picoMemoria()))")
+        }
+    } catch {
+        salirConError("Sincronizacion fallida: \(error)")
+    }
+}
+
+if json {
+    let datos = try JSONSerialization.data(withJSONObject: ["url": urlBase.absoluteString, "limite": limite, "resultados": resultados],
+                                           options: [.prettyPrinted])
+    print(String(decoding: datos, as: UTF8.self))
+}
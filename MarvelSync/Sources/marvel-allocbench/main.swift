@@ -0,0 +1,183 @@
+//
+//  main.swift
+//  marvel-allocbench
+//
+//  Created by Borja Gil Herrero on 19/10/2026.
+//  Copyright © 2026 Alsis GHE. All rights reserved.
+//
+//  Contabilidad de reservas de memoria de la ingesta, etapa por etapa, sobre las paginas
+//  grabadas en Fixtures: reservas, bytes, pico de objetos vivos y retenciones por fila ingerida.
+//  Con un presupuesto sale con error si alguna etapa lo supera. Va en un ejecutable aparte de
+//  marvel-microbench porque sustituye malloc en todo el proceso y eso falsearia los tiempos.
+//  Lo que depende de iOS (NSManagedObject, NSURL de las imagenes) no se mide aqui.
+//
+//  Uso: marvel-allocbench [--json] [--filas 1000]
+//                         [--presupuesto Benchmarks/presupuesto-asignaciones.json]
+//                         [--guardar-presupuesto Benchmarks/presupuesto-asignaciones.json [--margen 0.25]]
+//
+
+#if os(Linux)
+import Glibc
+#else
+import Darwin
+#endif
+import Foundation
+import MarvelSync
+import LineaComandos
+import ContadorAsignaciones
+
+guard contador_disponible() != 0 else {
+    salirConError("En esta plataforma no se pueden contar las reservas de memoria")
+}
+
+//Lo medido en una etapa, todo por fila ingerida
+struct MedidaEtapa: Codable {
+    var etapa: String
+    var filas: Int
+    var asignacionesPorFila: Double
+    var bytesPorFila: Double
+    var picoVivosPorFila: Double
+    var retencionesPorFila: Double
+}
+
+//Limites por etapa; una etapa sin presupuesto no se comprueba
+struct PresupuestoAsignaciones: Codable {
+    struct Limites: Codable {
+        var asignacionesPorFila: Double
+        var bytesPorFila: Double
+        var picoVivosPorFila: Double
+    }
+    var etapas: [String: Limites]
+}
+
+//Ejecuta la etapa una vez para calentar (formatos de fecha, metadatos de tipos, caches del
+//runtime) y se queda con la repeticion que menos reserva: el resto es ruido de la primera vez
+func medir(_ etapa: String, filas: Int, repeticiones: Int = 5, preparar: () -> Void = {}, _ bloque: () -> Void) -> MedidaEtapa {
+    preparar()
+    bloque()
+    var mejor: contador_asignaciones_t? = nil
+    for _ in 0..<repeticiones {
+        preparar()
+        contador_iniciar()
+        bloque()
+        let contado = contador_terminar()
+        if mejor == nil || contado.asignaciones < mejor!.asignaciones {
+            mejor = contado
+        }
+    }
+    let contado = mejor!
+    let porFila = { (valor: Double) in valor / Double(max(1, filas)) }
+    return MedidaEtapa(etapa: etapa, filas: filas,
+                       asignacionesPorFila: porFila(Double(contado.asignaciones)),
+                       bytesPorFila: porFila(Double(contado.bytes)),
+                       picoVivosPorFila: porFila(Double(contado.picoVivos)),
+                       retencionesPorFila: porFila(Double(contado.retenciones)))
+}
+
+// MARK: - Datos
+
+//Raiz del paquete a partir de este fichero: Sources/marvel-allocbench/main.swift
+let paquete = URL(fileURLWithPath: #file).deletingLastPathComponent().deletingLastPathComponent().deletingLastPathComponent()
+let filas = Int(argumento("--filas") ?? "") ?? 1000
+let urlPagina = paquete.appendingPathComponent("Fixtures/personajes-\(filas).json")
+guard let pagina = try? Data(contentsOf: urlPagina) else {
+    salirConError("No se encuentra \(urlPagina.path)")
+}
+
+let decodificador = DecodificadorPagina()
+let personajes = try! decodificador.decodificar(pagina).results
+let limitePagina = 100
+let firma = FirmaMarvel(clavePublica: "c0252ec5bc3ee9b2c6a0a26e2dfb306d", clavePrivada: "c124cdc74823164742598e641674842fa2de600c")
+let paginador = PaginadorPersonajes(firma: firma, limite: limitePagina, modificadoDesde: Date(timeIntervalSince1970: 1_500_000_000))
+
+//La mitad ya esta en el almacen, como en marvel-microbench
+var existentes = [Int32: Date]()
+for (posicion, personaje) in personajes.enumerated() where posicion % 2 == 0 {
+    let fecha = PaginadorPersonajes.formatoFecha.date(from: personaje.modified) ?? Date.distantPast
+    existentes[personaje.id] = posicion % 4 == 0 ? fecha : fecha.addingTimeInterval(-86400)
+}
+
+// MARK: - Etapas
+
+var medidas = [MedidaEtapa]()
+
+//Una peticion firmada por pagina, repartida entre las filas de la pagina
+medidas.append(medir("peticion", filas: personajes.count) {
+    for pagina in 0..<(personajes.count + limitePagina - 1) / limitePagina {
+        consumir(paginador.url(offset: pagina * limitePagina, ts: String(1_500_000_000 + pagina)))
+    }
+})
+medidas.append(medir("decodificacion", filas: personajes.count) {
+    consumir(try! decodificador.decodificar(pagina))
+})
+medidas.append(medir("registro", filas: personajes.count) {
+    consumir(personajes.map { RegistroHeroe(personaje: $0) })
+})
+medidas.append(medir("plan-ingesta", filas: personajes.count) {
+    consumir(PlanIngesta(personajes: personajes, existentes: existentes))
+})
+let plan = PlanIngesta(personajes: personajes, existentes: [:])
+var almacen = AlmacenMemoria()
+medidas.append(medir("ingesta-memoria", filas: plan.total, preparar: { almacen = AlmacenMemoria() }) {
+    try! almacen.aplicar(plan)
+})
+
+// MARK: - Resultados
+
+if opcion("--json") {
+    let encoder = JSONEncoder()
+    encoder.outputFormatting = .prettyPrinted
+    print(String(decoding: try encoder.encode(medidas), as: UTF8.self))
+} else {
+    print("etapa".padding(toLength: 20, withPad: " ", startingAt: 0) + "   reservas/fila      bytes/fila   pico vivos/fila   retenciones/fila")
+    for medida in medidas {
+        //Sin %@: con String no funciona en Linux
+        let linea = medida.etapa.padding(toLength: 20, withPad: " ", startingAt: 0)
+            + String(format: " %15.1f %15.1f %17.2f %18.1f", medida.asignacionesPorFila, medida.bytesPorFila, medida.picoVivosPorFila, medida.retencionesPorFila)
+        print(linea)
+    }
+    if contador_retenciones_disponible() == 0 {
+        print("warning: el runtime de Swift no expone _swift_retain, las retenciones no se cuentan")
+    }
+}
+
+if let ruta = argumento("--guardar-presupuesto") {
+    //El presupuesto deja un margen sobre lo medido ahora para que el ruido no lo rompa
+    let margen = 1 + (Double(argumento("--margen") ?? "") ?? 0.25)
+    var etapas = [String: PresupuestoAsignaciones.Limites]()
+    for medida in medidas {
+        etapas[medida.etapa] = PresupuestoAsignaciones.Limites(asignacionesPorFila: (medida.asignacionesPorFila * margen).rounded(.up),
+                                                               bytesPorFila: (medida.bytesPorFila * margen).rounded(.up),
+                                                               picoVivosPorFila: (medida.picoVivosPorFila * margen * 100).rounded(.up) / 100)
+    }
+    let encoder = JSONEncoder()
+    encoder.outputFormatting = .prettyPrinted
+    try encoder.encode(PresupuestoAsignaciones(etapas: etapas)).write(to: URL(fileURLWithPath: ruta), options: .atomic)
+}
+
+if let ruta = argumento("--presupuesto") {
+    let presupuesto: PresupuestoAsignaciones
+    do {
+        presupuesto = try JSONDecoder().decode(PresupuestoAsignaciones.self, from: Data(contentsOf: URL(fileURLWithPath: ruta)))
+    } catch {
+        salirConError("No se puede leer el presupuesto \(ruta): \(error)")
+    }
+    var excedidas = [String]()
+    for medida in medidas {
+        guard let limites = presupuesto.etapas[medida.etapa] else {
+            continue
+        }
+        if medida.asignacionesPorFila > limites.asignacionesPorFila {
+            excedidas.append("\(medida.etapa) reservas \(medida.asignacionesPorFila) > \(limites.asignacionesPorFila)")
+        }
+        if medida.bytesPorFila > limites.bytesPorFila {
+            excedidas.append("\(medida.etapa) bytes \(medida.bytesPorFila) > \(limites.bytesPorFila)")
+        }
+        if medida.picoVivosPorFila > limites.picoVivosPorFila {
+            excedidas.append("\(medida.etapa) pico vivos \(medida.picoVivosPorFila) > \(limites.picoVivosPorFila)")
+        }
+    }
+    if !excedidas.isEmpty {
+        salirConError("Etapas por encima del presupuesto de reservas:\n  \(excedidas.joined(separator: "\n  "))")
+    }
+}
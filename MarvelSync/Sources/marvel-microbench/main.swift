@@ -0,0 +1,148 @@
+//
+//  main.swift
+//  marvel-microbench
+//
+//  Created by Borja Gil Herrero on 19/10/2026.
+//  Copyright © 2026 Alsis GHE. All rights reserved.
+//
+//  Micro-benchmarks de la parte portable de la sincronizacion sobre las paginas grabadas en
+//  Fixtures: decodificacion, firma, paginacion, plan de ingesta e ingesta en memoria.
+//  Lo que depende de iOS (Core Data, NSFetchedResultsController, miniaturas) se mide dentro de
+//  la app con el argumento de arranque "-BancoPruebas YES" y sale en el mismo formato.
+//
+//  Uso: marvel-microbench [--json] [--tiempo segundos] [--filtro texto]
+//                         [--baseline Benchmarks/baseline.json [--tolerancia 0.10]]
+//                         [--guardar-baseline Benchmarks/baseline.json]
+//       marvel-microbench --comparar resultados.json baseline.json [--tolerancia 0.10]
+//         (compara dos ficheros ya grabados, por ejemplo los del banco de pruebas de la app)
+//
+
+#if os(Linux)
+import Glibc
+#else
+import Darwin
+#endif
+import Foundation
+import MarvelSync
+import LineaComandos
+
+//Sale con error si hay benchmarks que empeoran mas que la tolerancia
+func comprobarRegresiones(_ informe: InformeBanco, baseline: InformeBanco) {
+    let tolerancia = Double(argumento("--tolerancia") ?? "") ?? 0.10
+    let sinMedir = BancoPruebas.sinMedir(baseline)
+    if !sinMedir.isEmpty {
+        print("warning: la linea base no tiene medida de \(sinMedir.joined(separator: ", ")); se graba con --guardar-baseline en la maquina de referencia")
+    }
+    let regresiones = BancoPruebas.regresiones(informe, baseline: baseline, tolerancia: tolerancia)
+    if !regresiones.isEmpty {
+        salirConError("Regresiones respecto a la linea base (>\(Int(tolerancia * 100))%): \(regresiones.joined(separator: ", "))")
+    }
+}
+
+if let rutas = argumentos("--comparar", cantidad: 2) {
+    do {
+        let informe = try BancoPruebas.cargar(URL(fileURLWithPath: rutas[0]))
+        let baseline = try BancoPruebas.cargar(URL(fileURLWithPath: rutas[1]))
+        print(BancoPruebas.tabla(informe, baseline: baseline))
+        comprobarRegresiones(informe, baseline: baseline)
+    } catch {
+        salirConError("No se pueden leer los resultados: \(error)")
+    }
+    exit(0)
+}
+
+//Raiz del paquete a partir de este fichero: Sources/marvel-microbench/main.swift
+let paquete = URL(fileURLWithPath: #file).deletingLastPathComponent().deletingLastPathComponent().deletingLastPathComponent()
+let tamanos = [25, 100, 1000]
+
+var paginas = [Int: Data]()
+for tamano in tamanos {
+    let url = paquete.appendingPathComponent("Fixtures/personajes-\(tamano).json")
+    guard let datos = try? Data(contentsOf: url) else {
+        salirConError("No se encuentra \(url.path)")
+    }
+    paginas[tamano] = datos
+}
+
+let banco = BancoPruebas(suite: "marvel-microbench")
+banco.tiempoMinimo = Double(argumento("--tiempo") ?? "") ?? 1
+banco.filtro = argumento("--filtro")
+
+// MARK: - Decodificacion
+
+let decodificador = DecodificadorPagina()
+for tamano in tamanos {
+    let datos = paginas[tamano]!
+    banco.medir("decodificacion/\(tamano)", unidad: "filas", elementos: tamano) {
+        consumir(try! decodificador.decodificar(datos))
+    }
+}
+banco.medir("decodificacion-bytes/1000", unidad: "bytes", elementos: paginas[1000]!.count) {
+    consumir(try! decodificador.decodificar(paginas[1000]!))
+}
+
+// MARK: - Firma y paginacion
+
+let firma = FirmaMarvel(clavePublica: "c0252ec5bc3ee9b2c6a0a26e2dfb306d", clavePrivada: "c124cdc74823164742598e641674842fa2de600c")
+banco.medir("firma/md5", unidad: "firmas", elementos: 1000) {
+    for indice in 0..<1000 {
+        consumir(firma.hash(ts: String(1_500_000_000 + indice)))
+    }
+}
+let paginador = PaginadorPersonajes(firma: firma, limite: 100, modificadoDesde: Date(timeIntervalSince1970: 1_500_000_000))
+banco.medir("paginador/url", unidad: "urls", elementos: 1000) {
+    for indice in 0..<1000 {
+        consumir(paginador.url(offset: indice * 100, ts: "1500000000"))
+    }
+}
+
+// MARK: - Ingesta
+
+let personajes = try! decodificador.decodificar(paginas[1000]!).results
+//La mitad ya esta en el almacen: la mitad de esos sin cambios y la otra mitad modificados
+var existentes = [Int32: Date]()
+for (posicion, personaje) in personajes.enumerated() where posicion % 2 == 0 {
+    let fecha = PaginadorPersonajes.formatoFecha.date(from: personaje.modified) ?? Date.distantPast
+    existentes[personaje.id] = posicion % 4 == 0 ? fecha : fecha.addingTimeInterval(-86400)
+}
+banco.medir("plan-ingesta/1000", unidad: "filas", elementos: personajes.count) {
+    consumir(PlanIngesta(personajes: personajes, existentes: existentes))
+}
+
+let plan = PlanIngesta(personajes: personajes, existentes: [:])
+var almacen = AlmacenMemoria()
+banco.medir("ingesta-memoria/1000", unidad: "filas", elementos: plan.total, preparar: { almacen = AlmacenMemoria() }) {
+    try! almacen.aplicar(plan)
+}
+
+// MARK: - Resultados
+
+#if os(Linux)
+let plataforma = "linux"
+#else
+let plataforma = "macos"
+#endif
+let informe = banco.informe(plataforma: plataforma)
+
+var baseline: InformeBanco? = nil
+if let ruta = argumento("--baseline") {
+    do {
+        baseline = try BancoPruebas.cargar(URL(fileURLWithPath: ruta))
+    } catch {
+        salirConError("No se puede leer la linea base \(ruta): \(error)")
+    }
+}
+
+if opcion("--json") {
+    print(String(decoding: try BancoPruebas.json(informe), as: UTF8.self))
+} else {
+    print(BancoPruebas.tabla(informe, baseline: baseline))
+}
+
+if let ruta = argumento("--guardar-baseline") {
+    try BancoPruebas.json(informe).write(to: URL(fileURLWithPath: ruta), options: .atomic)
+}
+
+if let baseline = baseline {
+    comprobarRegresiones(informe, baseline: baseline)
+}
@@ -0,0 +1,130 @@
+//
+//  CatalogoFicticio.swift
+//  marvel-stub
+//
+//  Created by Borja Gil Herrero on 19/10/2026.
+//  Copyright © 2026 Alsis GHE. All rights reserved.
+//
+
+import Foundation
+import MarvelSync
+
+//Generador pseudoaleatorio SplitMix64: con la misma semilla sale siempre el mismo catalogo
+struct GeneradorDeterminista {
+    private var estado: UInt64
+
+    init(semilla: UInt64) {
+        estado = semilla
+    }
+
+    mutating func siguiente() -> UInt64 {
+        estado = estado &+ 0x9E3779B97F4A7C15
+        var z = estado
+        z = (z ^ (z >> 30)) &* 0xBF58476D1CE4E5B9
+        z = (z ^ (z >> 27)) &* 0x94D049BB133111EB
+        return z ^ (z >> 31)
+    }
+
+    //Uniforme en [0, 1)
+    mutating func decimal() -> Double {
+        return Double(siguiente() >> 11) / Double(UInt64(1) << 53)
+    }
+
+    mutating func entero(_ limite: Int) -> Int {
+        return Int(siguiente() % UInt64(limite))
+    }
+}
+
+struct PersonajeFicticio {
+    let id: Int32
+    let nombre: String
+    let descripcion: String
+    //Fecha en el formato de la API; algunos personajes reales traen "-0001-11-30T00:00:00-0500"
+    let modificado: String
+    let fecha: Date?
+    let tieneImagen: Bool
+    let comics: Int
+}
+
+//Catalogo de personajes generado a partir de una semilla, con la forma de los datos reales:
+//nombres con acentos y numeros, muchas descripciones vacias, fechas invalidas y personajes
+//sin imagen. Ordenado por fecha de modificacion como con orderBy=modified
+final class CatalogoFicticio {
+
+    static let fechaInvalida = "-0001-11-30T00:00:00-0500"
+
+    private static let prefijos = ["Capitán", "Doctor", "Iron", "Spider", "Black", "Silver", "Ms.", "Ultra", "Night",
+                                   "Star", "Ghost", "Moon", "Ángel", "Scarlet", "Green", "Captain", "Squirrel", "Thunder",
+                                   "Hulk", "Agent", "3-D", "Madame", "Professor", "Winter", "Shadow"]
+    private static let sufijos = ["Man", "Woman", "Widow", "Surfer", "Hawk", "Wolf", "Knight", "Witch", "Girl",
+                                  "Lord", "Soldier", "King", "Queen", "Strange", "Panther", "Fist", "Storm", "Rider",
+                                  "Cat", "Bolt"]
+    private static let palabras = ["hero", "mutant", "agent", "shield", "cosmic", "power", "city", "team", "villain",
+                                   "ally", "secret", "ancient", "armor", "lab", "energy", "mission", "earth", "galaxy"]
+
+    let personajes: [PersonajeFicticio]
+
+    init(numeroPersonajes: Int, semilla: UInt64) {
+        var generador = GeneradorDeterminista(semilla: semilla)
+        let combinaciones = CatalogoFicticio.prefijos.count * CatalogoFicticio.sufijos.count
+        //2013-01-01 a 2026-01-01
+        let inicio: TimeInterval = 1_356_998_400
+        let intervalo: TimeInterval = 409_968_000
+
+        var lista = [PersonajeFicticio]()
+        lista.reserveCapacity(numeroPersonajes)
+        for posicion in 0..<numeroPersonajes {
+            let combinacion = posicion % combinaciones
+            var nombre = CatalogoFicticio.prefijos[combinacion % CatalogoFicticio.prefijos.count] + " "
+                + CatalogoFicticio.sufijos[combinacion / CatalogoFicticio.prefijos.count]
+            if posicion >= combinaciones {
+                nombre += " (Earth-\(posicion / combinaciones))"
+            }
+
+            var descripcion = ""
+            if generador.decimal() < 0.45 {
+                let longitud = 8 + generador.entero(60)
+                descripcion = (0..<longitud).map { _ in CatalogoFicticio.palabras[generador.entero(CatalogoFicticio.palabras.count)] }
+                    .joined(separator: " ")
+            }
+
+            let modificado: String
+            let fecha: Date?
+            if generador.decimal() < 0.05 {
+                modificado = CatalogoFicticio.fechaInvalida
+                fecha = nil
+            } else {
+                let segundos = (inicio + generador.decimal() * intervalo).rounded()
+                fecha = Date(timeIntervalSince1970: segundos)
+                modificado = PaginadorPersonajes.formatoFecha.string(from: fecha!)
+            }
+
+            lista.append(PersonajeFicticio(id: Int32(1_009_000 + posicion), nombre: nombre, descripcion: descripcion,
+                                           modificado: modificado, fecha: fecha, tieneImagen: generador.decimal() >= 0.1,
+                                           comics: generador.entero(120)))
+        }
+        //Las fechas invalidas quedan al principio, igual que en la API
+        personajes = lista.sorted {
+            ($0.fecha ?? Date.distantPast, $0.id) < ($1.fecha ?? Date.distantPast, $1.id)
+        }
+    }
+
+    //Personajes modificados despues de la fecha, en el orden del catalogo
+    func filtrados(modificadoDesde desde: Date?) -> ArraySlice<PersonajeFicticio> {
+        guard let desde = desde else {
+            return personajes[...]
+        }
+        //El catalogo esta ordenado por fecha: busqueda binaria del primero posterior
+        var inferior = 0
+        var superior = personajes.count
+        while inferior < superior {
+            let medio = (inferior + superior) / 2
+            if let fecha = personajes[medio].fecha, fecha >= desde {
+                superior = medio
+            } else {
+                inferior = medio + 1
+            }
+        }
+        return personajes[inferior...]
+    }
+}
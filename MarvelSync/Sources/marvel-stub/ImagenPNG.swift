@@ -0,0 +1,94 @@
+//
+//  ImagenPNG.swift
+//  marvel-stub
+//
+//  Created by Borja Gil Herrero on 19/10/2026.
+//  Copyright © 2026 Alsis GHE. All rights reserved.
+//
+
+import Foundation
+
+//PNG RGB sin compresion (bloques deflate "stored") con un degradado que depende del id. No
+//hace falta ninguna libreria y el cliente tiene que decodificarlo y reducirlo como una imagen real
+enum ImagenPNG {
+
+    private static let tablaCRC: [UInt32] = (0..<256).map { n -> UInt32 in
+        var c = UInt32(n)
+        for _ in 0..<8 {
+            c = (c & 1) != 0 ? 0xEDB88320 ^ (c >> 1) : c >> 1
+        }
+        return c
+    }
+
+    static func generar(ancho: Int, alto: Int, semilla: Int) -> Data {
+        let r0 = UInt8(truncatingIfNeeded: semilla &* 97)
+        let g0 = UInt8(truncatingIfNeeded: semilla &* 57)
+        let b0 = UInt8(truncatingIfNeeded: semilla &* 23)
+
+        //Cada fila empieza con el filtro 0 (ninguno)
+        var pixeles = [UInt8]()
+        pixeles.reserveCapacity(alto * (1 + ancho * 3))
+        for y in 0..<alto {
+            pixeles.append(0)
+            for x in 0..<ancho {
+                pixeles.append(r0 &+ UInt8(truncatingIfNeeded: x))
+                pixeles.append(g0 &+ UInt8(truncatingIfNeeded: y))
+                pixeles.append(b0 &+ UInt8(truncatingIfNeeded: x ^ y))
+            }
+        }
+
+        var png: [UInt8] = [0x89, 0x50, 0x4E, 0x47, 0x0D, 0x0A, 0x1A, 0x0A]
+        var cabecera = [UInt8]()
+        cabecera += bigEndian(UInt32(ancho))
+        cabecera += bigEndian(UInt32(alto))
+        cabecera += [8, 2, 0, 0, 0] //8 bits, RGB, deflate, filtro adaptativo, sin entrelazado
+        png += bloque("IHDR", cabecera)
+        png += bloque("IDAT", zlibSinCompresion(pixeles))
+        png += bloque("IEND", [])
+        return Data(png)
+    }
+
+    private static func bloque(_ tipo: String, _ datos: [UInt8]) -> [UInt8] {
+        let tipoYDatos = Array(tipo.utf8) + datos
+        return bigEndian(UInt32(datos.count)) + tipoYDatos + bigEndian(crc32(tipoYDatos))
+    }
+
+    private static func zlibSinCompresion(_ datos: [UInt8]) -> [UInt8] {
+        var salida: [UInt8] = [0x78, 0x01]
+        var posicion = 0
+        repeat {
+            let longitud = min(65_535, datos.count - posicion)
+            let ultimo: UInt8 = posicion + longitud == datos.count ? 1 : 0
+            salida.append(ultimo)
+            salida.append(UInt8(longitud & 0xFF))
+            salida.append(UInt8(longitud >> 8))
+            salida.append(UInt8(~longitud & 0xFF))
+            salida.append(UInt8((~longitud >> 8) & 0xFF))
+            salida += datos[posicion..<(posicion + longitud)]
+            posicion += longitud
+        } while posicion < datos.count
+        return salida + bigEndian(adler32(datos))
+    }
+
+    private static func crc32(_ datos: [UInt8]) -> UInt32 {
+        var crc: UInt32 = 0xFFFFFFFF
+        for byte in datos {
+            crc = tablaCRC[Int((crc ^ UInt32(byte)) & 0xFF)] ^ (crc >> 8)
+        }
+        return crc ^ 0xFFFFFFFF
+    }
+
+    private static func adler32(_ datos: [UInt8]) -> UInt32 {
+        var a: UInt32 = 1
+        var b: UInt32 = 0
+        for byte in datos {
+            a = (a + UInt32(byte)) % 65_521
+            b = (b + a) % 65_521
+        }
+        return b << 16 | a
+    }
+
+    private static func bigEndian(_ valor: UInt32) -> [UInt8] {
+        return [UInt8(valor >> 24), UInt8((valor >> 16) & 0xFF), UInt8((valor >> 8) & 0xFF), UInt8(valor & 0xFF)]
+    }
+}
@@ -0,0 +1,101 @@
+//
+//  InyeccionFallos.swift
+//  marvel-stub
+//
+//  Created by Borja Gil Herrero on 19/10/2026.
+//  Copyright © 2026 Alsis GHE. All rights reserved.
+//
+
+import Foundation
+
+//Distribucion de la latencia añadida a cada respuesta, en milisegundos
+enum DistribucionLatencia {
+    case ninguna
+    case fija(Double)
+    case uniforme(Double, Double)
+    //Mediana y sigma del logaritmo: cola larga como la de una red real
+    case lognormal(Double, Double)
+
+    //"fija:50", "uniforme:20-200", "lognormal:80-0.6"
+    init?(texto: String) {
+        let partes = texto.split(separator: ":", maxSplits: 1).map(String.init)
+        guard let nombre = partes.first else {
+            return nil
+        }
+        let valores = partes.count > 1 ? partes[1].split(separator: "-").compactMap { Double($0) } : []
+        switch (nombre, valores.count) {
+        case ("ninguna", _):
+            self = .ninguna
+        case ("fija", 1):
+            self = .fija(valores[0])
+        case ("uniforme", 2):
+            self = .uniforme(valores[0], valores[1])
+        case ("lognormal", 2):
+            self = .lognormal(valores[0], valores[1])
+        default:
+            return nil
+        }
+    }
+
+    func muestra(_ generador: inout GeneradorDeterminista) -> Double {
+        switch self {
+        case .ninguna:
+            return 0
+        case .fija(let milisegundos):
+            return milisegundos
+        case .uniforme(let minimo, let maximo):
+            return minimo + generador.decimal() * (maximo - minimo)
+        case .lognormal(let mediana, let sigma):
+            //Box-Muller
+            let u1 = max(generador.decimal(), Double.leastNonzeroMagnitude)
+            let normal = (-2 * log(u1)).squareRoot() * cos(2 * Double.pi * generador.decimal())
+            return mediana * exp(sigma * normal)
+        }
+    }
+}
+
+//Fallo que se inyecta en una respuesta
+enum Fallo {
+    //429 con Retry-After
+    case limiteExcedido
+    //500, 502, 503 o 504
+    case servidor(Int)
+    //Se anuncia el cuerpo completo y se cierra la conexion a mitad
+    case truncado
+}
+
+//Decide latencia y fallos de cada peticion. Con la misma semilla y el mismo orden de peticiones
+//se repite exactamente la misma secuencia
+final class InyeccionFallos {
+
+    var latencia = DistribucionLatencia.ninguna
+    var probabilidad429 = 0.0
+    var probabilidad5xx = 0.0
+    var probabilidadTruncado = 0.0
+    var retryAfter = 1
+
+    private let cerrojo = NSLock()
+    private var generador: GeneradorDeterminista
+
+    init(semilla: UInt64) {
+        generador = GeneradorDeterminista(semilla: semilla ^ 0x5EED)
+    }
+
+    //Latencia en segundos y fallo (si toca) para la siguiente respuesta
+    func siguiente() -> (TimeInterval, Fallo?) {
+        cerrojo.lock()
+        defer { cerrojo.unlock() }
+        let espera = max(0, latencia.muestra(&generador)) / 1000
+        let tirada = generador.decimal()
+        if tirada < probabilidad429 {
+            return (espera, .limiteExcedido)
+        }
+        if tirada < probabilidad429 + probabilidad5xx {
+            return (espera, .servidor([500, 502, 503, 504][generador.entero(4)]))
+        }
+        if tirada < probabilidad429 + probabilidad5xx + probabilidadTruncado {
+            return (espera, .truncado)
+        }
+        return (espera, nil)
+    }
+}
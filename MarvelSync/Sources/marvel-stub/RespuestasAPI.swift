@@ -0,0 +1,86 @@
+//
+//  RespuestasAPI.swift
+//  marvel-stub
+//
+//  Created by Borja Gil Herrero on 19/10/2026.
+//  Copyright © 2026 Alsis GHE. All rights reserved.
+//
+
+import Foundation
+
+//Cuerpos JSON con el mismo sobre que la API (RespuestaAPI / DataAPI). Se escriben a mano para
+//que el orden de las claves, y con el la etag, sea siempre el mismo
+enum RespuestasAPI {
+
+    static let copyright = "© 2026 MARVEL"
+    static let atribucion = "Data provided by Marvel. © 2026 MARVEL"
+    static let atribucionHTML = "<a href=\"http://marvel.com\">" + atribucion + "</a>"
+
+    //Cuerpo de una pagina de personajes y su etag, que tambien va en la cabecera ETag
+    static func pagina(_ personajes: ArraySlice<PersonajeFicticio>, offset: Int, limit: Int, total: Int, urlPublica: String) -> (String, String) {
+        var resultados = [String]()
+        resultados.reserveCapacity(personajes.count)
+        for personaje in personajes {
+            resultados.append(json(de: personaje, urlPublica: urlPublica))
+        }
+        let datos = "{\"offset\":\(offset),\"limit\":\(limit),\"total\":\(total),\"count\":\(personajes.count),\"results\":[\(resultados.joined(separator: ","))]}"
+        let etag = Etag.de(datos)
+        let cuerpo = "{\"code\":200,\"status\":\"Ok\",\"copyright\":\(cadena(copyright)),\"attributionText\":\(cadena(atribucion)),"
+            + "\"attributionHTML\":\(cadena(atribucionHTML)),\"etag\":\(cadena(etag)),\"data\":\(datos)}"
+        return (cuerpo, etag)
+    }
+
+    //Error con el formato de la API, por ejemplo {"code":409,"status":"Limit greater than 100."}
+    static func error(codigo: Int, mensaje: String) -> String {
+        return "{\"code\":\(codigo),\"status\":\(cadena(mensaje))}"
+    }
+
+    private static func json(de personaje: PersonajeFicticio, urlPublica: String) -> String {
+        let uri = "\(urlPublica)/v1/public/characters/\(personaje.id)"
+        let rutaImagen = personaje.tieneImagen ? "\(urlPublica)/images/\(personaje.id)" : "\(urlPublica)/images/image_not_available"
+        let devueltos = min(personaje.comics, 20)
+        let comics = (0..<devueltos).map { indice in
+            "{\"resourceURI\":\(cadena("\(urlPublica)/v1/public/comics/\(Int(personaje.id) * 10 + indice)")),\"name\":\(cadena("\(personaje.nombre) #\(indice + 1)"))}"
+        }
+        return "{\"id\":\(personaje.id),\"name\":\(cadena(personaje.nombre)),\"description\":\(cadena(personaje.descripcion)),"
+            + "\"modified\":\(cadena(personaje.modificado)),\"thumbnail\":{\"path\":\(cadena(rutaImagen)),\"extension\":\"png\"},"
+            + "\"resourceURI\":\(cadena(uri)),"
+            + "\"comics\":{\"available\":\(personaje.comics),\"collectionURI\":\(cadena(uri + "/comics")),\"items\":[\(comics.joined(separator: ","))],\"returned\":\(devueltos)},"
+            + "\"series\":{\"available\":0,\"collectionURI\":\(cadena(uri + "/series")),\"items\":[],\"returned\":0},"
+            + "\"stories\":{\"available\":0,\"collectionURI\":\(cadena(uri + "/stories")),\"items\":[],\"returned\":0},"
+            + "\"events\":{\"available\":0,\"collectionURI\":\(cadena(uri + "/events")),\"items\":[],\"returned\":0},"
+            + "\"urls\":[{\"type\":\"detail\",\"url\":\(cadena("http://marvel.com/characters/\(personaje.id)"))}]}"
+    }
+
+    //Cadena JSON escapada
+    static func cadena(_ texto: String) -> String {
+        var salida = "\""
+        for escalar in texto.unicodeScalars {
+            switch escalar {
+            case "\"": salida += "\\\""
+            case "\\": salida += "\\\\"
+            case "\n": salida += "\\n"
+            case "\r": salida += "\\r"
+            case "\t": salida += "\\t"
+            default:
+                if escalar.value < 0x20 {
+                    salida += String(format: "\\u%04x", escalar.value)
+                } else {
+                    salida.unicodeScalars.append(escalar)
+                }
+            }
+        }
+        return salida + "\""
+    }
+}
+
+//Etag estable de un contenido: FNV-1a de 64 bits en hexadecimal
+enum Etag {
+    static func de(_ texto: String) -> String {
+        var hash: UInt64 = 0xcbf29ce484222325
+        for byte in texto.utf8 {
+            hash = (hash ^ UInt64(byte)) &* 0x100000001b3
+        }
+        return String(hash, radix: 16)
+    }
+}
@@ -0,0 +1,209 @@
+//
+//  ServidorHTTP.swift
+//  marvel-stub
+//
+//  Created by Borja Gil Herrero on 19/10/2026.
+//  Copyright © 2026 Alsis GHE. All rights reserved.
+//
+
+#if os(Linux)
+import Glibc
+#else
+import Darwin
+#endif
+import Foundation
+
+struct PeticionHTTP {
+    let metodo: String
+    let ruta: String
+    let parametros: [String: String]
+    //Nombres en minusculas
+    let cabeceras: [String: String]
+}
+
+struct RespuestaHTTP {
+    var estado: Int
+    var cabeceras: [(String, String)]
+    var cuerpo: Data
+    //Cerrar la conexion a mitad del cuerpo
+    var truncar = false
+
+    init(estado: Int, cabeceras: [(String, String)] = [], cuerpo: Data = Data()) {
+        self.estado = estado
+        self.cabeceras = cabeceras
+        self.cuerpo = cuerpo
+    }
+}
+
+//Servidor HTTP/1.1 minimo con sockets bloqueantes y un hilo por conexion. Admite keep-alive,
+//que es lo que hace URLSession, y solo peticiones sin cuerpo. Suficiente para un stub local
+final class ServidorHTTP {
+
+    enum ErrorServidor: Error {
+        case socket(Int32)
+    }
+
+    private let puerto: UInt16
+    private let manejador: (PeticionHTTP) -> RespuestaHTTP
+
+    init(puerto: UInt16, manejador: @escaping (PeticionHTTP) -> RespuestaHTTP) {
+        self.puerto = puerto
+        self.manejador = manejador
+    }
+
+    func escuchar() throws -> Never {
+        //Escribir en una conexion que el cliente ya ha cerrado no debe matar el proceso
+        signal(SIGPIPE, SIG_IGN)
+
+        #if os(Linux)
+        let descriptor = socket(AF_INET, Int32(SOCK_STREAM.rawValue), 0)
+        #else
+        let descriptor = socket(AF_INET, SOCK_STREAM, 0)
+        #endif
+        guard descriptor >= 0 else {
+            throw ErrorServidor.socket(errno)
+        }
+        var uno: Int32 = 1
+        setsockopt(descriptor, SOL_SOCKET, SO_REUSEADDR, &uno, socklen_t(MemoryLayout<Int32>.size))
+
+        var direccion = sockaddr_in()
+        #if !os(Linux)
+        direccion.sin_len = UInt8(MemoryLayout<sockaddr_in>.size)
+        #endif
+        direccion.sin_family = sa_family_t(AF_INET)
+        direccion.sin_port = in_port_t(puerto).bigEndian
+        direccion.sin_addr.s_addr = inet_addr("127.0.0.1")
+        let enlazado = withUnsafePointer(to: &direccion) {
+            $0.withMemoryRebound(to: sockaddr.self, capacity: 1) {
+                bind(descriptor, $0, socklen_t(MemoryLayout<sockaddr_in>.size))
+            }
+        }
+        guard enlazado == 0, listen(descriptor, 128) == 0 else {
+            throw ErrorServidor.socket(errno)
+        }
+
+        while true {
+            let conexion = accept(descriptor, nil, nil)
+            if conexion < 0 {
+                continue
+            }
+            DispatchQueue.global().async {
+                self.atender(conexion)
+            }
+        }
+    }
+
+    private func atender(_ conexion: Int32) {
+        defer { close(conexion) }
+        var espera = timeval(tv_sec: 30, tv_usec: 0)
+        setsockopt(conexion, SOL_SOCKET, SO_RCVTIMEO, &espera, socklen_t(MemoryLayout<timeval>.size))
+
+        var pendiente = [UInt8]()
+        var lectura = [UInt8](repeating: 0, count: 8192)
+        let separador: [UInt8] = [13, 10, 13, 10]
+        while true {
+            //Cabeceras completas de la siguiente peticion
+            var fin = buscar(separador, en: pendiente)
+            while fin == nil {
+                let leidos = read(conexion, &lectura, lectura.count)
+                if leidos <= 0 {
+                    return
+                }
+                pendiente += lectura[0..<leidos]
+                fin = buscar(separador, en: pendiente)
+            }
+            let texto = String(decoding: pendiente[0..<fin!], as: UTF8.self)
+            pendiente.removeFirst(fin! + separador.count)
+
+            guard let peticion = interpretar(texto) else {
+                enviar(RespuestaHTTP(estado: 400), a: conexion, mantener: false)
+                return
+            }
+            let respuesta = manejador(peticion)
+            let mantener = peticion.cabeceras["connection"]?.lowercased() != "close" && !respuesta.truncar
+            if !enviar(respuesta, a: conexion, mantener: mantener) || !mantener {
+                return
+            }
+        }
+    }
+
+    private func interpretar(_ texto: String) -> PeticionHTTP? {
+        let lineas = texto.components(separatedBy: "\r\n")
+        let inicio = lineas[0].split(separator: " ")
+        guard inicio.count >= 2, let componentes = URLComponents(string: "http://localhost" + inicio[1]) else {
+            return nil
+        }
+        var parametros = [String: String]()
+        for parametro in componentes.queryItems ?? [] {
+            parametros[parametro.name] = parametro.value ?? ""
+        }
+        var cabeceras = [String: String]()
+        for linea in lineas.dropFirst() {
+            guard let dosPuntos = linea.firstIndex(of: ":") else {
+                continue
+            }
+            let nombre = linea[..<dosPuntos].trimmingCharacters(in: .whitespaces).lowercased()
+            cabeceras[nombre] = linea[linea.index(after: dosPuntos)...].trimmingCharacters(in: .whitespaces)
+        }
+        return PeticionHTTP(metodo: String(inicio[0]), ruta: componentes.path, parametros: parametros, cabeceras: cabeceras)
+    }
+
+    @discardableResult
+    private func enviar(_ respuesta: RespuestaHTTP, a conexion: Int32, mantener: Bool) -> Bool {
+        var cabecera = "HTTP/1.1 \(respuesta.estado) \(ServidorHTTP.razon(respuesta.estado))\r\n"
+        cabecera += "Content-Length: \(respuesta.cuerpo.count)\r\n"
+        cabecera += "Connection: \(mantener ? "keep-alive" : "close")\r\n"
+        for (nombre, valor) in respuesta.cabeceras {
+            cabecera += "\(nombre): \(valor)\r\n"
+        }
+        cabecera += "\r\n"
+
+        var cuerpo = respuesta.cuerpo
+        if respuesta.truncar {
+            cuerpo = cuerpo.prefix(cuerpo.count / 2)
+        }
+        return escribir(Array(cabecera.utf8), en: conexion) && escribir(Array(cuerpo), en: conexion)
+    }
+
+    private func escribir(_ bytes: [UInt8], en conexion: Int32) -> Bool {
+        var enviados = 0
+        while enviados < bytes.count {
+            let resultado = bytes.withUnsafeBufferPointer {
+                write(conexion, $0.baseAddress! + enviados, bytes.count - enviados)
+            }
+            if resultado <= 0 {
+                return false
+            }
+            enviados += resultado
+        }
+        return true
+    }
+
+    private func buscar(_ patron: [UInt8], en bytes: [UInt8]) -> Int? {
+        guard bytes.count >= patron.count else {
+            return nil
+        }
+        for inicio in 0...(bytes.count - patron.count) where bytes[inicio] == patron[0] {
+            if Array(bytes[inicio..<(inicio + patron.count)]) == patron {
+                return inicio
+            }
+        }
+        return nil
+    }
+
+    static func razon(_ estado: Int) -> String {
+        switch estado {
+        case 200: return "OK"
+        case 304: return "Not Modified"
+        case 400: return "Bad Request"
+        case 404: return "Not Found"
+        case 409: return "Conflict"
+        case 429: return "Too Many Requests"
+        case 500: return "Internal Server Error"
+        case 502: return "Bad Gateway"
+        case 503: return "Service Unavailable"
+        case 504: return "Gateway Timeout"
+        default: return "Status"
+        }
+    }
+}
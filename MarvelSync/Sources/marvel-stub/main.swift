@@ -0,0 +1,159 @@
+//
+//  main.swift
+//  marvel-stub
+//
+//  Created by Borja Gil Herrero on 19/10/2026.
+//  Copyright © 2026 Alsis GHE. All rights reserved.
+//
+//  Sustituto local y determinista de la API de Marvel para medir la sincronizacion sin red:
+//  pagina /v1/public/characters con el mismo sobre que la API, sirve las imagenes, respeta
+//  If-None-Match e inyecta latencia, 429, 5xx y cuerpos truncados.
+//
+//  Uso: marvel-stub [--puerto 8080] [--personajes 1500] [--semilla 1]
+//                   [--latencia ninguna|fija:ms|uniforme:min-max|lognormal:mediana-sigma]
+//                   [--429 probabilidad] [--5xx probabilidad] [--truncado probabilidad]
+//                   [--retry-after segundos] [--url-publica http://127.0.0.1:8080] [--limite-maximo 100]
+//
+
+#if os(Linux)
+import Glibc
+#else
+import Darwin
+#endif
+import Foundation
+import MarvelSync
+import LineaComandos
+
+let puerto = UInt16(argumento("--puerto") ?? "") ?? 8080
+let numeroPersonajes = Int(argumento("--personajes") ?? "") ?? 1500
+let semilla = UInt64(argumento("--semilla") ?? "") ?? 1
+let urlPublica = argumento("--url-publica") ?? "http://127.0.0.1:\(puerto)"
+//La API real no deja pedir mas de 100 por pagina; se puede subir para grabar fixtures grandes
+let limiteMaximo = Int(argumento("--limite-maximo") ?? "") ?? 100
+
+let fallos = InyeccionFallos(semilla: semilla)
+if let texto = argumento("--latencia") {
+    guard let latencia = DistribucionLatencia(texto: texto) else {
+        salirConError("Latencia no valida: \(texto)")
+    }
+    fallos.latencia = latencia
+}
+fallos.probabilidad429 = Double(argumento("--429") ?? "") ?? 0
+fallos.probabilidad5xx = Double(argumento("--5xx") ?? "") ?? 0
+fallos.probabilidadTruncado = Double(argumento("--truncado") ?? "") ?? 0
+fallos.retryAfter = Int(argumento("--retry-after") ?? "") ?? 1
+
+let catalogo = CatalogoFicticio(numeroPersonajes: numeroPersonajes, semilla: semilla)
+
+//Tamaños de las variantes de imagen de la API que usa la app; sin variante se sirve la completa
+let variantes: [String: (Int, Int)] = [
+    "standard_small": (65, 45),
+    "standard_medium": (100, 100),
+    "portrait_small": (50, 75),
+    "portrait_medium": (100, 150),
+]
+let tamanoCompleto = (160, 160)
+
+func json(_ estado: Int, _ cuerpo: String, cabeceras: [(String, String)] = []) -> RespuestaHTTP {
+    return RespuestaHTTP(estado: estado, cabeceras: [("Content-Type", "application/json; charset=utf-8")] + cabeceras,
+                         cuerpo: Data(cuerpo.utf8))
+}
+
+//304 si el cliente ya tiene esta version
+func noModificado(_ peticion: PeticionHTTP, etag: String) -> RespuestaHTTP? {
+    guard let enviada = peticion.cabeceras["if-none-match"], enviada == etag || enviada == "\"\(etag)\"" else {
+        return nil
+    }
+    return RespuestaHTTP(estado: 304, cabeceras: [("ETag", etag)])
+}
+
+func personajes(_ peticion: PeticionHTTP) -> RespuestaHTTP {
+    for parametro in ["ts", "apikey", "hash"] where (peticion.parametros[parametro] ?? "").isEmpty {
+        return json(409, RespuestasAPI.error(codigo: 409, mensaje: "You must provide a \(parametro)."))
+    }
+    let limit = Int(peticion.parametros["limit"] ?? "20") ?? -1
+    let offset = Int(peticion.parametros["offset"] ?? "0") ?? -1
+    guard limit > 0, limit <= limiteMaximo else {
+        return json(409, RespuestasAPI.error(codigo: 409, mensaje: limit > limiteMaximo ? "Limit greater than \(limiteMaximo)." : "Limit invalid or below 1."))
+    }
+    guard offset >= 0 else {
+        return json(409, RespuestasAPI.error(codigo: 409, mensaje: "Invalid or unrecognized parameter."))
+    }
+    var desde: Date? = nil
+    if let texto = peticion.parametros["modifiedSince"] {
+        guard let fecha = PaginadorPersonajes.formatoFecha.date(from: texto) else {
+            return json(409, RespuestasAPI.error(codigo: 409, mensaje: "Invalid or unrecognized parameter."))
+        }
+        desde = fecha
+    }
+
+    let filtrados = catalogo.filtrados(modificadoDesde: desde)
+    let inicio = min(filtrados.startIndex + offset, filtrados.endIndex)
+    let fin = min(inicio + limit, filtrados.endIndex)
+    let (cuerpo, etag) = RespuestasAPI.pagina(filtrados[inicio..<fin], offset: offset, limit: limit, total: filtrados.count, urlPublica: urlPublica)
+    return noModificado(peticion, etag: etag) ?? json(200, cuerpo, cabeceras: [("ETag", etag)])
+}
+
+//Rutas /images/<id>.png, /images/<id>/<variante>.png y lo mismo con image_not_available
+func imagen(_ peticion: PeticionHTTP) -> RespuestaHTTP {
+    let partes = peticion.ruta.split(separator: "/").dropFirst().map(String.init)
+    guard let primera = partes.first, partes.count <= 2, peticion.ruta.hasSuffix(".png") else {
+        return RespuestaHTTP(estado: 404)
+    }
+    let nombre = partes.count == 1 ? String(primera.dropLast(4)) : primera
+    let variante = partes.count == 2 ? String(partes[1].dropLast(4)) : ""
+    guard let tamano = variante.isEmpty ? tamanoCompleto : variantes[variante] else {
+        return RespuestaHTTP(estado: 404)
+    }
+    let (ancho, alto) = tamano
+    let id = Int(nombre) ?? 0
+    guard id != 0 || nombre == "image_not_available" else {
+        return RespuestaHTTP(estado: 404)
+    }
+    let etag = "img-\(nombre)-\(ancho)x\(alto)"
+    return noModificado(peticion, etag: etag) ?? RespuestaHTTP(estado: 200, cabeceras: [("Content-Type", "image/png"), ("ETag", etag)],
+                                                              cuerpo: ImagenPNG.generar(ancho: ancho, alto: alto, semilla: id))
+}
+
+func atender(_ peticion: PeticionHTTP) -> RespuestaHTTP {
+    guard peticion.metodo == "GET" else {
+        return RespuestaHTTP(estado: 400)
+    }
+    let (espera, fallo) = fallos.siguiente()
+    if espera > 0 {
+        usleep(useconds_t(espera * 1_000_000))
+    }
+
+    if let fallo = fallo {
+        switch fallo {
+        case .limiteExcedido:
+            return json(429, RespuestasAPI.error(codigo: 429, mensaje: "You have exceeded your rate limit.  Please try again later."),
+                        cabeceras: [("Retry-After", String(fallos.retryAfter))])
+        case .servidor(let estado):
+            return json(estado, RespuestasAPI.error(codigo: estado, mensaje: ServidorHTTP.razon(estado)))
+        case .truncado:
+            break
+        }
+    }
+
+    var respuesta: RespuestaHTTP
+    if peticion.ruta == PaginadorPersonajes.rutaPersonajes {
+        respuesta = personajes(peticion)
+    } else if peticion.ruta.hasPrefix("/images/") {
+        respuesta = imagen(peticion)
+    } else {
+        respuesta = json(404, RespuestasAPI.error(codigo: 404, mensaje: "We couldn't find that resource."))
+    }
+    if case .truncado? = fallo, !respuesta.cuerpo.isEmpty {
+        respuesta.truncar = true
+    }
+    return respuesta
+}
+
+print("marvel-stub: \(catalogo.personajes.count) personajes (semilla \(semilla)) en \(urlPublica)")
+fflush(stdout)
+do {
+    try ServidorHTTP(puerto: puerto, manejador: atender).escuchar()
+} catch {
+    salirConError("No se ha podido abrir el puerto \(puerto): \(error)")
+}
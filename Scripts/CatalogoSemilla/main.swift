@@ -0,0 +1,100 @@
+//
+//  main.swift
+//  Heroes Marvel - generador del catalogo semilla
+//
+//  Created by Borja Gil Herrero on 19/10/2026.
+//  Copyright © 2026 Alsis GHE. All rights reserved.
+//
+//  Recorre la API de Marvel y guarda nombre, descripcion, id, fecha de modificacion y una
+//  miniatura pequeña de cada personaje en un almacen de Core Data con el modelo de la app.
+//  Uso: generar <Heroes_Marvel.momd> <salida.sqlite>
+//
+
+import Foundation
+import CoreData
+
+let argumentos = CommandLine.arguments
+guard argumentos.count == 3 else {
+    print("Uso: generar <Heroes_Marvel.momd> <salida.sqlite>")
+    exit(1)
+}
+
+let entorno = ProcessInfo.processInfo.environment
+let APIKEY: String = entorno["MARVEL_APIKEY"] ?? ""
+let PRIVKEY: String = entorno["MARVEL_PRIVKEY"] ?? ""
+
+let formatoFecha: DateFormatter = {
+    let formato = DateFormatter()
+    formato.locale = Locale(identifier: "en_US_POSIX")
+    formato.dateFormat = "yyyy-MM-dd'T'HH:mm:ssZ"
+    return formato
+}()
+
+//Descarga sincrona, la herramienta no tiene nada mejor que hacer mientras espera
+func descargar(_ url: URL) -> Data? {
+    let semaforo = DispatchSemaphore(value: 0)
+    var resultado: Data? = nil
+    URLSession.shared.dataTask(with: url) { data, response, error in
+        if let http = response as? HTTPURLResponse, http.statusCode == 200 {
+            resultado = data
+        }
+        semaforo.signal()
+    }.resume()
+    semaforo.wait()
+    return resultado
+}
+
+//Modelo compilado de la app, sin las clases de la app (usamos NSManagedObject)
+let modelo = NSManagedObjectModel(contentsOf: URL(fileURLWithPath: argumentos[1]))!
+for entidad in modelo.entities {
+    entidad.managedObjectClassName = NSStringFromClass(NSManagedObject.self)
+}
+
+let coordinator = NSPersistentStoreCoordinator(managedObjectModel: modelo)
+//Sin WAL para que el catalogo sea un unico fichero
+let opciones: [AnyHashable: Any] = [NSSQLitePragmasOption: ["journal_mode": "DELETE"]]
+try! coordinator.addPersistentStore(ofType: NSSQLiteStoreType, configurationName: nil, at: URL(fileURLWithPath: argumentos[2]), options: opciones)
+
+let context = NSManagedObjectContext(concurrencyType: .privateQueueConcurrencyType)
+context.persistentStoreCoordinator = coordinator
+
+let limit = 100
+var offset = 0
+var total = Int.max
+
+while offset < total {
+    let ts = NSDate().timeIntervalSince1970.description
+    let hash = "\(ts)\(PRIVKEY)\(APIKEY)".md5()!
+    let urlPagina = URL(string: "https://gateway.marvel.com/v1/public/characters?ts=\(ts)&apikey=\(APIKEY)&hash=\(hash)&limit=\(limit)&offset=\(offset)&orderBy=modified")!
+
+    guard let data = descargar(urlPagina), let respuestaAPI = try? JSONDecoder().decode(RespuestaAPI.self, from: data), respuestaAPI.code == 200 else {
+        print("Error descargando la pagina con offset \(offset)")
+        exit(1)
+    }
+    total = respuestaAPI.data.total
+
+    context.performAndWait {
+        for personaje in respuestaAPI.data.results {
+            let heroe = NSEntityDescription.insertNewObject(forEntityName: "Heroe", into: context)
+            heroe.setValue(personaje.id, forKey: "idMarvel")
+            heroe.setValue(personaje.name, forKey: "nombre")
+            if personaje.descriptionString != "" {
+                heroe.setValue(personaje.descriptionString, forKey: "descripcion")
+            }
+            heroe.setValue(formatoFecha.date(from: personaje.modified), forKey: "modificado")
+
+            //Variante standard_small (65x45) de la imagen, suficiente para la fila de la lista
+            let imagen = personaje.thumbnail
+            if imagen.path != "" && !imagen.path.hasSuffix("image_not_available") {
+                if let urlMiniatura = URL(string: imagen.path + "/standard_small." + imagen.extensionString) {
+                    heroe.setValue(descargar(urlMiniatura), forKey: "miniatura")
+                }
+            }
+        }
+        try! context.save()
+        context.reset()
+    }
+
+    offset += limit
+    print("\(min(offset, total))/\(total)")
+}
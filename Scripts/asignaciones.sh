@@ -0,0 +1,34 @@
+#!/bin/sh
+#
+#  asignaciones.sh
+#  Heroes Marvel
+#
+#  Ejecuta marvel-allocbench en release y comprueba el presupuesto de reservas por fila de cada
+#  etapa de la ingesta (MarvelSync/Benchmarks/presupuesto-asignaciones.json). Sale con error si
+#  alguna etapa lo supera. Con --guardar se graba un presupuesto nuevo a partir de lo medido
+#  ahora mas un margen; las cifras dependen de la plataforma y de la version de Swift.
+#
+#  Uso:
+#    Scripts/asignaciones.sh [--guardar [--margen 0.25]] [--filas 1000]
+#
+
+set -e
+
+RAIZ="$(cd "$(dirname "$0")/.." && pwd)"
+PAQUETE="${RAIZ}/MarvelSync"
+PRESUPUESTO="${PAQUETE}/Benchmarks/presupuesto-asignaciones.json"
+
+swift build -c release --package-path "${PAQUETE}" --product marvel-allocbench
+BINARIOS="$(swift build -c release --package-path "${PAQUETE}" --show-bin-path)"
+
+if [ "$1" = "--guardar" ]; then
+    shift
+    mkdir -p "$(dirname "${PRESUPUESTO}")"
+    "${BINARIOS}/marvel-allocbench" --guardar-presupuesto "${PRESUPUESTO}" "$@"
+elif [ -f "${PRESUPUESTO}" ]; then
+    "${BINARIOS}/marvel-allocbench" --presupuesto "${PRESUPUESTO}" "$@"
+else
+    echo "warning: no hay presupuesto en ${PRESUPUESTO}, se graba esta ejecucion como presupuesto"
+    mkdir -p "$(dirname "${PRESUPUESTO}")"
+    "${BINARIOS}/marvel-allocbench" --guardar-presupuesto "${PRESUPUESTO}" "$@"
+fi
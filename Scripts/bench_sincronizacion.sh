@@ -0,0 +1,46 @@
+#!/bin/sh
+#
+#  bench_sincronizacion.sh
+#  Heroes Marvel
+#
+#  Sincronizacion completa con hero-sync-bench contra el stub local (marvel-stub), sin red ni
+#  simulador. Funciona en macOS y en Linux con Swift instalado.
+#
+#  Uso:
+#    Scripts/bench_sincronizacion.sh [opciones del stub] [-- opciones del bench]
+#
+#  Ejemplos:
+#    Scripts/bench_sincronizacion.sh --personajes 10000
+#    Scripts/bench_sincronizacion.sh --personajes 10000 --latencia lognormal:80-0.6 --5xx 0.02 -- --repeticiones 3 --json
+#
+
+set -e
+
+RAIZ="$(cd "$(dirname "$0")/.." && pwd)"
+PAQUETE="${RAIZ}/MarvelSync"
+PUERTO="${PUERTO:-8089}"
+
+OPCIONES_STUB=""
+while [ $# -gt 0 ] && [ "$1" != "--" ]; do
+    OPCIONES_STUB="${OPCIONES_STUB} $1"
+    shift
+done
+[ "$1" = "--" ] && shift
+
+swift build -c release --package-path "${PAQUETE}"
+BINARIOS="$(swift build -c release --package-path "${PAQUETE}" --show-bin-path)"
+
+# shellcheck disable=SC2086
+"${BINARIOS}/marvel-stub" --puerto "${PUERTO}" ${OPCIONES_STUB} &
+STUB=$!
+trap 'kill ${STUB} 2>/dev/null' EXIT
+
+# Esperamos a que el stub acepte conexiones
+for _ in 1 2 3 4 5 6 7 8 9 10; do
+    if curl -s -o /dev/null "http://127.0.0.1:${PUERTO}/images/1.png"; then
+        break
+    fi
+    sleep 0.5
+done
+
+"${BINARIOS}/hero-sync-bench" --url "http://127.0.0.1:${PUERTO}" "$@"
@@ -0,0 +1,56 @@
+#!/bin/sh
+#
+#  generar_catalogo_semilla.sh
+#  Heroes Marvel
+#
+#  Genera el catalogo semilla (CatalogoSemilla.sqlite) que se incluye en el bundle para que
+#  el primer arranque no empiece con la lista vacia.
+#
+#  Uso:
+#    Scripts/generar_catalogo_semilla.sh                 Regenera el catalogo desde la API
+#    Scripts/generar_catalogo_semilla.sh --bundle        Fase de compilacion: copia el catalogo al bundle
+#                                                        (en Release lo genera antes si no existe)
+#
+#  Para generar hacen falta las claves de la API en MARVEL_APIKEY y MARVEL_PRIVKEY.
+#
+
+set -e
+
+RAIZ="$(cd "$(dirname "$0")/.." && pwd)"
+SEMILLA="${RAIZ}/Heroes Marvel/ModeloDatos/CatalogoSemilla.sqlite"
+
+generar() {
+    if [ -z "${MARVEL_APIKEY}" ] || [ -z "${MARVEL_PRIVKEY}" ]; then
+        echo "warning: MARVEL_APIKEY/MARVEL_PRIVKEY sin definir, no se genera el catalogo semilla"
+        return 0
+    fi
+
+    TEMPORAL="$(mktemp -d)"
+    trap 'rm -rf "${TEMPORAL}"' EXIT
+
+    # El generador es una herramienta de macOS que reutiliza el modelo y los tipos de la API de la app
+    xcrun momc "${RAIZ}/Heroes Marvel/ModeloDatos/Heroes_Marvel.xcdatamodeld" "${TEMPORAL}/Heroes_Marvel.momd"
+    xcrun --sdk macosx swiftc -O -o "${TEMPORAL}/generar" \
+        "${RAIZ}/Scripts/CatalogoSemilla/main.swift" \
+        "${RAIZ}/MarvelSync/Sources/MarvelSync/CharactersMarvel.swift" \
+        "${RAIZ}/Heroes Marvel/Util/StringExtension.swift"
+
+    rm -f "${TEMPORAL}/CatalogoSemilla.sqlite"
+    "${TEMPORAL}/generar" "${TEMPORAL}/Heroes_Marvel.momd" "${TEMPORAL}/CatalogoSemilla.sqlite"
+
+    # Compactamos el fichero antes de incluirlo en el bundle
+    sqlite3 "${TEMPORAL}/CatalogoSemilla.sqlite" "VACUUM;"
+    mv "${TEMPORAL}/CatalogoSemilla.sqlite" "${SEMILLA}"
+    echo "Catalogo semilla generado en ${SEMILLA}"
+}
+
+if [ "$1" = "--bundle" ]; then
+    if [ ! -f "${SEMILLA}" ] && [ "${CONFIGURATION}" = "Release" ]; then
+        generar
+    fi
+    if [ -f "${SEMILLA}" ]; then
+        cp "${SEMILLA}" "${TARGET_BUILD_DIR}/${UNLOCALIZED_RESOURCES_FOLDER_PATH}/CatalogoSemilla.sqlite"
+    fi
+else
+    generar
+fi
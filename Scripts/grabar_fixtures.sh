@@ -0,0 +1,30 @@
+#!/bin/sh
+#
+#  grabar_fixtures.sh
+#  Heroes Marvel
+#
+#  Vuelve a grabar las paginas de personajes de MarvelSync/Fixtures (25, 100 y 1000 resultados)
+#  desde el stub local con la semilla por defecto. Los benchmarks dependen de que estos ficheros
+#  no cambien, asi que solo hay que regenerarlos a proposito y junto con la linea base.
+#
+
+set -e
+
+RAIZ="$(cd "$(dirname "$0")/.." && pwd)"
+PAQUETE="${RAIZ}/MarvelSync"
+PUERTO="${PUERTO:-8090}"
+
+swift build -c release --package-path "${PAQUETE}" --product marvel-stub
+BINARIOS="$(swift build -c release --package-path "${PAQUETE}" --show-bin-path)"
+
+"${BINARIOS}/marvel-stub" --puerto "${PUERTO}" --personajes 1000 --semilla 1 --limite-maximo 1000 \
+    --url-publica "http://127.0.0.1:8080" &
+STUB=$!
+trap 'kill ${STUB} 2>/dev/null' EXIT
+sleep 1
+
+for TAMANO in 25 100 1000; do
+    curl -sf -o "${PAQUETE}/Fixtures/personajes-${TAMANO}.json" \
+        "http://127.0.0.1:${PUERTO}/v1/public/characters?ts=1&apikey=fixture&hash=fixture&limit=${TAMANO}&offset=0&orderBy=modified"
+    echo "personajes-${TAMANO}.json"
+done
@@ -0,0 +1,35 @@
+#!/bin/sh
+#
+#  microbench.sh
+#  Heroes Marvel
+#
+#  Ejecuta marvel-microbench en release y lo compara con la linea base guardada
+#  (MarvelSync/Benchmarks/baseline.json). Sale con error si algun benchmark empeora mas de la
+#  tolerancia. Con --guardar se graba una nueva linea base: hay que hacerlo siempre en la
+#  misma maquina de referencia, los numeros de maquinas distintas no son comparables. La linea
+#  base del repositorio lleva "plataforma": "sin medir" hasta que se graba la primera vez.
+#
+#  Uso:
+#    Scripts/microbench.sh [--guardar] [--tolerancia 0.10] [--filtro decodificacion]
+#
+
+set -e
+
+RAIZ="$(cd "$(dirname "$0")/.." && pwd)"
+PAQUETE="${RAIZ}/MarvelSync"
+BASELINE="${PAQUETE}/Benchmarks/baseline.json"
+
+swift build -c release --package-path "${PAQUETE}" --product marvel-microbench
+BINARIOS="$(swift build -c release --package-path "${PAQUETE}" --show-bin-path)"
+
+if [ "$1" = "--guardar" ]; then
+    shift
+    mkdir -p "$(dirname "${BASELINE}")"
+    "${BINARIOS}/marvel-microbench" --guardar-baseline "${BASELINE}" "$@"
+elif [ -f "${BASELINE}" ] && ! grep -q '"plataforma" : "sin medir"' "${BASELINE}"; then
+    "${BINARIOS}/marvel-microbench" --baseline "${BASELINE}" "$@"
+else
+    echo "warning: no hay linea base medida en ${BASELINE}, se graba esta ejecucion como linea base"
+    mkdir -p "$(dirname "${BASELINE}")"
+    "${BINARIOS}/marvel-microbench" --guardar-baseline "${BASELINE}" "$@"
+fi